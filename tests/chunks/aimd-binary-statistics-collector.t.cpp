@@ -0,0 +1,158 @@
+/**
+ * Copyright (c) 2016,  Arizona Board of Regents.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ *
+ * @author Teng Liang
+ */
+
+
+#include "tools/chunks/catchunks/aimd-binary-statistics-collector.hpp"
+
+#include "tests/test-common.hpp"
+#include <ndn-cxx/util/dummy-client-face.hpp>
+
+namespace ndn {
+namespace chunks {
+namespace aimd {
+namespace tests {
+
+class BinaryStatisticsCollectorFixture
+{
+protected:
+  BinaryStatisticsCollectorFixture()
+    : face(io)
+    , pipeline(face, rttEstimator, rateEstimator)
+  {
+  }
+
+  unique_ptr<BinaryStatisticsCollector>
+  makeCollector(const BinaryStatisticsCollector::Options& options = BinaryStatisticsCollector::Options())
+  {
+    return make_unique<BinaryStatisticsCollector>(pipeline, rttEstimator, rateEstimator, log,
+                                                  options);
+  }
+
+  uint64_t
+  convert()
+  {
+    std::istringstream is(log.str());
+    return BinaryStatisticsCollector::convertToTsv(is, tsvCwnd, tsvRtt, tsvRate);
+  }
+
+protected:
+  boost::asio::io_service io;
+  util::DummyClientFace face;
+  RttEstimator rttEstimator;
+  RateEstimator rateEstimator;
+  PipelineInterestsAimd pipeline;
+  std::ostringstream log;
+  std::ostringstream tsvCwnd;
+  std::ostringstream tsvRtt;
+  std::ostringstream tsvRate;
+};
+
+BOOST_AUTO_TEST_SUITE(Chunks)
+BOOST_FIXTURE_TEST_SUITE(TestAimdBinaryStatisticsCollector, BinaryStatisticsCollectorFixture)
+
+BOOST_AUTO_TEST_CASE(Ring)
+{
+  StatisticsRing ring(3);
+  BOOST_REQUIRE_EQUAL(ring.getCapacity(), 4);
+
+  std::vector<double> drained;
+  auto write = [&drained] (const StatisticsRecord* records, size_t nRecords) {
+    for (size_t i = 0; i < nRecords; ++i)
+      drained.push_back(records[i].time);
+  };
+
+  StatisticsRecord rec{};
+  for (int i = 0; i < 4; ++i) {
+    rec.time = i;
+    BOOST_CHECK(ring.push(rec));
+  }
+  rec.time = 4;
+  BOOST_CHECK(!ring.push(rec)); // full
+
+  BOOST_CHECK_EQUAL(ring.drain(write), 4);
+  BOOST_CHECK_EQUAL(ring.drain(write), 0);
+
+  // wrap around the end of the ring
+  for (int i = 4; i < 7; ++i) {
+    rec.time = i;
+    BOOST_CHECK(ring.push(rec));
+  }
+  BOOST_CHECK_EQUAL(ring.drain(write), 3);
+
+  std::vector<double> expected{0, 1, 2, 3, 4, 5, 6};
+  BOOST_CHECK_EQUAL_COLLECTIONS(drained.begin(), drained.end(), expected.begin(), expected.end());
+}
+
+BOOST_AUTO_TEST_CASE(ConvertToTsv)
+{
+  {
+    auto collector = makeCollector();
+    collector->onCwndChange(Milliseconds(1500), 4.0);
+    rttEstimator.addMeasurement(7, 2.0, Milliseconds(100), 1);
+    rateEstimator.addMeasurement(2.5, 10, 80000);
+    BOOST_CHECK_EQUAL(collector->getNDroppedRecords(), 0);
+  } // the destructor writes the remaining records
+
+  BOOST_CHECK_EQUAL(convert(), 3);
+
+  BOOST_CHECK_EQUAL(tsvCwnd.str(), "time\tcwndsize\n"
+                                   "1.5\t4\n");
+  BOOST_CHECK_EQUAL(tsvRtt.str().substr(0, tsvRtt.str().find('\n')),
+                    "segment\ttime\trtt\trttvar\tsrtt\trto\tminrtt\tp50\tp90\tp99");
+  BOOST_CHECK(tsvRtt.str().find("\n7\t2\t100\t") != std::string::npos);
+  BOOST_CHECK_EQUAL(tsvRate.str(), "time\tpps\tkbps\tdrate\tmaxdrate\n"
+                                   "2.5\t100\t800\tnan\tnan\n");
+}
+
+BOOST_AUTO_TEST_CASE(Downsample)
+{
+  BinaryStatisticsCollector::Options options;
+  options.downsampleInterval = 1.0;
+  {
+    auto collector = makeCollector(options);
+    collector->onCwndChange(Milliseconds(0), 1.0);
+    collector->onCwndChange(Milliseconds(500), 2.0);
+    collector->onCwndChange(Milliseconds(1200), 3.0);
+    collector->onCwndChange(Milliseconds(1300), 4.0);
+    collector->onCwndChange(Milliseconds(2200), 5.0);
+  }
+
+  BOOST_CHECK_EQUAL(convert(), 3);
+  BOOST_CHECK_EQUAL(tsvCwnd.str(), "time\tcwndsize\n"
+                                   "0\t1\n"
+                                   "1.2\t3\n"
+                                   "2.2\t5\n");
+}
+
+BOOST_AUTO_TEST_CASE(InvalidLog)
+{
+  log << "not a statistics log";
+  BOOST_CHECK_THROW(convert(), BinaryStatisticsCollector::Error);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestAimdBinaryStatisticsCollector
+BOOST_AUTO_TEST_SUITE_END() // Chunks
+
+} // namespace tests
+} // namespace aimd
+} // namespace chunks
+} // namespace ndn
@@ -0,0 +1,120 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "tools/chunks/catchunks/aimd-rate-estimator.hpp"
+
+#include "tests/test-common.hpp"
+
+namespace ndn {
+namespace chunks {
+namespace aimd {
+namespace tests {
+
+class RateEstimatorFixture
+{
+protected:
+  RateEstimatorFixture()
+    : options(makeRateEstimatorOptions())
+    , rateEstimator(options)
+  {
+  }
+
+private:
+  static RateEstimator::Options
+  makeRateEstimatorOptions()
+  {
+    RateEstimator::Options rateOptions;
+    rateOptions.rateInterval = 0.1;
+    rateOptions.alpha = 0.125;
+    rateOptions.maxFilterRtts = 10;
+    return rateOptions;
+  }
+
+protected:
+  RateEstimator::Options options;
+  RateEstimator rateEstimator;
+};
+
+BOOST_AUTO_TEST_SUITE(Chunks)
+BOOST_FIXTURE_TEST_SUITE(TestAimdRateEstimator, RateEstimatorFixture)
+
+BOOST_AUTO_TEST_CASE(MeasureRate)
+{
+  std::vector<RateSample> samples;
+  rateEstimator.afterRateMeasurement.connect([&samples] (const RateSample& sample) {
+    samples.push_back(sample);
+  });
+
+  rateEstimator.addMeasurement(1.0, 10, 80000);
+
+  BOOST_REQUIRE_EQUAL(samples.size(), 1);
+  BOOST_CHECK_CLOSE(samples[0].now, 1.0, 0.1);
+  BOOST_CHECK_CLOSE(samples[0].pps, 100, 0.1);
+  BOOST_CHECK_CLOSE(samples[0].kbps, 800, 0.1);
+  BOOST_CHECK(std::isnan(samples[0].deliveryRate)); // no segment delivered yet
+  BOOST_CHECK(std::isnan(samples[0].maxDeliveryRate));
+}
+
+BOOST_AUTO_TEST_CASE(DeliveryRate)
+{
+  BOOST_REQUIRE(std::isnan(rateEstimator.getDeliveryRate()));
+  BOOST_REQUIRE(std::isnan(rateEstimator.getMaxDeliveryRate()));
+
+  // four Interests sent back to back, Data received 100ms later
+  std::vector<DeliveryState> states;
+  for (int i = 0; i < 4; ++i) {
+    states.push_back(rateEstimator.onInterestSent(0.0));
+  }
+  for (const auto& state : states) {
+    BOOST_CHECK_EQUAL(state.nDelivered, 0);
+    BOOST_CHECK_CLOSE(state.deliveredTime, 0.0, 0.1);
+    rateEstimator.addDeliverySample(0.1, state, Milliseconds(100));
+  }
+
+  // samples are 10, 20, 30 and 40 segments/s
+  BOOST_CHECK_EQUAL(rateEstimator.m_nDelivered, 4);
+  BOOST_CHECK_CLOSE(rateEstimator.getMaxDeliveryRate(), 40, 0.1);
+  BOOST_CHECK_CLOSE(rateEstimator.getDeliveryRate(), 16.8945, 0.1);
+  BOOST_CHECK_CLOSE(rateEstimator.getBdp(Milliseconds(100)), 4, 0.1);
+
+  DeliveryState state = rateEstimator.onInterestSent(0.1);
+  BOOST_CHECK_EQUAL(state.nDelivered, 4);
+  BOOST_CHECK_CLOSE(state.deliveredTime, 0.1, 0.1);
+
+  // the maximum stays within the window of 10 RTTs
+  rateEstimator.addDeliverySample(0.3, state, Milliseconds(100));
+  BOOST_CHECK_CLOSE(rateEstimator.getMaxDeliveryRate(), 40, 0.1);
+
+  // and expires after it
+  state = {rateEstimator.m_nDelivered, 1.9};
+  rateEstimator.addDeliverySample(2.0, state, Milliseconds(100));
+  BOOST_CHECK_CLOSE(rateEstimator.getMaxDeliveryRate(), 10, 0.1);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestAimdRateEstimator
+BOOST_AUTO_TEST_SUITE_END() // Chunks
+
+} // namespace tests
+} // namespace aimd
+} // namespace chunks
+} // namespace ndn
@@ -69,7 +69,7 @@ BOOST_AUTO_TEST_CASE(MeasureRtt)
   BOOST_REQUIRE_CLOSE(rttEstimator.m_rto.count(), options.initialRto.count(), 1);
 
   // first measurement
-  rttEstimator.addMeasurement(1, Milliseconds(100), 1);
+  rttEstimator.addMeasurement(1, 0.1, Milliseconds(100), 1);
 
   BOOST_CHECK_CLOSE(rttEstimator.m_sRtt.count(), 100, 1);
   BOOST_CHECK_CLOSE(rttEstimator.m_rttVar.count(), 50, 1);
@@ -80,7 +80,7 @@ BOOST_AUTO_TEST_CASE(MeasureRtt)
   rttEstimator.m_rto = Milliseconds(900.0);
 
   size_t nExpectedSamples = 1;
-  rttEstimator.addMeasurement(1, Milliseconds(100), nExpectedSamples);
+  rttEstimator.addMeasurement(1, 0.1, Milliseconds(100), nExpectedSamples);
 
   BOOST_CHECK_CLOSE(rttEstimator.m_sRtt.count(), 450, 1);
   BOOST_CHECK_CLOSE(rttEstimator.m_rttVar.count(), 175, 1);
@@ -88,7 +88,7 @@ BOOST_AUTO_TEST_CASE(MeasureRtt)
 
   // expected Samples larger than 1
   nExpectedSamples = 5;
-  rttEstimator.addMeasurement(1, Milliseconds(100), nExpectedSamples);
+  rttEstimator.addMeasurement(1, 0.1, Milliseconds(100), nExpectedSamples);
 
   BOOST_CHECK_CLOSE(rttEstimator.m_sRtt.count(), 441.25, 1);
   BOOST_CHECK_CLOSE(rttEstimator.m_rttVar.count(), 183.75, 1);
@@ -100,7 +100,7 @@ BOOST_AUTO_TEST_CASE(MeasureRtt)
 
   // check if minRto works
   nExpectedSamples = 1;
-  rttEstimator.addMeasurement(1, Milliseconds(100), nExpectedSamples);
+  rttEstimator.addMeasurement(1, 0.1, Milliseconds(100), nExpectedSamples);
 
   BOOST_CHECK_CLOSE(rttEstimator.m_sRtt.count(), 100, 1);
   BOOST_CHECK_CLOSE(rttEstimator.m_rttVar.count(), 22.5, 1);
@@ -112,13 +112,56 @@ BOOST_AUTO_TEST_CASE(MeasureRtt)
 
   // check if maxRto works
   nExpectedSamples = 1;
-  rttEstimator.addMeasurement(1, Milliseconds(100), nExpectedSamples);
+  rttEstimator.addMeasurement(1, 0.1, Milliseconds(100), nExpectedSamples);
 
   BOOST_CHECK_CLOSE(rttEstimator.m_sRtt.count(), 1762.5, 0.1);
   BOOST_CHECK_CLOSE(rttEstimator.m_rttVar.count(), 775, 0.1);
   BOOST_CHECK_CLOSE(rttEstimator.m_rto.count(), 4000, 0.1);
 }
 
+BOOST_AUTO_TEST_CASE(MinRtt)
+{
+  BOOST_REQUIRE(std::isnan(rttEstimator.getMinRtt().count()));
+
+  rttEstimator.addMeasurement(1, 0.0, Milliseconds(100), 1);
+  BOOST_CHECK_CLOSE(rttEstimator.getMinRtt().count(), 100, 0.1);
+
+  rttEstimator.addMeasurement(2, 1.0, Milliseconds(50), 1);
+  rttEstimator.addMeasurement(3, 5.0, Milliseconds(80), 1);
+  BOOST_CHECK_CLOSE(rttEstimator.getMinRtt().count(), 50, 0.1);
+
+  // the 50ms sample leaves the 10s window, e.g. after a route change
+  rttEstimator.addMeasurement(4, 12.0, Milliseconds(90), 1);
+  BOOST_CHECK_CLOSE(rttEstimator.getMinRtt().count(), 80, 0.1);
+
+  rttEstimator.addMeasurement(5, 16.0, Milliseconds(95), 1);
+  BOOST_CHECK_CLOSE(rttEstimator.getMinRtt().count(), 90, 0.1);
+}
+
+BOOST_AUTO_TEST_CASE(RttPercentiles)
+{
+  BOOST_REQUIRE(std::isnan(rttEstimator.getRttP50().count()));
+
+  std::vector<RttRtoSample> samples;
+  rttEstimator.afterRttMeasurement.connect([&samples] (const RttRtoSample& sample) {
+    samples.push_back(sample);
+  });
+
+  // RTT samples of 1..1000 ms in scrambled order
+  for (uint64_t i = 0; i < 1000; ++i) {
+    rttEstimator.addMeasurement(i, i * 0.001, Milliseconds((i * 7919) % 1000 + 1), 1);
+  }
+
+  BOOST_CHECK_CLOSE(rttEstimator.getRttP50().count(), 500, 5);
+  BOOST_CHECK_CLOSE(rttEstimator.getRttP90().count(), 900, 5);
+  BOOST_CHECK_CLOSE(rttEstimator.getRttP99().count(), 990, 5);
+
+  BOOST_REQUIRE_EQUAL(samples.size(), 1000);
+  BOOST_CHECK_CLOSE(samples.back().minRtt.count(), 1, 0.1);
+  BOOST_CHECK_CLOSE(samples.back().rttP50.count(), rttEstimator.getRttP50().count(), 0.1);
+  BOOST_CHECK_CLOSE(samples.back().rttP99.count(), rttEstimator.getRttP99().count(), 0.1);
+}
+
 BOOST_AUTO_TEST_CASE(RtoBackoff)
 {
   rttEstimator.m_rto = Milliseconds(500.0);
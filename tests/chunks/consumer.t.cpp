@@ -26,6 +26,7 @@
 #include "tools/chunks/catchunks/consumer.hpp"
 #include "tools/chunks/catchunks/discover-version.hpp"
 #include "tools/chunks/catchunks/pipeline-interests.hpp"
+#include "tools/chunks/catchunks/segment-tracer.hpp"
 
 #include "tests/test-common.hpp"
 #include <ndn-cxx/util/dummy-client-face.hpp>
@@ -33,6 +34,9 @@
 
 #include <boost/test/output_test_stream.hpp>
 
+#include <fcntl.h>
+#include <unistd.h>
+
 namespace ndn {
 namespace chunks {
 namespace tests {
@@ -78,7 +82,7 @@ BOOST_AUTO_TEST_CASE(OutputDataSequential)
     data->setContent(reinterpret_cast<const uint8_t*>(testStrings[i].data()),
                      testStrings[i].size());
 
-    cons.m_bufferedData[i] = data;
+    cons.bufferData(data);
     cons.writeInOrderData();
 
     BOOST_CHECK(output.is_equal(testStrings[i]));
@@ -121,19 +125,68 @@ BOOST_AUTO_TEST_CASE(OutputDataUnordered)
   }
 
   output.flush();
-  cons.m_bufferedData[1] = dataStore[1];
+  cons.bufferData(dataStore[1]);
   cons.writeInOrderData();
   BOOST_CHECK(output.is_equal(""));
 
   output.flush();
-  cons.m_bufferedData[0] = dataStore[0];
+  cons.bufferData(dataStore[0]);
   cons.writeInOrderData();
   BOOST_CHECK(output.is_equal(testStrings[0] + testStrings[1]));
 
   output.flush();
-  cons.m_bufferedData[2] = dataStore[2];
+  cons.bufferData(dataStore[2]);
   cons.writeInOrderData();
   BOOST_CHECK(output.is_equal(testStrings[2]));
+
+  BOOST_CHECK_EQUAL(cons.getMaxBufferedSegments(), 2);
+  BOOST_CHECK_EQUAL(cons.getMaxBufferedBytes(),
+                    std::max(testStrings[0].size() + testStrings[1].size(), testStrings[2].size()));
+  BOOST_CHECK_EQUAL(cons.getNBufferedBytes(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(MemoryLimits)
+{
+  util::DummyClientFace face;
+  ValidatorNull validator;
+  output_test_stream output("");
+  Consumer cons(validator, false, output);
+
+  Consumer::MemoryLimits limits;
+  limits.maxBufferedBytes = 250;
+  cons.setMemoryLimits(limits);
+
+  std::string content(100, 'a');
+  for (uint64_t i = 1; i <= 3; ++i) {
+    auto data = makeData(Name("/ndn/chunks/test").appendVersion(1).appendSegment(i));
+    data->setContent(reinterpret_cast<const uint8_t*>(content.data()), content.size());
+    if (i < 3)
+      cons.bufferData(data);
+    else // segment 0 is missing, so the third segment exceeds the limit
+      BOOST_CHECK_THROW(cons.bufferData(data), std::runtime_error);
+  }
+  BOOST_CHECK_EQUAL(cons.getMaxBufferedBytes(), 300);
+}
+
+BOOST_AUTO_TEST_CASE(Digest)
+{
+  util::DummyClientFace face;
+  ValidatorNull validator;
+  output_test_stream output("");
+  Consumer cons(validator, false, output);
+  cons.enableDigest();
+
+  std::vector<std::string> contents{"a", "bc"};
+  for (uint64_t i : {1, 0}) {
+    auto data = makeData(Name("/ndn/chunks/test").appendVersion(1).appendSegment(i));
+    data->setContent(reinterpret_cast<const uint8_t*>(contents[i].data()), contents[i].size());
+    cons.bufferData(data);
+    cons.writeInOrderData();
+  }
+
+  BOOST_CHECK(output.is_equal("abc"));
+  BOOST_CHECK_EQUAL(cons.getDigest(),
+                    "BA7816BF8F01CFEA414140DE5DAE2223B00361A396177A9CB410FF61F20015AD");
 }
 
 class DiscoverVersionDummy : public DiscoverVersion
@@ -162,6 +215,13 @@ private:
     this->emitSignal(onDiscoverySuccess, data);
   }
 
+public:
+  void
+  reportNewerVersion(const Data& data)
+  {
+    this->emitSignal(onNewerVersion, data);
+  }
+
 public:
   bool isDiscoverRunning;
 
@@ -191,6 +251,8 @@ private:
   }
 
 public:
+  using PipelineInterests::getMissingSegmentNo;
+
   bool isPipelineRunning;
 };
 
@@ -220,6 +282,196 @@ BOOST_FIXTURE_TEST_CASE(RunBasic, UnitTestTimeFixture)
   BOOST_CHECK_EQUAL(pipelinePtr->isPipelineRunning, true);
 }
 
+BOOST_FIXTURE_TEST_CASE(NewerVersionAbortsRetrieval, UnitTestTimeFixture)
+{
+  boost::asio::io_service io;
+  util::DummyClientFace face(io);
+  ValidatorNull validator;
+  output_test_stream output("");
+  Consumer consumer(validator, false, output);
+
+  Name prefix("/ndn/chunks/test");
+  auto discover = make_unique<DiscoverVersionDummy>(prefix, face, Options());
+  auto pipeline = make_unique<PipelineInterestsDummy>(face);
+  auto discoverPtr = discover.get();
+  auto pipelinePtr = pipeline.get();
+
+  consumer.run(std::move(discover), std::move(pipeline));
+  this->advanceClocks(io, time::nanoseconds(1));
+
+  face.receive(*makeData(Name(prefix).appendVersion(1).appendSegment(0)));
+  this->advanceClocks(io, time::nanoseconds(1));
+  BOOST_REQUIRE_EQUAL(pipelinePtr->isPipelineRunning, true);
+
+  auto newerData = makeData(Name(prefix).appendVersion(2).appendSegment(0));
+  BOOST_CHECK_THROW(discoverPtr->reportNewerVersion(*newerData), std::runtime_error);
+}
+
+BOOST_FIXTURE_TEST_CASE(Backpressure, UnitTestTimeFixture)
+{
+  boost::asio::io_service io;
+  util::DummyClientFace face(io);
+  ValidatorNull validator;
+  output_test_stream output("");
+  Consumer consumer(validator, false, output);
+  consumer.setBackpressureThreshold(200);
+
+  Name prefix("/ndn/chunks/test");
+  auto pipeline = make_unique<PipelineInterestsDummy>(face);
+  auto pipelinePtr = pipeline.get();
+  consumer.run(make_unique<DiscoverVersionDummy>(prefix, face, Options()), std::move(pipeline));
+
+  std::string content(100, 'a');
+  auto receive = [&] (uint64_t segNo) {
+    auto data = makeData(Name(prefix).appendVersion(1).appendSegment(segNo));
+    data->setContent(reinterpret_cast<const uint8_t*>(content.data()), content.size());
+    consumer.bufferData(data);
+    consumer.writeInOrderData();
+    consumer.updateBackpressure();
+  };
+
+  receive(1);
+  BOOST_CHECK_EQUAL(pipelinePtr->hasBackpressure(), false);
+
+  receive(2);
+  BOOST_CHECK_EQUAL(pipelinePtr->hasBackpressure(), true);
+  BOOST_CHECK_EQUAL(pipelinePtr->getMissingSegmentNo(), 0);
+
+  receive(0);
+  BOOST_CHECK_EQUAL(pipelinePtr->hasBackpressure(), false);
+  BOOST_CHECK_EQUAL(consumer.getNWrittenBytes(), 300);
+}
+
+/**
+ * @brief clock that stays at a given time
+ */
+class FixedClock : public PipelineClock
+{
+public:
+  TimePoint
+  now() const final
+  {
+    return time;
+  }
+
+public:
+  TimePoint time;
+};
+
+BOOST_AUTO_TEST_CASE(OutputWriterTracing)
+{
+  boost::asio::io_service io;
+  util::DummyClientFace face(io);
+  ValidatorNull validator;
+  output_test_stream output("");
+  std::ostringstream os;
+  OutputWriter writer(os, io);
+  FixedClock clock;
+  clock.time = time::steady_clock::now() + time::hours(1);
+  SegmentTracer tracer(100, clock);
+  Consumer consumer(validator, false, output);
+  consumer.setOutputWriter(&writer);
+  consumer.setClock(clock);
+  consumer.setTracer(&tracer);
+  clock.time += time::milliseconds(5);
+
+  std::string content(100, 'a');
+  for (uint64_t segNo = 0; segNo < 3; ++segNo) {
+    auto data = makeData(Name("/ndn/chunks/test").appendVersion(1).appendSegment(segNo));
+    data->setContent(reinterpret_cast<const uint8_t*>(content.data()), content.size());
+    consumer.bufferData(data);
+  }
+  consumer.writeInOrderData();
+
+  // the segments are counted and traced as written by the writer thread
+  consumer.flushOutput();
+  BOOST_CHECK_EQUAL(os.str(), content + content + content);
+  BOOST_CHECK_EQUAL(consumer.getNWrittenBytes(), 300);
+  BOOST_CHECK_EQUAL(tracer.getNEvents(), 3);
+
+  // the writer thread reads the clock of the consumer
+  std::ostringstream dump;
+  tracer.dump(dump);
+  BOOST_CHECK_EQUAL(dump.str(),
+                    "segment\tsent\treceived\tvalidated\twritten\tnretx\tretx\n"
+                    "0\t-\t-\t-\t5000\t0\t-\n"
+                    "1\t-\t-\t-\t5000\t0\t-\n"
+                    "2\t-\t-\t-\t5000\t0\t-\n");
+}
+
+BOOST_AUTO_TEST_CASE(OutputWriterFailure)
+{
+  // writing to a descriptor opened for reading fails
+  int fd = ::open("/dev/null", O_RDONLY);
+  BOOST_REQUIRE_GE(fd, 0);
+
+  boost::asio::io_service io;
+  ValidatorNull validator;
+  output_test_stream output("");
+  OutputWriter writer(fd, io);
+  Consumer consumer(validator, false, output);
+  consumer.setOutputWriter(&writer);
+
+  std::string content(100, 'a');
+  auto data = makeData(Name("/ndn/chunks/test").appendVersion(1).appendSegment(0));
+  data->setContent(reinterpret_cast<const uint8_t*>(content.data()), content.size());
+  consumer.bufferData(data);
+  consumer.writeInOrderData();
+
+  // the failure is raised on the io_service, without waiting for flushOutput
+  bool hasFailed = false;
+  for (int i = 0; i < 1000 && !hasFailed; ++i) {
+    try {
+      io.reset();
+      io.poll();
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    catch (const OutputWriter::Error&) {
+      hasFailed = true;
+    }
+  }
+  BOOST_CHECK_EQUAL(hasFailed, true);
+  BOOST_CHECK_THROW(consumer.flushOutput(), OutputWriter::Error);
+
+  ::close(fd);
+}
+
+BOOST_FIXTURE_TEST_CASE(ByteRange, UnitTestTimeFixture)
+{
+  boost::asio::io_service io;
+  util::DummyClientFace face(io);
+  ValidatorNull validator;
+  output_test_stream output("");
+  Consumer consumer(validator, false, output);
+  consumer.setByteRange(150, 420);
+
+  // 10 segments of 100 bytes, segment i is filled with the letter 'a' + i
+  Name prefix("/ndn/chunks/test");
+  auto makeSegment = [&] (uint64_t segNo) {
+    auto data = makeData(Name(prefix).appendVersion(1).appendSegment(segNo));
+    std::string content(100, 'a' + segNo);
+    data->setContent(reinterpret_cast<const uint8_t*>(content.data()), content.size());
+    data->setFinalBlockId(name::Component::fromSegment(9));
+    return data;
+  };
+
+  consumer.run(make_unique<DiscoverVersionDummy>(prefix, face, Options()),
+               make_unique<PipelineInterestsDummy>(face));
+  this->advanceClocks(io, time::nanoseconds(1));
+  face.receive(*makeSegment(0));
+  this->advanceClocks(io, time::nanoseconds(1));
+  BOOST_CHECK_EQUAL(consumer.getNBufferedBytes(), 0); // segment 0 is outside the range
+
+  for (uint64_t i = 5; i >= 1; --i) {
+    consumer.bufferData(makeSegment(i));
+    consumer.writeInOrderData();
+  }
+
+  BOOST_CHECK(output.is_equal(std::string(50, 'b') + std::string(100, 'c') +
+                              std::string(100, 'd') + std::string(21, 'e')));
+  BOOST_CHECK_EQUAL(consumer.isComplete(), true);
+}
+
 BOOST_AUTO_TEST_SUITE_END() // TestConsumer
 BOOST_AUTO_TEST_SUITE_END() // Chunks
 
@@ -0,0 +1,132 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "tools/chunks/catchunks/discover-version-cached.hpp"
+
+#include "discover-version-fixture.hpp"
+
+#include <boost/filesystem.hpp>
+
+namespace ndn {
+namespace chunks {
+namespace tests {
+
+class DiscoverVersionCachedFixture : public DiscoverVersionFixture
+{
+public:
+  DiscoverVersionCachedFixture()
+    : chunks::Options(makeOptions())
+    , DiscoverVersionFixture(makeOptions())
+    , tmpPath(makeTmpPath())
+    , cachePath((tmpPath / "version-cache").string())
+    , cache(cachePath, time::seconds(60))
+  {
+    DiscoverVersionIterative::Options options(makeOptions());
+    options.maxRetriesAfterVersionFound = 1;
+    setDiscover(make_unique<DiscoverVersionCached>(name, face, options, cache));
+  }
+
+  ~DiscoverVersionCachedFixture()
+  {
+    boost::filesystem::remove_all(tmpPath);
+  }
+
+private:
+  static boost::filesystem::path
+  makeTmpPath()
+  {
+    boost::filesystem::path tmpPath(boost::filesystem::path(TMP_TESTS_PATH) / "DiscoverVersionCached");
+    boost::filesystem::remove_all(tmpPath);
+    boost::filesystem::create_directories(tmpPath);
+    return tmpPath;
+  }
+
+protected:
+  const boost::filesystem::path tmpPath;
+  const std::string cachePath;
+  VersionCache cache;
+};
+
+BOOST_AUTO_TEST_SUITE(Chunks)
+BOOST_FIXTURE_TEST_SUITE(TestDiscoverVersionCached, DiscoverVersionCachedFixture)
+
+BOOST_AUTO_TEST_CASE(CachedVersionAvailable)
+{
+  uint64_t version = 1449227841747;
+  cache.insert(name, version);
+
+  discover->run();
+  advanceClocks(io, time::nanoseconds(1), 1);
+
+  // the cached version is requested directly
+  BOOST_REQUIRE_EQUAL(face.sentInterests.size(), 1);
+  auto lastInterest = face.sentInterests.back();
+  BOOST_CHECK_EQUAL(lastInterest.getName(), Name(name).appendVersion(version));
+  BOOST_CHECK_EQUAL(lastInterest.getMaxSuffixComponents(), 2);
+
+  face.receive(*makeDataWithVersion(version));
+  advanceClocks(io, time::nanoseconds(1), 1);
+
+  BOOST_CHECK_EQUAL(isDiscoveryFinished, true);
+  BOOST_CHECK_EQUAL(discoveredVersion, version);
+  BOOST_CHECK_EQUAL(face.sentInterests.size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(FallbackToIterative)
+{
+  cache.insert(name, 1);
+
+  discover->run();
+  advanceClocks(io, time::nanoseconds(1), 1);
+  BOOST_REQUIRE_EQUAL(face.sentInterests.size(), 1);
+
+  // the cached version is not available anymore, and is not retransmitted
+  advanceClocks(io, interestLifetime, 1);
+  BOOST_CHECK_EQUAL(isDiscoveryFinished, false);
+
+  BOOST_REQUIRE_EQUAL(face.sentInterests.size(), 2);
+  auto lastInterest = face.sentInterests.back();
+  BOOST_CHECK_EQUAL(lastInterest.getName(), name);
+  BOOST_CHECK_EQUAL(lastInterest.getChildSelector(), 1);
+
+  face.receive(*makeDataWithVersion(2));
+  advanceClocks(io, time::nanoseconds(1), 1);
+  advanceClocks(io, interestLifetime, 2);
+
+  BOOST_CHECK_EQUAL(isDiscoveryFinished, true);
+  BOOST_CHECK_EQUAL(discoveredVersion, 2);
+
+  // the discovered version replaces the cached one, also on disk
+  VersionCache loaded(cachePath, time::seconds(60));
+  loaded.load();
+  uint64_t version = 0;
+  BOOST_CHECK_EQUAL(loaded.find(name, version), true);
+  BOOST_CHECK_EQUAL(version, 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestDiscoverVersionCached
+BOOST_AUTO_TEST_SUITE_END() // Chunks
+
+} // namespace tests
+} // namespace chunks
+} // namespace ndn
@@ -59,6 +59,33 @@ protected:
   }
 };
 
+class DiscoverVersionSpeculativeFixture : public DiscoverVersionIterativeFixture
+{
+public:
+  DiscoverVersionSpeculativeFixture()
+    : chunks::Options(makeOptionsSpeculative())
+    , DiscoverVersionIterativeFixture(makeOptionsSpeculative())
+    , nNewerVersions(0)
+    , nFailures(0)
+  {
+    discover->onNewerVersion.connect([this] (const Data&) { ++nNewerVersions; });
+    discover->onDiscoveryFailure.connect([this] (const std::string&) { ++nFailures; });
+  }
+
+protected:
+  static Options
+  makeOptionsSpeculative()
+  {
+    Options options = makeOptionsIterative();
+    options.isSpeculative = true;
+    return options;
+  }
+
+protected:
+  int nNewerVersions;
+  int nFailures;
+};
+
 
 BOOST_AUTO_TEST_SUITE(Chunks)
 BOOST_AUTO_TEST_SUITE(TestDiscoverVersionIterative)
@@ -225,6 +252,73 @@ BOOST_FIXTURE_TEST_CASE(MultipleVersionsAvailableDescendent, DiscoverVersionIter
   BOOST_CHECK_EQUAL(face.sentInterests.size(), maxRetriesAfterVersionFound + 2);
 }
 
+BOOST_FIXTURE_TEST_CASE(Speculative, DiscoverVersionSpeculativeFixture)
+{
+  discover->run();
+  advanceClocks(io, time::nanoseconds(1), 1);
+  BOOST_REQUIRE_EQUAL(face.sentInterests.size(), 1);
+
+  // the first version found is reported right away...
+  face.receive(*makeDataWithVersion(1));
+  advanceClocks(io, time::nanoseconds(1), 1);
+  BOOST_CHECK_EQUAL(isDiscoveryFinished, true);
+  BOOST_CHECK_EQUAL(discoveredVersion, 1);
+  BOOST_CHECK_EQUAL(nNewerVersions, 0);
+
+  // ...while the discovery continues
+  BOOST_REQUIRE_EQUAL(face.sentInterests.size(), 2);
+  face.receive(*makeDataWithVersion(2));
+  advanceClocks(io, time::nanoseconds(1), 1);
+  BOOST_CHECK_EQUAL(nNewerVersions, 1);
+  BOOST_CHECK_EQUAL(discoveredVersion, 1);
+  BOOST_REQUIRE_EQUAL(face.sentInterests.size(), 3);
+
+  // the confirmation is not reported
+  isDiscoveryFinished = false;
+  advanceClocks(io, interestLifetime, maxRetriesAfterVersionFound + 1);
+  BOOST_CHECK_EQUAL(isDiscoveryFinished, false);
+  BOOST_CHECK_EQUAL(face.sentInterests.size(), maxRetriesAfterVersionFound + 3);
+}
+
+BOOST_FIXTURE_TEST_CASE(SpeculativeNack, DiscoverVersionSpeculativeFixture)
+{
+  discover->run();
+  advanceClocks(io, time::nanoseconds(1), 1);
+
+  face.receive(*makeDataWithVersion(1));
+  advanceClocks(io, time::nanoseconds(1), 1);
+  BOOST_CHECK_EQUAL(discoveredVersion, 1);
+  BOOST_REQUIRE_EQUAL(face.sentInterests.size(), 2);
+
+  // a Nack ends the confirmation without failing the version being retrieved
+  isDiscoveryFinished = false;
+  face.receive(makeNack(face.sentInterests.back(), lp::NackReason::NO_ROUTE));
+  advanceClocks(io, time::nanoseconds(1), 1);
+  BOOST_CHECK_EQUAL(isDiscoveryFinished, false);
+  BOOST_CHECK_EQUAL(nFailures, 0);
+
+  advanceClocks(io, interestLifetime, maxRetriesAfterVersionFound + 1);
+  BOOST_CHECK_EQUAL(face.sentInterests.size(), 2);
+  BOOST_CHECK_EQUAL(nFailures, 0);
+}
+
+BOOST_FIXTURE_TEST_CASE(SpeculativeCancel, DiscoverVersionSpeculativeFixture)
+{
+  discover->run();
+  advanceClocks(io, time::nanoseconds(1), 1);
+
+  face.receive(*makeDataWithVersion(1));
+  advanceClocks(io, time::nanoseconds(1), 1);
+  BOOST_CHECK_EQUAL(discoveredVersion, 1);
+  BOOST_REQUIRE_EQUAL(face.sentInterests.size(), 2);
+
+  // the version has been retrieved before being confirmed
+  discover->cancel();
+  advanceClocks(io, interestLifetime, maxRetriesAfterVersionFound + 1);
+  BOOST_CHECK_EQUAL(face.sentInterests.size(), 2);
+  BOOST_CHECK_EQUAL(nNewerVersions, 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END() // TestDiscoverVersionIterative
 BOOST_AUTO_TEST_SUITE_END() // Chunks
 
@@ -0,0 +1,91 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "tools/chunks/catchunks/interest-template.hpp"
+
+#include "tests/test-common.hpp"
+
+namespace ndn {
+namespace chunks {
+namespace tests {
+
+BOOST_AUTO_TEST_SUITE(Chunks)
+BOOST_AUTO_TEST_SUITE(TestInterestTemplate)
+
+BOOST_AUTO_TEST_CASE(MatchesEncodedInterest)
+{
+  Name prefix("/ndn/chunks/test/%FD%01");
+  Options options;
+  options.interestLifetime = time::milliseconds(2345);
+  options.mustBeFresh = true;
+
+  InterestTemplate interestTemplate(prefix, options);
+
+  // segment numbers covering every length of the NonNegativeInteger encoding
+  std::vector<uint64_t> segments {0, 1, 255, 256, 4321, 65535, 65536, 4294967295,
+                                  4294967296, std::numeric_limits<uint64_t>::max()};
+
+  for (uint64_t segNo : segments) {
+    Interest interest = interestTemplate.makeInterest(segNo);
+
+    Interest expected(Name(prefix).appendSegment(segNo));
+    expected.setInterestLifetime(options.interestLifetime);
+    expected.setMustBeFresh(options.mustBeFresh);
+    expected.setMaxSuffixComponents(1);
+    expected.setNonce(interest.getNonce());
+
+    BOOST_CHECK_EQUAL(interest.getName(), expected.getName());
+    BOOST_CHECK_EQUAL(interest.getName()[-1].toSegment(), segNo);
+    BOOST_CHECK_EQUAL(interest.getInterestLifetime(), options.interestLifetime);
+    BOOST_CHECK_EQUAL(interest.getMustBeFresh(), options.mustBeFresh);
+    BOOST_CHECK_EQUAL(interest.getMaxSuffixComponents(), 1);
+    BOOST_CHECK(interest.wireEncode() == expected.wireEncode());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(DistinctInterests)
+{
+  InterestTemplate interestTemplate("/ndn/chunks/test", Options());
+
+  Interest first = interestTemplate.makeInterest(7);
+  Buffer firstWire(first.wireEncode().begin(), first.wireEncode().end());
+  Interest second = interestTemplate.makeInterest(7);
+  Interest other = interestTemplate.makeInterest(8);
+
+  // the template is not altered by the Interests it produced
+  BOOST_CHECK_EQUAL(first.getName(), second.getName());
+  BOOST_CHECK_EQUAL(first.getName()[-1].toSegment(), 7);
+  BOOST_CHECK_EQUAL(other.getName()[-1].toSegment(), 8);
+
+  // each Interest has its own wire encoding
+  BOOST_CHECK(first.wireEncode().wire() != second.wireEncode().wire());
+  BOOST_CHECK_EQUAL_COLLECTIONS(first.wireEncode().begin(), first.wireEncode().end(),
+                                firstWire.begin(), firstWire.end());
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestInterestTemplate
+BOOST_AUTO_TEST_SUITE_END() // Chunks
+
+} // namespace tests
+} // namespace chunks
+} // namespace ndn
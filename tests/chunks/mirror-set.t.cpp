@@ -0,0 +1,180 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "tools/chunks/catchunks/mirror-set.hpp"
+
+#include "tests/test-common.hpp"
+
+#include <cmath>
+
+namespace ndn {
+namespace chunks {
+namespace aimd {
+namespace tests {
+
+class MirrorSetFixture
+{
+protected:
+  MirrorSetFixture()
+    : mirrors({"/ndn/chunks/a/%FD%01", "/ndn/chunks/b/%FD%02"}, Options(), RttEstimator::Options())
+  {
+  }
+
+  /**
+   * @return number of times each mirror is selected among @p nSelections
+   */
+  std::vector<size_t>
+  countSelections(size_t nSelections)
+  {
+    std::vector<size_t> counts(mirrors.size());
+    for (size_t i = 0; i < nSelections; ++i)
+      ++counts[mirrors.select()];
+    return counts;
+  }
+
+protected:
+  MirrorSet mirrors;
+};
+
+BOOST_AUTO_TEST_SUITE(Chunks)
+BOOST_FIXTURE_TEST_SUITE(TestMirrorSet, MirrorSetFixture)
+
+BOOST_AUTO_TEST_CASE(Interests)
+{
+  BOOST_CHECK_EQUAL(mirrors.makeInterest(0, 5).getName(),
+                    Name("/ndn/chunks/a/%FD%01").appendSegment(5));
+  BOOST_CHECK_EQUAL(mirrors.makeInterest(1, 5).getName(),
+                    Name("/ndn/chunks/b/%FD%02").appendSegment(5));
+}
+
+BOOST_AUTO_TEST_CASE(EqualWeights)
+{
+  // without measurements the mirrors alternate
+  BOOST_CHECK_EQUAL(mirrors.select(), 0);
+  BOOST_CHECK_EQUAL(mirrors.select(), 1);
+  BOOST_CHECK_EQUAL(mirrors.select(), 0);
+  BOOST_CHECK_EQUAL(mirrors.select(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(AvoidedMirror)
+{
+  for (int i = 0; i < 10; ++i)
+    BOOST_CHECK_EQUAL(mirrors.select(0), 1);
+
+  MirrorSet single({"/ndn/chunks/a/%FD%01"}, Options(), RttEstimator::Options());
+  BOOST_CHECK_EQUAL(single.select(0), 0);
+}
+
+BOOST_AUTO_TEST_CASE(Rtt)
+{
+  // mirror 0 is four times closer than mirror 1
+  for (uint64_t segNo = 0; segNo < 10; ++segNo) {
+    mirrors.getRttEstimator(0).addMeasurement(segNo, 0, Milliseconds(25), 1);
+    mirrors.getRttEstimator(1).addMeasurement(segNo, 0, Milliseconds(100), 1);
+  }
+
+  auto counts = countSelections(100);
+  BOOST_CHECK_EQUAL(counts[0], 80);
+  BOOST_CHECK_EQUAL(counts[1], 20);
+}
+
+BOOST_AUTO_TEST_CASE(Loss)
+{
+  for (int i = 0; i < 20; ++i)
+    mirrors.onLoss(1);
+
+  auto counts = countSelections(100);
+  BOOST_CHECK_GT(counts[0], 80);
+  BOOST_CHECK_GT(counts[1], 0); // still probed
+
+  // the mirror recovers its share once it delivers again
+  for (int i = 0; i < 50; ++i)
+    mirrors.onDataReceived(1);
+
+  counts = countSelections(100);
+  BOOST_CHECK_GE(counts[1], 49);
+  BOOST_CHECK_LE(counts[1], 51);
+}
+
+BOOST_AUTO_TEST_CASE(TimeoutBackoff)
+{
+  auto t0 = time::steady_clock::now();
+  auto t1 = t0 + time::seconds(1);
+
+  // a burst of timeouts of the Interests sent at t0 backs off the RTO of mirror 1 once
+  mirrors.onTimeout(1, t0, t1);
+  mirrors.onTimeout(1, t0, t1);
+  BOOST_CHECK_EQUAL(mirrors.getRttEstimator(1).getEstimatedRto().count(), 2000);
+  BOOST_CHECK_EQUAL(mirrors.getRttEstimator(0).getEstimatedRto().count(), 1000);
+
+  // the timeout of an Interest sent since backs it off again
+  mirrors.onTimeout(1, t1, t1 + time::seconds(2));
+  BOOST_CHECK_EQUAL(mirrors.getRttEstimator(1).getEstimatedRto().count(), 4000);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestMirrorSet
+
+BOOST_AUTO_TEST_SUITE(TestMirrorRouter)
+
+BOOST_AUTO_TEST_CASE(WithoutMirrors)
+{
+  RttEstimator rttEstimator;
+  MirrorRouter router(rttEstimator);
+  router.start("/ndn/chunks/a/%FD%01", Options());
+
+  BOOST_CHECK_EQUAL(router.canRetryElsewhere(), false);
+  BOOST_CHECK_EQUAL(router.select(), 0);
+  BOOST_CHECK_EQUAL(router.makeInterest(0, 5).getName(),
+                    Name("/ndn/chunks/a/%FD%01").appendSegment(5));
+  BOOST_CHECK_EQUAL(&router.getRttEstimator(0), &rttEstimator);
+
+  // the RTT estimator of the pipeline is fed by the pipeline only
+  router.addRttMeasurement(0, 5, 0, Milliseconds(25), 1);
+  BOOST_CHECK(std::isnan(rttEstimator.getSmoothedRtt().count()));
+}
+
+BOOST_AUTO_TEST_CASE(WithMirrors)
+{
+  RttEstimator rttEstimator;
+  MirrorRouter router(rttEstimator);
+  router.setMirrors({"/ndn/chunks/b/%FD%02"});
+  router.start("/ndn/chunks/a/%FD%01", Options());
+
+  BOOST_CHECK_EQUAL(router.canRetryElsewhere(), true);
+  BOOST_CHECK_EQUAL(router.select(0), 1);
+  BOOST_CHECK_EQUAL(router.makeInterest(1, 5).getName(),
+                    Name("/ndn/chunks/b/%FD%02").appendSegment(5));
+  BOOST_CHECK_NE(&router.getRttEstimator(1), &rttEstimator);
+
+  router.addRttMeasurement(1, 5, 0, Milliseconds(25), 4);
+  BOOST_CHECK_EQUAL(router.getRttEstimator(1).getSmoothedRtt().count(), 25);
+  BOOST_CHECK(std::isnan(rttEstimator.getSmoothedRtt().count()));
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestMirrorRouter
+BOOST_AUTO_TEST_SUITE_END() // Chunks
+
+} // namespace tests
+} // namespace aimd
+} // namespace chunks
+} // namespace ndn
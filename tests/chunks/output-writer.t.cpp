@@ -0,0 +1,284 @@
+/**
+ * Copyright (c) 2016,  Arizona Board of Regents.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ *
+ * @author Teng Liang
+ */
+
+
+#include "tools/chunks/catchunks/output-writer.hpp"
+
+#include "tests/test-common.hpp"
+
+#include <atomic>
+#include <sstream>
+#include <thread>
+
+#include <unistd.h>
+
+namespace ndn {
+namespace chunks {
+namespace tests {
+
+using namespace ndn::tests;
+
+/**
+ * @brief stream buffer that holds the writer thread until it is opened
+ */
+class GatedBuffer : public std::stringbuf
+{
+public:
+  GatedBuffer()
+    : isOpen(false)
+  {
+  }
+
+protected:
+  std::streamsize
+  xsputn(const char* s, std::streamsize n) final
+  {
+    while (!isOpen.load())
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    return std::stringbuf::xsputn(s, n);
+  }
+
+public:
+  std::atomic<bool> isOpen;
+};
+
+/**
+ * @brief stream buffer that fails every write, e.g. because the disk is full
+ */
+class FailingBuffer : public std::stringbuf
+{
+protected:
+  std::streamsize
+  xsputn(const char* s, std::streamsize n) final
+  {
+    return 0;
+  }
+};
+
+static shared_ptr<const Data>
+makeSegment(uint64_t segmentNo, const std::string& content)
+{
+  auto data = makeData(Name("/ndn/chunks/test").appendVersion(1).appendSegment(segmentNo));
+  data->setContent(reinterpret_cast<const uint8_t*>(content.data()), content.size());
+  return data;
+}
+
+BOOST_AUTO_TEST_SUITE(Chunks)
+BOOST_AUTO_TEST_SUITE(TestOutputWriter)
+
+BOOST_AUTO_TEST_CASE(WriteInOrder)
+{
+  boost::asio::io_service io;
+  std::ostringstream os;
+  OutputWriter writer(os, io);
+
+  std::string expected;
+  for (uint64_t i = 0; i < 10; ++i) {
+    std::string content = "segment " + to_string(i) + "\n";
+    auto data = makeSegment(i, content);
+    BOOST_CHECK_EQUAL(writer.push(data), true);
+    BOOST_CHECK(data == nullptr); // moved into the queue
+    expected += content;
+  }
+
+  writer.flush();
+  BOOST_CHECK_EQUAL(os.str(), expected);
+}
+
+BOOST_AUTO_TEST_CASE(WakeUp)
+{
+  boost::asio::io_service io;
+  std::ostringstream os;
+  OutputWriter writer(os, io);
+
+  // the writer thread waits for each segment, and flush() for the writer thread;
+  // a missed notification on either side blocks this loop
+  for (uint64_t i = 0; i < 1000; ++i) {
+    auto data = makeSegment(i, "x");
+    BOOST_REQUIRE_EQUAL(writer.push(data), true);
+    writer.flush();
+    BOOST_REQUIRE_EQUAL(writer.getNWrittenBytes(), i + 1);
+  }
+  BOOST_CHECK_EQUAL(os.str(), std::string(1000, 'x'));
+}
+
+BOOST_AUTO_TEST_CASE(FullQueue)
+{
+  boost::asio::io_service io;
+  GatedBuffer buffer;
+  std::ostream os(&buffer);
+  OutputWriter::Options options;
+  options.queueSize = 2;
+  OutputWriter writer(os, io, options);
+
+  int nCallbacks = 0;
+  writer.setSpaceCallback([&nCallbacks] { ++nCallbacks; });
+
+  // the writer thread is held while writing the first segment, which keeps its slot
+  auto data0 = makeSegment(0, "a");
+  auto data1 = makeSegment(1, "b");
+  auto data2 = makeSegment(2, "c");
+  BOOST_CHECK_EQUAL(writer.push(data0), true);
+  BOOST_CHECK_EQUAL(writer.push(data1), true);
+  BOOST_CHECK_EQUAL(writer.push(data2), false);
+  BOOST_CHECK(data2 != nullptr);
+  BOOST_CHECK_EQUAL(nCallbacks, 0);
+
+  // the io_service runs until the writer reports that there is room
+  buffer.isOpen = true;
+  io.run();
+  BOOST_CHECK_EQUAL(nCallbacks, 1);
+
+  BOOST_CHECK_EQUAL(writer.push(data2), true);
+  writer.flush();
+  BOOST_CHECK_EQUAL(buffer.str(), "abc");
+}
+
+BOOST_AUTO_TEST_CASE(WriteTimes)
+{
+  boost::asio::io_service io;
+  GatedBuffer buffer;
+  std::ostream os(&buffer);
+  OutputWriter writer(os, io);
+  writer.enableWriteTimes(PipelineClock::getDefault());
+
+  auto data0 = makeSegment(0, "ab");
+  auto data1 = makeSegment(1, "cde");
+  BOOST_CHECK_EQUAL(writer.push(data0), true);
+  BOOST_CHECK_EQUAL(writer.push(data1), true);
+
+  // queued segments are not written yet
+  std::vector<time::steady_clock::TimePoint> times;
+  writer.takeWriteTimes(times);
+  BOOST_CHECK_EQUAL(times.size(), 0);
+  BOOST_CHECK_EQUAL(writer.getNWrittenBytes(), 0);
+
+  auto before = time::steady_clock::now();
+  buffer.isOpen = true;
+  writer.flush();
+  BOOST_CHECK_EQUAL(writer.getNWrittenBytes(), 5);
+  writer.takeWriteTimes(times);
+  BOOST_REQUIRE_EQUAL(times.size(), 2);
+  BOOST_CHECK(times[0] >= before);
+  BOOST_CHECK(times[1] >= times[0]);
+
+  writer.takeWriteTimes(times);
+  BOOST_CHECK_EQUAL(times.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(WriteFailure)
+{
+  boost::asio::io_service io;
+  FailingBuffer buffer;
+  std::ostream os(&buffer);
+  OutputWriter writer(os, io);
+
+  std::string reason;
+  writer.setFailureCallback([&reason] (const std::string& r) { reason = r; });
+
+  for (uint64_t i = 0; i < 10; ++i) {
+    auto data = makeSegment(i, "segment " + to_string(i) + "\n");
+    BOOST_CHECK_EQUAL(writer.push(data), true);
+  }
+
+  BOOST_CHECK_THROW(writer.flush(), OutputWriter::Error);
+  BOOST_CHECK_EQUAL(writer.getNWrittenBytes(), 0);
+
+  // the failure is reported on the Face thread without waiting for flush()
+  io.run();
+  BOOST_CHECK_EQUAL(reason, "Failed to write the output");
+}
+
+BOOST_AUTO_TEST_CASE(Pipe)
+{
+  int fds[2];
+  BOOST_REQUIRE_EQUAL(::pipe(fds), 0);
+
+  boost::asio::io_service io;
+  OutputWriter writer(fds[1], io);
+  BOOST_CHECK_EQUAL(writer.isSplicing(), false);
+
+  std::string expected;
+  for (uint64_t i = 0; i < 10; ++i) {
+    std::string content(1000 + i, 'a' + i);
+    auto data = makeSegment(i, content);
+    BOOST_CHECK_EQUAL(writer.push(data), true);
+    expected += content;
+  }
+  writer.flush();
+
+  std::string received(expected.size(), '\0');
+  size_t nRead = 0;
+  while (nRead < received.size()) {
+    ssize_t n = ::read(fds[0], &received[nRead], received.size() - nRead);
+    BOOST_REQUIRE_GT(n, 0);
+    nRead += n;
+  }
+  BOOST_CHECK(received == expected);
+
+  ::close(fds[0]);
+  ::close(fds[1]);
+}
+
+BOOST_AUTO_TEST_CASE(PipeVmsplice)
+{
+  int fds[2];
+  BOOST_REQUIRE_EQUAL(::pipe(fds), 0);
+
+  boost::asio::io_service io;
+  OutputWriter::Options options;
+  options.allowVmsplice = true;
+  std::string expected;
+  {
+    OutputWriter writer(fds[1], io, options);
+#ifdef __linux__
+    BOOST_CHECK_EQUAL(writer.isSplicing(), true);
+#endif
+
+    for (uint64_t i = 0; i < 10; ++i) {
+      std::string content(1000 + i, 'a' + i);
+      auto data = makeSegment(i, content);
+      BOOST_CHECK_EQUAL(writer.push(data), true);
+      expected += content;
+    }
+    writer.flush();
+
+    std::string received(expected.size(), '\0');
+    size_t nRead = 0;
+    while (nRead < received.size()) {
+      ssize_t n = ::read(fds[0], &received[nRead], received.size() - nRead);
+      BOOST_REQUIRE_GT(n, 0);
+      nRead += n;
+    }
+    BOOST_CHECK(received == expected);
+  } // the pipe has been read, so the writer releases the segments and stops
+
+  ::close(fds[0]);
+  ::close(fds[1]);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestOutputWriter
+BOOST_AUTO_TEST_SUITE_END() // Chunks
+
+} // namespace tests
+} // namespace chunks
+} // namespace ndn
@@ -43,7 +43,7 @@ public:
     , opt(makePipelineOptions())
     , rttEstimator(makeRttEstimatorOptions())
   {
-    auto pline = make_unique<PipelineInterestsAimd>(face, rttEstimator, opt);
+    auto pline = make_unique<PipelineInterestsAimd>(face, rttEstimator, rateEstimator, opt);
     aimdPipeline = pline.get();
     setPipeline(std::move(pline));
   }
@@ -77,9 +77,34 @@ private:
 protected:
   PipelineInterestsAimdOptions opt;
   RttEstimator rttEstimator;
+  RateEstimator rateEstimator;
   PipelineInterestsAimd* aimdPipeline;
 };
 
+/**
+ * @brief clock that runs ahead of time::steady_clock by an adjustable offset
+ */
+class OffsetClock : public PipelineClock
+{
+public:
+  OffsetClock()
+    : offset(0)
+    , nReads(0)
+  {
+  }
+
+  TimePoint
+  now() const final
+  {
+    ++nReads;
+    return time::steady_clock::now() + offset;
+  }
+
+public:
+  time::nanoseconds offset;
+  mutable int nReads;
+};
+
 BOOST_AUTO_TEST_SUITE(Chunks)
 BOOST_FIXTURE_TEST_SUITE(TestPipelineInterestsAimd, PipelineInterestAimdFixture)
 
@@ -129,6 +154,58 @@ BOOST_AUTO_TEST_CASE(CongestionAvoidance)
   }
 }
 
+BOOST_AUTO_TEST_CASE(InjectedClock)
+{
+  nDataSegments = 4;
+  OffsetClock clock;
+  aimdPipeline->setClock(clock);
+
+  runWithData(*makeDataWithSegment(0));
+  advanceClocks(io, time::nanoseconds(1));
+  BOOST_REQUIRE_EQUAL(face.sentInterests.size(), 1);
+  BOOST_CHECK_EQUAL(clock.nReads, 1);
+
+  // the RTT sample is taken from the injected clock, which is read once for the Data
+  clock.offset = time::milliseconds(100);
+  face.receive(*makeDataWithSegment(1));
+  advanceClocks(io, time::nanoseconds(1));
+  BOOST_CHECK_EQUAL(clock.nReads, 2);
+  BOOST_CHECK_CLOSE(rttEstimator.getMinRtt().count(), 100, 1);
+}
+
+BOOST_AUTO_TEST_CASE(MirrorTimeout)
+{
+  nDataSegments = 2;
+  Name mirror("/ndn/chunks/mirror");
+  mirror.appendVersion(0);
+  aimdPipeline->setMirrors({mirror});
+
+  runWithData(*makeDataWithSegment(0));
+  advanceClocks(io, time::nanoseconds(1));
+  BOOST_REQUIRE_EQUAL(face.sentInterests.size(), 1);
+  BOOST_CHECK(Name(name).appendVersion(0).isPrefixOf(face.sentInterests.back().getName()));
+  BOOST_CHECK_EQUAL(aimdPipeline->m_segmentInfo[1].rto.count(), 1000);
+
+  // segment 1 times out on the retrieved prefix, whose RTO alone is backed off
+  advanceClocks(io, time::milliseconds(10), 110);
+  BOOST_REQUIRE_EQUAL(face.sentInterests.size(), 2);
+  BOOST_CHECK(mirror.isPrefixOf(face.sentInterests.back().getName()));
+  BOOST_CHECK_EQUAL(aimdPipeline->m_segmentInfo[1].mirrorNo, 1);
+  BOOST_CHECK_EQUAL(aimdPipeline->m_segmentInfo[1].rto.count(), 1000);
+  BOOST_CHECK_EQUAL(aimdPipeline->m_mirrors.getRttEstimator(0).getEstimatedRto().count(), 2000);
+  BOOST_CHECK_EQUAL(rttEstimator.getEstimatedRto().count(), 1000);
+
+  // segment 1 times out on the mirror, and is sent again on the retrieved prefix with its RTO
+  advanceClocks(io, time::milliseconds(10), 110);
+  BOOST_REQUIRE_EQUAL(face.sentInterests.size(), 3);
+  BOOST_CHECK(Name(name).appendVersion(0).isPrefixOf(face.sentInterests.back().getName()));
+  BOOST_CHECK_EQUAL(aimdPipeline->m_segmentInfo[1].mirrorNo, 0);
+  BOOST_CHECK_EQUAL(aimdPipeline->m_segmentInfo[1].rto.count(), 2000);
+  BOOST_CHECK_EQUAL(aimdPipeline->m_mirrors.getRttEstimator(1).getEstimatedRto().count(), 2000);
+  BOOST_CHECK_EQUAL(rttEstimator.getEstimatedRto().count(), 1000);
+  BOOST_CHECK_EQUAL(aimdPipeline->m_retxCount[1], 2);
+}
+
 BOOST_AUTO_TEST_CASE(Timeout)
 {
   nDataSegments = 8;
@@ -176,6 +253,131 @@ BOOST_AUTO_TEST_CASE(Timeout)
   BOOST_CHECK_EQUAL(aimdPipeline->m_retxCount[3], 1);
 }
 
+BOOST_AUTO_TEST_CASE(SegmentRange)
+{
+  nDataSegments = 10;
+  pipeline->setSegmentRange(3, 5);
+
+  runWithData(*makeDataWithSegment(0));
+  advanceClocks(io, time::nanoseconds(1));
+  BOOST_REQUIRE_EQUAL(face.sentInterests.size(), 1);
+  BOOST_CHECK_EQUAL(face.sentInterests[0].getName()[-1].toSegment(), 3);
+
+  for (uint64_t i = 3; i <= 5; ++i) {
+    face.receive(*makeDataWithSegment(i));
+    advanceClocks(io, time::nanoseconds(1));
+  }
+
+  // only the segments of the range have been requested
+  BOOST_REQUIRE_EQUAL(face.sentInterests.size(), 3);
+  for (uint64_t i = 0; i < 3; ++i) {
+    BOOST_CHECK_EQUAL(face.sentInterests[i].getName()[-1].toSegment(), i + 3);
+  }
+  BOOST_CHECK_EQUAL(nReceivedSegments, 3);
+  BOOST_CHECK_EQUAL(pipeline->isStopping(), true);
+  BOOST_CHECK_EQUAL(hasFailed, false);
+}
+
+BOOST_AUTO_TEST_CASE(SegmentRangeBeyondFinalBlockId)
+{
+  nDataSegments = 4;
+  pipeline->setSegmentRange(0, 20);
+
+  runWithData(*makeDataWithSegment(0, false));
+  advanceClocks(io, time::nanoseconds(1));
+  for (uint64_t i = 1; i < 3; ++i) {
+    face.receive(*makeDataWithSegment(i, false));
+    advanceClocks(io, time::nanoseconds(1));
+  }
+  BOOST_CHECK_EQUAL(aimdPipeline->m_hasFinalBlockId, false);
+
+  // the FinalBlockId of the content ends the retrieval before the end of the range
+  face.receive(*makeDataWithSegment(3));
+  advanceClocks(io, time::nanoseconds(1));
+  BOOST_CHECK_EQUAL(aimdPipeline->m_hasFinalBlockId, true);
+  BOOST_CHECK_EQUAL(nReceivedSegments, 3);
+  BOOST_CHECK_EQUAL(pipeline->isStopping(), true);
+
+  // no segment after the FinalBlockId is waited for
+  size_t nSentInterests = face.sentInterests.size();
+  advanceClocks(io, time::milliseconds(100), 100);
+  BOOST_CHECK_EQUAL(face.sentInterests.size(), nSentInterests);
+  BOOST_CHECK_EQUAL(hasFailed, false);
+}
+
+BOOST_AUTO_TEST_CASE(Follow)
+{
+  opt.isFollowing = true;
+  opt.followWindow = 2;
+  opt.interestLifetime = time::seconds(1);
+  auto pline = make_unique<PipelineInterestsAimd>(face, rttEstimator, rateEstimator, opt);
+  aimdPipeline = pline.get();
+  setPipeline(std::move(pline));
+
+  nDataSegments = 3;
+  runWithData(*makeDataWithSegment(0, false));
+  advanceClocks(io, time::nanoseconds(1));
+  face.receive(*makeDataWithSegment(1, false));
+  advanceClocks(io, time::nanoseconds(1));
+
+  // only followWindow segments are requested beyond the newest one
+  BOOST_REQUIRE_CLOSE(aimdPipeline->m_cwnd, 2, 0.1);
+  BOOST_REQUIRE_EQUAL(face.sentInterests.size(), 3);
+  BOOST_CHECK_EQUAL(face.sentInterests[2].getName()[-1].toSegment(), 3);
+
+  // segments 2 and 3 are not produced yet: their Interests are refreshed on expiry,
+  // without any loss event or retransmission
+  advanceClocks(io, time::milliseconds(10), 150);
+  BOOST_REQUIRE_EQUAL(face.sentInterests.size(), 5);
+  BOOST_CHECK_EQUAL(aimdPipeline->getNLossEvents(), 0);
+  BOOST_CHECK_EQUAL(aimdPipeline->m_retxCount.size(), 0);
+  BOOST_CHECK_CLOSE(aimdPipeline->m_cwnd, 2, 0.1);
+
+  // the segment carrying the FinalBlockId ends the retrieval
+  face.receive(*makeDataWithSegment(2));
+  advanceClocks(io, time::nanoseconds(1));
+  BOOST_CHECK_EQUAL(nReceivedSegments, 2);
+  BOOST_CHECK_EQUAL(pipeline->isStopping(), true);
+  BOOST_CHECK_EQUAL(hasFailed, false);
+}
+
+BOOST_AUTO_TEST_CASE(Backpressure)
+{
+  nDataSegments = 10;
+
+  runWithData(*makeDataWithSegment(0));
+  advanceClocks(io, time::nanoseconds(1));
+  BOOST_REQUIRE_EQUAL(face.sentInterests.size(), 1);
+
+  face.receive(*makeDataWithSegment(1));
+  advanceClocks(io, time::nanoseconds(1));
+  BOOST_REQUIRE_EQUAL(face.sentInterests.size(), 3); // segments 2 and 3 requested
+
+  // segment 2 is missing and the reorder buffer of the consumer is full
+  pipeline->applyBackpressure(2);
+  face.receive(*makeDataWithSegment(3));
+  advanceClocks(io, time::nanoseconds(1));
+  BOOST_CHECK_EQUAL(face.sentInterests.size(), 3); // no new segment despite the open window
+
+  // segment 2 times out and is retransmitted, still no new segment
+  advanceClocks(io, time::milliseconds(250));
+  BOOST_REQUIRE_EQUAL(face.sentInterests.size(), 4);
+  BOOST_CHECK_EQUAL(face.sentInterests.back().getName()[-1].toSegment(), 2);
+
+  face.receive(*makeDataWithSegment(2));
+  advanceClocks(io, time::nanoseconds(1));
+  BOOST_CHECK_EQUAL(face.sentInterests.size(), 4);
+
+  pipeline->releaseBackpressure();
+  advanceClocks(io, time::nanoseconds(1));
+  BOOST_REQUIRE_GT(face.sentInterests.size(), 4);
+  for (size_t i = 4; i < face.sentInterests.size(); ++i) {
+    BOOST_CHECK_GT(face.sentInterests[i].getName()[-1].toSegment(), 3);
+  }
+  BOOST_CHECK_EQUAL(aimdPipeline->m_retxQueue.size(), 0);
+  BOOST_CHECK_EQUAL(hasFailed, false);
+}
+
 BOOST_AUTO_TEST_CASE(Nack)
 {
   nDataSegments = 5;
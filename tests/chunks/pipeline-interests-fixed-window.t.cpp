@@ -28,6 +28,9 @@
 
 #include "pipeline-interests-fixture.hpp"
 
+#include <boost/algorithm/string/classification.hpp>
+#include <boost/algorithm/string/split.hpp>
+
 namespace ndn {
 namespace chunks {
 namespace tests {
@@ -42,10 +45,13 @@ public:
     : PipelineInterestsFixture()
     , opt(makeOptions())
   {
-    setPipeline(make_unique<PipelineInterestsFixedWindow>(face, PipelineInterestsFixedWindow::Options(opt)));
+    auto pline = make_unique<PipelineInterestsFixedWindow>(face, PipelineInterestsFixedWindow::Options(opt));
+    fixedPipeline = pline.get();
+    setPipeline(std::move(pline));
   }
 protected:
   Options opt;
+  PipelineInterestsFixedWindow* fixedPipeline;
 
 private:
   static Options
@@ -126,6 +132,35 @@ BOOST_FIXTURE_TEST_CASE(FullPipeline, PipelineInterestFixedWindowFixture)
   BOOST_CHECK_EQUAL(hasFailed, false);
 }
 
+BOOST_FIXTURE_TEST_CASE(FetchersReused, PipelineInterestFixedWindowFixture)
+{
+  nDataSegments = 13;
+  BOOST_ASSERT(nDataSegments > opt.maxPipelineSize);
+
+  runWithData(*makeDataWithSegment(nDataSegments - 1));
+  advanceClocks(io, time::nanoseconds(1), 1);
+  BOOST_REQUIRE_EQUAL(fixedPipeline->m_segmentFetchers.size(), opt.maxPipelineSize);
+
+  std::vector<DataFetcher*> fetchers;
+  for (const auto& fetcher : fixedPipeline->m_segmentFetchers) {
+    BOOST_REQUIRE(fetcher.first != nullptr);
+    fetchers.push_back(fetcher.first.get());
+  }
+
+  for (uint64_t i = 0; i < nDataSegments - 1; ++i) {
+    face.receive(*makeDataWithSegment(i));
+    advanceClocks(io, time::nanoseconds(1), 1);
+
+    // every pipeline slot keeps using the fetcher it was given at the beginning
+    for (size_t j = 0; j < opt.maxPipelineSize; ++j) {
+      BOOST_CHECK_EQUAL(fixedPipeline->m_segmentFetchers[j].first.get(), fetchers[j]);
+    }
+  }
+
+  BOOST_CHECK_EQUAL(nReceivedSegments, nDataSegments - 1);
+  BOOST_CHECK_EQUAL(hasFailed, false);
+}
+
 BOOST_FIXTURE_TEST_CASE(TimeoutAllSegments, PipelineInterestFixedWindowFixture)
 {
   nDataSegments = 13;
@@ -325,6 +360,108 @@ BOOST_FIXTURE_TEST_CASE(CongestionAllSegments, PipelineInterestFixedWindowFixtur
   BOOST_CHECK_EQUAL(hasFailed, true);
 }
 
+BOOST_FIXTURE_TEST_CASE(TraceRetransmissions, PipelineInterestFixedWindowFixture)
+{
+  SegmentTracer tracer(100);
+  pipeline->setTracer(&tracer);
+
+  nDataSegments = 3;
+  runWithData(*makeDataWithSegment(0));
+  advanceClocks(io, time::nanoseconds(1), 1);
+  BOOST_REQUIRE_EQUAL(face.sentInterests.size(), 2);
+
+  // the Interests expire once and are retransmitted by the fetchers
+  advanceClocks(io, opt.interestLifetime, 1);
+  BOOST_REQUIRE_EQUAL(face.sentInterests.size(), 4);
+  face.receive(*makeDataWithSegment(1));
+  face.receive(*makeDataWithSegment(2));
+  advanceClocks(io, time::nanoseconds(1), 1);
+  BOOST_CHECK_EQUAL(nReceivedSegments, 2);
+  BOOST_CHECK_EQUAL(tracer.getNEvents(), 6);
+
+  // one retransmission per segment in the nretx column
+  std::ostringstream os;
+  tracer.dump(os);
+  std::istringstream is(os.str());
+  std::string line;
+  std::getline(is, line); // header
+  size_t nSegments = 0;
+  while (std::getline(is, line)) {
+    std::vector<std::string> fields;
+    boost::algorithm::split(fields, line, boost::algorithm::is_any_of("\t"));
+    BOOST_REQUIRE_EQUAL(fields.size(), 7);
+    BOOST_CHECK_EQUAL(fields[5], "1");
+    ++nSegments;
+  }
+  BOOST_CHECK_EQUAL(nSegments, 2);
+}
+
+BOOST_FIXTURE_TEST_CASE(FollowRefreshesNotRetransmitted, PipelineInterestFixedWindowFixture)
+{
+  opt.isFollowing = true;
+  auto pline = make_unique<PipelineInterestsFixedWindow>(face, opt);
+  fixedPipeline = pline.get();
+  setPipeline(std::move(pline));
+
+  nDataSegments = 6;
+  runWithData(*makeDataWithSegment(0, false));
+  advanceClocks(io, time::nanoseconds(1), 1);
+  face.receive(*makeDataWithSegment(1, false));
+  advanceClocks(io, time::nanoseconds(1), 1);
+  BOOST_REQUIRE_EQUAL(face.sentInterests.size(), opt.maxPipelineSize + 1);
+
+  // segments 2 to 6 are not produced yet: their Interests are refreshed on expiry
+  advanceClocks(io, opt.interestLifetime, 1);
+  BOOST_REQUIRE_EQUAL(face.sentInterests.size(), 2 * opt.maxPipelineSize + 1);
+  BOOST_CHECK_EQUAL(pipeline->getStatus().nRetransmitted, 0);
+
+  face.receive(*makeDataWithSegment(4, false));
+  advanceClocks(io, time::nanoseconds(1), 1);
+  BOOST_CHECK_EQUAL(pipeline->getStatus().nRetransmitted, 0);
+
+  // segments 2 and 3 are known to exist now, so their next expiry is a retransmission
+  advanceClocks(io, opt.interestLifetime, 1);
+  BOOST_CHECK_EQUAL(pipeline->getStatus().nRetransmitted, 2);
+
+  face.receive(*makeDataWithSegment(2, false));
+  face.receive(*makeDataWithSegment(3, false));
+  face.receive(*makeDataWithSegment(5));
+  advanceClocks(io, time::nanoseconds(1), 1);
+  BOOST_CHECK_EQUAL(nReceivedSegments, 5);
+  BOOST_CHECK_EQUAL(pipeline->getStatus().nRetransmitted, 2);
+  BOOST_CHECK_EQUAL(hasFailed, false);
+}
+
+BOOST_FIXTURE_TEST_CASE(FollowTimeoutProducedSegment, PipelineInterestFixedWindowFixture)
+{
+  opt.isFollowing = true;
+  auto pline = make_unique<PipelineInterestsFixedWindow>(face, opt);
+  fixedPipeline = pline.get();
+  setPipeline(std::move(pline));
+
+  nDataSegments = 10;
+  runWithData(*makeDataWithSegment(0, false));
+  advanceClocks(io, time::nanoseconds(1), 1);
+  BOOST_REQUIRE_EQUAL(face.sentInterests.size(), opt.maxPipelineSize);
+
+  // segments 1 to 5 are not produced yet: the refreshes do not count against the limit
+  advanceClocks(io, opt.interestLifetime, 1);
+  BOOST_REQUIRE_EQUAL(face.sentInterests.size(), 2 * opt.maxPipelineSize);
+
+  // segments 1 and 2 are known to exist now, but never arrive
+  face.receive(*makeDataWithSegment(3, false));
+  advanceClocks(io, time::nanoseconds(1), 1);
+
+  for (int i = 0; i < opt.maxRetriesOnTimeoutOrNack; ++i) {
+    advanceClocks(io, opt.interestLifetime, 1);
+    BOOST_CHECK_EQUAL(hasFailed, false);
+  }
+
+  advanceClocks(io, opt.interestLifetime, 1);
+  BOOST_CHECK_EQUAL(hasFailed, true);
+  BOOST_CHECK_EQUAL(nReceivedSegments, 1);
+}
+
 BOOST_AUTO_TEST_SUITE_END() // TestPipelineInterests
 BOOST_AUTO_TEST_SUITE_END() // Chunks
 
@@ -0,0 +1,182 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "tools/chunks/catchunks/pipeline-interests-parallel.hpp"
+#include "tools/chunks/catchunks/pipeline-interests-aimd.hpp"
+
+#include "pipeline-interests-fixture.hpp"
+
+#include <set>
+
+namespace ndn {
+namespace chunks {
+namespace tests {
+
+using namespace ndn::tests;
+using aimd::PipelineInterestsAimd;
+using aimd::RttEstimator;
+using aimd::RateEstimator;
+
+class PipelineInterestsParallelFixture : public PipelineInterestsFixture
+{
+public:
+  PipelineInterestsParallelFixture()
+    : rttEstimator0(makeRttEstimatorOptions())
+    , rttEstimator1(makeRttEstimatorOptions())
+  {
+    auto subflow0 = make_unique<PipelineInterestsAimd>(face, rttEstimator0, rateEstimator0,
+                                                       makePipelineOptions());
+    auto subflow1 = make_unique<PipelineInterestsAimd>(face, rttEstimator1, rateEstimator1,
+                                                       makePipelineOptions());
+    aimd0 = subflow0.get();
+    aimd1 = subflow1.get();
+
+    std::vector<unique_ptr<PipelineInterests>> subflows;
+    subflows.push_back(std::move(subflow0));
+    subflows.push_back(std::move(subflow1));
+    setPipeline(make_unique<PipelineInterestsParallel>(face, std::move(subflows)));
+  }
+
+protected:
+  uint64_t
+  getSegmentNo(size_t interestNo) const
+  {
+    return face.sentInterests.at(interestNo).getName()[-1].toSegment();
+  }
+
+private:
+  static aimd::PipelineInterestsAimdOptions
+  makePipelineOptions()
+  {
+    aimd::PipelineInterestsAimdOptions pipelineOptions;
+    pipelineOptions.initCwnd = 1.0;
+    pipelineOptions.aiStep = 1.0;
+    pipelineOptions.initSsthresh = std::numeric_limits<int>::max();
+    return pipelineOptions;
+  }
+
+  static RttEstimator::Options
+  makeRttEstimatorOptions()
+  {
+    RttEstimator::Options rttOptions;
+    rttOptions.minRto = aimd::Milliseconds(200);
+    rttOptions.maxRto = aimd::Milliseconds(4000);
+    return rttOptions;
+  }
+
+protected:
+  RttEstimator rttEstimator0;
+  RttEstimator rttEstimator1;
+  RateEstimator rateEstimator0;
+  RateEstimator rateEstimator1;
+  PipelineInterestsAimd* aimd0;
+  PipelineInterestsAimd* aimd1;
+};
+
+BOOST_AUTO_TEST_SUITE(Chunks)
+BOOST_FIXTURE_TEST_SUITE(TestPipelineInterestsParallel, PipelineInterestsParallelFixture)
+
+BOOST_AUTO_TEST_CASE(Stripes)
+{
+  nDataSegments = 6;
+  runWithData(*makeDataWithSegment(0));
+  advanceClocks(io, time::nanoseconds(1));
+
+  // the first sub-flow fetches 2 and 4, the second one fetches 1, 3 and 5
+  BOOST_REQUIRE_EQUAL(face.sentInterests.size(), 2);
+  BOOST_CHECK_EQUAL(getSegmentNo(0), 2);
+  BOOST_CHECK_EQUAL(getSegmentNo(1), 1);
+
+  std::set<uint64_t> requested;
+  for (size_t i = 0; i < face.sentInterests.size(); ++i) {
+    uint64_t segNo = getSegmentNo(i);
+    BOOST_CHECK(requested.insert(segNo).second);
+    face.receive(*makeDataWithSegment(segNo));
+    advanceClocks(io, time::nanoseconds(1));
+  }
+
+  BOOST_CHECK_EQUAL(requested.size(), 5);
+  BOOST_CHECK_EQUAL(*requested.begin(), 1);
+  BOOST_CHECK_EQUAL(*requested.rbegin(), 5);
+  BOOST_CHECK_EQUAL(nReceivedSegments, 5);
+  BOOST_CHECK_EQUAL(hasFailed, false);
+  BOOST_CHECK_EQUAL(pipeline->getStatus().nInFlight, 0);
+
+  // both sub-flows are complete and send nothing more
+  advanceClocks(io, time::milliseconds(100), 100);
+  BOOST_CHECK_EQUAL(face.sentInterests.size(), 5);
+}
+
+BOOST_AUTO_TEST_CASE(UnknownFinalBlockId)
+{
+  nDataSegments = 6;
+  runWithData(*makeDataWithSegment(0, false));
+  advanceClocks(io, time::nanoseconds(1));
+
+  // without the last segment, the first sub-flow fetches all the segments
+  BOOST_REQUIRE_EQUAL(face.sentInterests.size(), 1);
+  BOOST_CHECK_EQUAL(getSegmentNo(0), 1);
+
+  face.receive(*makeDataWithSegment(1));
+  advanceClocks(io, time::nanoseconds(1));
+  BOOST_REQUIRE_EQUAL(face.sentInterests.size(), 3);
+  BOOST_CHECK_EQUAL(getSegmentNo(1), 2);
+  BOOST_CHECK_EQUAL(getSegmentNo(2), 3);
+}
+
+BOOST_AUTO_TEST_CASE(CoupledIncrease)
+{
+  std::vector<const PipelineInterestsAimd*> coupled{aimd0, aimd1};
+  aimd0->setCoupledSubflows(coupled);
+  aimd1->setCoupledSubflows(coupled);
+  for (auto subflow : {aimd0, aimd1}) {
+    subflow->m_cwnd = 10.0;
+    subflow->m_ssthresh = 2.0;
+  }
+
+  nDataSegments = 100;
+  runWithData(*makeDataWithSegment(0));
+  advanceClocks(io, time::nanoseconds(1));
+  BOOST_REQUIRE_EQUAL(face.sentInterests.size(), 2);
+  BOOST_REQUIRE_EQUAL(getSegmentNo(0), 2);
+
+  // the window grows before the RTT sample of the segment is taken: start both sub-flows
+  // from the same smoothed RTT
+  rttEstimator0.addMeasurement(2, 0.0, aimd::Milliseconds(100), 1);
+  rttEstimator1.addMeasurement(1, 0.0, aimd::Milliseconds(100), 1);
+
+  face.receive(*makeDataWithSegment(2));
+  advanceClocks(io, time::nanoseconds(1));
+
+  // with equal windows and RTTs, the two sub-flows together grow like a single one:
+  // alpha = 20 * (10 / rtt^2) / (20 / rtt)^2 = 0.5, the increase is alpha / 20 instead of 1 / 10
+  BOOST_CHECK_CLOSE(aimd0->m_cwnd, 10.025, 0.001);
+  BOOST_CHECK_CLOSE(aimd1->m_cwnd, 10.0, 0.001);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestPipelineInterestsParallel
+BOOST_AUTO_TEST_SUITE_END() // Chunks
+
+} // namespace tests
+} // namespace chunks
+} // namespace ndn
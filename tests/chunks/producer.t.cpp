@@ -30,6 +30,8 @@
 #include <ndn-cxx/security/validator-null.hpp>
 
 #include <cmath>
+#include <fcntl.h>
+#include <unistd.h>
 
 namespace ndn {
 namespace chunks {
@@ -225,6 +227,162 @@ BOOST_AUTO_TEST_CASE(RequestNotExistingSegment)
   BOOST_REQUIRE_EQUAL(face.sentData.size(), 1);
 }
 
+BOOST_AUTO_TEST_CASE(Streaming)
+{
+  boost::asio::io_service io;
+  util::DummyClientFace face(io, {true, true});
+  KeyChain keyChain;
+  security::SigningInfo signingInfo;
+  Name prefix("/ndn/chunks/test");
+  Name versionedPrefix = Name(prefix).appendVersion(1449227841747);
+  size_t maxSegmentSize(40);
+
+  int fds[2];
+  BOOST_REQUIRE_EQUAL(::pipe(fds), 0);
+  Producer producer(versionedPrefix, face, keyChain, signingInfo, time::seconds(10),
+                    maxSegmentSize, false, false, fds[0]);
+  io.poll();
+
+  // Interests received before the segments are produced are held
+  face.receive(*makeInterest(prefix));
+  face.receive(*makeInterest(Name(versionedPrefix).appendSegment(1)));
+  io.poll();
+  BOOST_CHECK_EQUAL(face.sentData.size(), 0);
+
+  std::string input(maxSegmentSize + 10, 'a');
+  BOOST_REQUIRE_EQUAL(::write(fds[1], input.data(), input.size()),
+                      static_cast<ssize_t>(input.size()));
+  io.poll();
+
+  // the first segment is published as soon as it is complete, without FinalBlockId
+  BOOST_REQUIRE_EQUAL(face.sentData.size(), 1);
+  BOOST_CHECK_EQUAL(face.sentData[0].getName(), Name(versionedPrefix).appendSegment(0));
+  BOOST_CHECK_EQUAL(face.sentData[0].getContent().value_size(), maxSegmentSize);
+  BOOST_CHECK(face.sentData[0].getFinalBlockId().empty());
+
+  // the end of the stream publishes the remaining bytes as the last segment
+  ::close(fds[1]);
+  io.poll();
+  BOOST_REQUIRE_EQUAL(face.sentData.size(), 2);
+  BOOST_CHECK_EQUAL(face.sentData[1].getName(), Name(versionedPrefix).appendSegment(1));
+  BOOST_CHECK_EQUAL(face.sentData[1].getContent().value_size(), 10);
+  BOOST_REQUIRE(!face.sentData[1].getFinalBlockId().empty());
+  BOOST_CHECK_EQUAL(face.sentData[1].getFinalBlockId().toSegment(), 1);
+  BOOST_CHECK_EQUAL(producer.m_store.size(), 2);
+
+  // no new data beyond the end of the stream
+  face.receive(*makeInterest(Name(versionedPrefix).appendSegment(2)));
+  io.poll();
+  BOOST_CHECK_EQUAL(face.sentData.size(), 2);
+}
+
+BOOST_FIXTURE_TEST_CASE(StreamingHeldInterests, UnitTestTimeFixture)
+{
+  boost::asio::io_service io;
+  util::DummyClientFace face(io, {true, true});
+  KeyChain keyChain;
+  security::SigningInfo signingInfo;
+  Name versionedPrefix = Name("/ndn/chunks/test").appendVersion(1449227841747);
+  size_t maxSegmentSize(40);
+
+  int fds[2];
+  BOOST_REQUIRE_EQUAL(::pipe(fds), 0);
+  Producer producer(versionedPrefix, face, keyChain, signingInfo, time::seconds(10),
+                    maxSegmentSize, false, false, fds[0]);
+  io.poll();
+
+  auto interest = makeInterest(Name(versionedPrefix).appendSegment(5));
+  interest->setInterestLifetime(time::milliseconds(100));
+  face.receive(*interest);
+  face.receive(*makeInterest(Name(versionedPrefix).appendSegment(6)));
+  // too far ahead of the input
+  face.receive(*makeInterest(Name(versionedPrefix).appendSegment(100000)));
+  BOOST_CHECK_EQUAL(producer.m_pendingInterests.size(), 2);
+
+  // the expired Interest for a later segment is dropped when a segment is produced
+  advanceClocks(io, time::milliseconds(200));
+  std::string input(maxSegmentSize, 'a');
+  BOOST_REQUIRE_EQUAL(::write(fds[1], input.data(), input.size()),
+                      static_cast<ssize_t>(input.size()));
+  io.poll();
+  BOOST_CHECK_EQUAL(producer.m_store.size(), 1);
+  BOOST_REQUIRE_EQUAL(producer.m_pendingInterests.size(), 1);
+  BOOST_CHECK_EQUAL(producer.m_pendingInterests.begin()->first, 6);
+
+  ::close(fds[1]);
+  io.poll();
+  BOOST_CHECK_EQUAL(producer.m_pendingInterests.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(StreamingWindow)
+{
+  boost::asio::io_service io;
+  util::DummyClientFace face(io, {true, true});
+  KeyChain keyChain;
+  security::SigningInfo signingInfo;
+  Name versionedPrefix = Name("/ndn/chunks/test").appendVersion(1449227841747);
+  size_t maxSegmentSize(40);
+
+  int fds[2];
+  BOOST_REQUIRE_EQUAL(::pipe(fds), 0);
+  Producer producer(versionedPrefix, face, keyChain, signingInfo, time::seconds(10),
+                    maxSegmentSize, false, false, fds[0], 2);
+  io.poll();
+
+  std::string input(3 * maxSegmentSize, 'a');
+  BOOST_REQUIRE_EQUAL(::write(fds[1], input.data(), input.size()),
+                      static_cast<ssize_t>(input.size()));
+  io.poll();
+
+  // only the last two segments are kept
+  BOOST_CHECK_EQUAL(producer.m_store.size(), 2);
+  BOOST_CHECK_EQUAL(producer.m_firstStoredSegmentNo, 1);
+
+  face.receive(*makeInterest(Name(versionedPrefix).appendSegment(0)));
+  io.poll();
+  BOOST_CHECK_EQUAL(face.sentData.size(), 0);
+  BOOST_CHECK_EQUAL(producer.m_pendingInterests.size(), 0);
+
+  face.receive(*makeInterest(Name(versionedPrefix).appendSegment(2)));
+  io.poll();
+  BOOST_REQUIRE_EQUAL(face.sentData.size(), 1);
+  BOOST_CHECK_EQUAL(face.sentData[0].getName(), Name(versionedPrefix).appendSegment(2));
+
+  // the empty last segment evicts segment #1
+  ::close(fds[1]);
+  io.poll();
+  BOOST_CHECK_EQUAL(producer.m_store.size(), 2);
+  BOOST_CHECK_EQUAL(producer.m_firstStoredSegmentNo, 2);
+
+  face.receive(*makeInterest(Name(versionedPrefix).appendSegment(3)));
+  io.poll();
+  BOOST_REQUIRE_EQUAL(face.sentData.size(), 2);
+  BOOST_REQUIRE(!face.sentData[1].getFinalBlockId().empty());
+  BOOST_CHECK_EQUAL(face.sentData[1].getFinalBlockId().toSegment(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(StreamingReadError)
+{
+  boost::asio::io_service io;
+  util::DummyClientFace face(io, {true, true});
+  KeyChain keyChain;
+  security::SigningInfo signingInfo;
+  Name versionedPrefix = Name("/ndn/chunks/test").appendVersion(1449227841747);
+
+  // reading a directory fails with EISDIR
+  int fd = ::open(".", O_RDONLY | O_DIRECTORY);
+  BOOST_REQUIRE_GE(fd, 0);
+  Producer producer(versionedPrefix, face, keyChain, signingInfo, time::seconds(10),
+                    40, false, false, fd);
+  face.receive(*makeInterest(Name(versionedPrefix).appendSegment(0)));
+
+  // nothing is published as the end of the content
+  BOOST_CHECK_THROW(io.poll(), Producer::Error);
+  BOOST_CHECK_EQUAL(face.sentData.size(), 0);
+  BOOST_CHECK_EQUAL(producer.m_store.size(), 0);
+  BOOST_CHECK_EQUAL(producer.m_pendingInterests.size(), 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END() // TestProducer
 BOOST_AUTO_TEST_SUITE_END() // Chunks
 
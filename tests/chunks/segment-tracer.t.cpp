@@ -0,0 +1,102 @@
+/**
+ * Copyright (c) 2016,  Arizona Board of Regents.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ *
+ * @author Teng Liang
+ */
+
+
+#include "tools/chunks/catchunks/segment-tracer.hpp"
+
+#include "tests/test-common.hpp"
+
+namespace ndn {
+namespace chunks {
+namespace tests {
+
+using namespace ndn::tests;
+
+BOOST_AUTO_TEST_SUITE(Chunks)
+BOOST_FIXTURE_TEST_SUITE(TestSegmentTracer, UnitTestTimeFixture)
+
+BOOST_AUTO_TEST_CASE(Dump)
+{
+  SegmentTracer tracer(16);
+  auto start = time::steady_clock::now();
+
+  tracer.record(1, SegmentTracer::INTEREST_SENT, start + time::milliseconds(1));
+  tracer.record(2, SegmentTracer::INTEREST_SENT, start + time::milliseconds(1));
+  tracer.record(2, SegmentTracer::DATA_RECEIVED, start + time::milliseconds(11));
+  tracer.record(2, SegmentTracer::DATA_VALIDATED, start + time::milliseconds(12));
+  tracer.record(1, SegmentTracer::INTEREST_RETRANSMITTED, start + time::milliseconds(201));
+  tracer.record(1, SegmentTracer::INTEREST_RETRANSMITTED, start + time::milliseconds(601));
+  tracer.record(1, SegmentTracer::DATA_RECEIVED, start + time::milliseconds(611));
+  tracer.record(1, SegmentTracer::DATA_VALIDATED, start + time::milliseconds(612));
+  tracer.record(1, SegmentTracer::DATA_WRITTEN, start + time::milliseconds(612));
+  tracer.record(2, SegmentTracer::DATA_WRITTEN, start + time::milliseconds(612));
+  BOOST_CHECK_EQUAL(tracer.getNEvents(), 10);
+
+  std::ostringstream os;
+  tracer.dump(os);
+  BOOST_CHECK_EQUAL(os.str(),
+                    "segment\tsent\treceived\tvalidated\twritten\tnretx\tretx\n"
+                    "1\t1000\t611000\t612000\t612000\t2\t201000,601000\n"
+                    "2\t1000\t11000\t12000\t612000\t0\t-\n");
+}
+
+BOOST_AUTO_TEST_CASE(Summary)
+{
+  SegmentTracer tracer(1000);
+  auto start = time::steady_clock::now();
+
+  // 100 segments, the network latency of segment i is i ms
+  for (uint64_t i = 1; i <= 100; ++i) {
+    tracer.record(i, SegmentTracer::INTEREST_SENT, start);
+    tracer.record(i, SegmentTracer::DATA_RECEIVED, start + time::milliseconds(i));
+    tracer.record(i, SegmentTracer::DATA_VALIDATED, start + time::milliseconds(i));
+  }
+
+  std::ostringstream os;
+  tracer.printSummary(os);
+  BOOST_CHECK_EQUAL(os.str(),
+                    "Segment latency per stage (ms):\n"
+                    "  stage             segments         p50         p99\n"
+                    "  network                100      51.000      99.000\n"
+                    "  validation             100       0.000       0.000\n"
+                    "  reorder+output           0           -           -\n"
+                    "  total                    0           -           -\n");
+}
+
+BOOST_AUTO_TEST_CASE(Preallocated)
+{
+  SegmentTracer tracer(2);
+  auto now = time::steady_clock::now();
+  tracer.record(0, SegmentTracer::INTEREST_SENT, now);
+  tracer.record(0, SegmentTracer::DATA_RECEIVED, now);
+  tracer.record(0, SegmentTracer::DATA_VALIDATED, now);
+
+  BOOST_CHECK_EQUAL(tracer.getNEvents(), 2);
+  BOOST_CHECK_EQUAL(tracer.getNDroppedEvents(), 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestSegmentTracer
+BOOST_AUTO_TEST_SUITE_END() // Chunks
+
+} // namespace tests
+} // namespace chunks
+} // namespace ndn
@@ -0,0 +1,74 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "tools/chunks/catchunks/streaming-quantile.hpp"
+
+#include "tests/test-common.hpp"
+
+namespace ndn {
+namespace chunks {
+namespace tests {
+
+BOOST_AUTO_TEST_SUITE(Chunks)
+BOOST_AUTO_TEST_SUITE(TestStreamingQuantile)
+
+BOOST_AUTO_TEST_CASE(FewSamples)
+{
+  StreamingQuantile median(0.5);
+  BOOST_CHECK(std::isnan(median.get()));
+
+  // exact value until the markers are initialized
+  median.add(30);
+  BOOST_CHECK_EQUAL(median.get(), 30);
+  median.add(10);
+  median.add(20);
+  BOOST_CHECK_EQUAL(median.get(), 20);
+  BOOST_CHECK_EQUAL(median.size(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(ManySamples)
+{
+  StreamingQuantile p50(0.5);
+  StreamingQuantile p90(0.9);
+  StreamingQuantile p99(0.99);
+
+  // 1..10000 in scrambled order
+  for (uint64_t i = 0; i < 10000; ++i) {
+    double x = (i * 7919) % 10000 + 1;
+    p50.add(x);
+    p90.add(x);
+    p99.add(x);
+  }
+
+  BOOST_CHECK_EQUAL(p50.size(), 10000);
+  BOOST_CHECK_CLOSE(p50.get(), 5000, 1);
+  BOOST_CHECK_CLOSE(p90.get(), 9000, 1);
+  BOOST_CHECK_CLOSE(p99.get(), 9900, 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestStreamingQuantile
+BOOST_AUTO_TEST_SUITE_END() // Chunks
+
+} // namespace tests
+} // namespace chunks
+} // namespace ndn
@@ -0,0 +1,203 @@
+/**
+ * Copyright (c) 2016,  Arizona Board of Regents.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ *
+ * @author Teng Liang
+ */
+
+
+#include "tools/chunks/catchunks/telemetry-reporter.hpp"
+
+#include "tests/test-common.hpp"
+#include <ndn-cxx/util/dummy-client-face.hpp>
+#include <ndn-cxx/security/validator-null.hpp>
+
+#include <boost/test/output_test_stream.hpp>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace ndn {
+namespace chunks {
+namespace tests {
+
+using namespace ndn::tests;
+using boost::test_tools::output_test_stream;
+
+class TelemetryReporterFixture : public UnitTestTimeFixture
+{
+protected:
+  TelemetryReporterFixture()
+    : face(io)
+    , consumer(validator, false, output)
+  {
+    BOOST_REQUIRE_EQUAL(::pipe(fds), 0);
+    BOOST_REQUIRE_EQUAL(::fcntl(fds[0], F_SETFL, O_NONBLOCK), 0);
+  }
+
+  ~TelemetryReporterFixture()
+  {
+    ::close(fds[0]);
+    ::close(fds[1]);
+  }
+
+  void
+  addSegment(uint64_t segmentNo, size_t size, uint64_t lastSegmentNo)
+  {
+    auto data = makeData(Name("/ndn/chunks/test").appendVersion(1).appendSegment(segmentNo));
+    std::string content(size, 'a');
+    data->setContent(reinterpret_cast<const uint8_t*>(content.data()), content.size());
+    data->setFinalBlockId(name::Component::fromSegment(lastSegmentNo));
+    consumer.bufferData(data);
+    consumer.writeInOrderData();
+  }
+
+  std::string
+  readReports()
+  {
+    std::string reports;
+    char buf[4096];
+    ssize_t n;
+    while ((n = ::read(fds[0], buf, sizeof(buf))) > 0)
+      reports.append(buf, n);
+    return reports;
+  }
+
+protected:
+  boost::asio::io_service io;
+  util::DummyClientFace face;
+  ValidatorNull validator;
+  output_test_stream output;
+  Consumer consumer;
+  int fds[2];
+};
+
+BOOST_AUTO_TEST_SUITE(Chunks)
+BOOST_FIXTURE_TEST_SUITE(TestTelemetryReporter, TelemetryReporterFixture)
+
+BOOST_AUTO_TEST_CASE(Report)
+{
+  TelemetryReporter reporter(face, consumer, fds[1], time::seconds(1));
+  reporter.start();
+
+  addSegment(0, 1000, 3);
+  addSegment(2, 500, 3);
+
+  std::string report = reporter.makeReport(time::steady_clock::now() + time::seconds(1));
+  BOOST_CHECK_EQUAL(report,
+                    "{\"elapsed_s\":1,\"goodput_mbps\":0.008,\"cwnd\":0,\"in_flight\":0,"
+                    "\"srtt_ms\":null,\"rto_ms\":null,\"retransmissions\":0,\"received_segments\":0,"
+                    "\"reorder_buffer_segments\":1,\"reorder_buffer_bytes\":500,"
+                    "\"written_bytes\":1000,\"complete_percent\":null,\"done\":false}\n");
+}
+
+BOOST_AUTO_TEST_CASE(Periodic)
+{
+  TelemetryReporter reporter(face, consumer, fds[1], time::milliseconds(100));
+  reporter.start();
+
+  advanceClocks(io, time::milliseconds(10), 25);
+  std::string reports = readReports();
+  BOOST_CHECK_EQUAL(std::count(reports.begin(), reports.end(), '\n'), 2);
+
+  // the last report announces the completion, then reporting stops
+  consumer.m_lastSegmentNo = 0;
+  consumer.m_hasLastSegment = true;
+  addSegment(0, 100, 0);
+  advanceClocks(io, time::milliseconds(10), 100);
+  reports = readReports();
+  BOOST_CHECK_EQUAL(std::count(reports.begin(), reports.end(), '\n'), 1);
+  BOOST_CHECK(reports.find("\"complete_percent\":100,\"done\":true}") != std::string::npos);
+  BOOST_CHECK_EQUAL(reporter.getNDroppedReports(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(CompletionEndsReporting)
+{
+  TelemetryReporter reporter(face, consumer, fds[1], time::seconds(60));
+  reporter.start();
+  advanceClocks(io, time::milliseconds(10), 1);
+  BOOST_CHECK_EQUAL(readReports(), "");
+
+  // the next report is pending on the event loop
+  io.reset();
+  io.poll();
+  BOOST_CHECK_EQUAL(io.stopped(), false);
+
+  // the completion is reported right away, and leaves nothing on the event loop
+  consumer.m_lastSegmentNo = 0;
+  consumer.m_hasLastSegment = true;
+  consumer.bufferData(makeData(Name("/ndn/chunks/test").appendVersion(1).appendSegment(0)));
+  consumer.processBufferedData();
+  std::string reports = readReports();
+  BOOST_CHECK_EQUAL(std::count(reports.begin(), reports.end(), '\n'), 1);
+  BOOST_CHECK(reports.find("\"done\":true}") != std::string::npos);
+
+  io.reset();
+  io.poll();
+  BOOST_CHECK_EQUAL(io.stopped(), true);
+}
+
+BOOST_AUTO_TEST_CASE(PartialWrite)
+{
+  // fill the pipe, then make room for one page only
+  int flags = ::fcntl(fds[1], F_GETFL);
+  BOOST_REQUIRE_EQUAL(::fcntl(fds[1], F_SETFL, flags | O_NONBLOCK), 0);
+  char filler[4096] = {};
+  while (::write(fds[1], filler, sizeof(filler)) > 0)
+    ;
+  BOOST_REQUIRE_EQUAL(::fcntl(fds[1], F_SETFL, flags), 0);
+  BOOST_REQUIRE_EQUAL(::read(fds[0], filler, sizeof(filler)), sizeof(filler));
+
+  // the descriptor stays in blocking mode, yet no write blocks
+  TelemetryReporter reporter(face, consumer, fds[1], time::seconds(1));
+  BOOST_CHECK_EQUAL(::fcntl(fds[1], F_GETFL) & O_NONBLOCK, 0);
+
+  std::string line(6000, 'x');
+  line.back() = '\n';
+  BOOST_CHECK_EQUAL(reporter.writeReport(line), true);
+  BOOST_CHECK_EQUAL(reporter.getNDroppedReports(), 0);
+
+  // the rest of the first line does not fit, so the second line is dropped entirely
+  BOOST_CHECK_EQUAL(reporter.writeReport("second\n"), true);
+  BOOST_CHECK_EQUAL(reporter.getNDroppedReports(), 1);
+
+  // the page that received the start of the first line is read along with the filler
+  readReports();
+  BOOST_CHECK_EQUAL(reporter.writeReport("third\n"), true);
+  BOOST_CHECK_EQUAL(readReports(), line.substr(4096) + "third\n");
+  BOOST_CHECK_EQUAL(reporter.getNDroppedReports(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(ClosedReader)
+{
+  TelemetryReporter reporter(face, consumer, fds[1], time::milliseconds(100));
+  reporter.start();
+
+  // without SIGPIPE suppression, this would kill the test process
+  ::close(fds[0]);
+  fds[0] = ::open("/dev/null", O_RDONLY);
+  advanceClocks(io, time::milliseconds(10), 25);
+  BOOST_CHECK_EQUAL(reporter.writeReport("line\n"), false);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestTelemetryReporter
+BOOST_AUTO_TEST_SUITE_END() // Chunks
+
+} // namespace tests
+} // namespace chunks
+} // namespace ndn
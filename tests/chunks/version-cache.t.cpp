@@ -0,0 +1,172 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "tools/chunks/catchunks/version-cache.hpp"
+
+#include "tests/test-common.hpp"
+
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+
+#include <sys/stat.h>
+
+namespace ndn {
+namespace chunks {
+namespace tests {
+
+using namespace ndn::tests;
+
+class VersionCacheFixture : public UnitTestTimeFixture
+{
+protected:
+  VersionCacheFixture()
+    : tmpPath(boost::filesystem::path(TMP_TESTS_PATH) / "VersionCache")
+    , path((tmpPath / "version-cache").string())
+  {
+    boost::filesystem::remove_all(tmpPath);
+    boost::filesystem::create_directories(tmpPath);
+  }
+
+  ~VersionCacheFixture()
+  {
+    boost::filesystem::remove_all(tmpPath);
+  }
+
+protected:
+  const boost::filesystem::path tmpPath;
+  const std::string path;
+};
+
+BOOST_AUTO_TEST_SUITE(Chunks)
+BOOST_FIXTURE_TEST_SUITE(TestVersionCache, VersionCacheFixture)
+
+BOOST_AUTO_TEST_CASE(FindAndExpire)
+{
+  VersionCache cache(path, time::seconds(60));
+  uint64_t version = 0;
+  BOOST_CHECK_EQUAL(cache.find("/ndn/chunks/test", version), false);
+
+  cache.insert("/ndn/chunks/test", 1449241767037);
+  BOOST_CHECK_EQUAL(cache.find("/ndn/chunks/test", version), true);
+  BOOST_CHECK_EQUAL(version, 1449241767037);
+  BOOST_CHECK_EQUAL(cache.find("/ndn/chunks", version), false);
+
+  systemClock->advance(time::seconds(59));
+  BOOST_CHECK_EQUAL(cache.find("/ndn/chunks/test", version), true);
+
+  systemClock->advance(time::seconds(1));
+  BOOST_CHECK_EQUAL(cache.find("/ndn/chunks/test", version), false);
+}
+
+BOOST_AUTO_TEST_CASE(SaveAndLoad)
+{
+  VersionCache cache(path, time::seconds(60));
+  cache.load(); // missing file
+  cache.insert("/ndn/chunks/a", 1);
+  systemClock->advance(time::seconds(30));
+  cache.insert("/ndn/chunks/b", 2);
+  BOOST_REQUIRE(cache.save());
+
+  {
+    std::ofstream os(path, std::ios::app);
+    os << "malformed line\n";
+  }
+
+  VersionCache loaded(path, time::seconds(60));
+  loaded.load();
+  uint64_t version = 0;
+  BOOST_CHECK_EQUAL(loaded.find("/ndn/chunks/a", version), true);
+  BOOST_CHECK_EQUAL(version, 1);
+  BOOST_CHECK_EQUAL(loaded.find("/ndn/chunks/b", version), true);
+  BOOST_CHECK_EQUAL(version, 2);
+
+  // the entries keep their original discovery time
+  systemClock->advance(time::seconds(30));
+  loaded.load();
+  BOOST_CHECK_EQUAL(loaded.find("/ndn/chunks/a", version), false);
+  BOOST_CHECK_EQUAL(loaded.find("/ndn/chunks/b", version), true);
+}
+
+BOOST_AUTO_TEST_CASE(SaveKeepsMode)
+{
+  mode_t mask = ::umask(022);
+  VersionCache cache(path, time::seconds(60));
+  cache.insert("/ndn/chunks/a", 1);
+  BOOST_REQUIRE(cache.save());
+
+  // a new cache is created with the default mode
+  struct stat st;
+  BOOST_REQUIRE_EQUAL(::stat(path.c_str(), &st), 0);
+  BOOST_CHECK_EQUAL(st.st_mode & 07777, 0644);
+
+  // the mode of an existing cache is kept
+  BOOST_REQUIRE_EQUAL(::chmod(path.c_str(), 0664), 0);
+  cache.insert("/ndn/chunks/b", 2);
+  BOOST_REQUIRE(cache.save());
+  BOOST_REQUIRE_EQUAL(::stat(path.c_str(), &st), 0);
+  BOOST_CHECK_EQUAL(st.st_mode & 07777, 0664);
+
+  ::umask(mask);
+}
+
+BOOST_AUTO_TEST_CASE(ConcurrentSave)
+{
+  VersionCache cache1(path, time::seconds(60));
+  VersionCache cache2(path, time::seconds(60));
+  cache1.load();
+  cache2.load();
+
+  cache1.insert("/ndn/chunks/a", 1);
+  cache1.insert("/ndn/chunks/c", 3);
+  BOOST_REQUIRE(cache1.save());
+
+  // cache2 was loaded before cache1 saved its entries, which are kept
+  systemClock->advance(time::seconds(1));
+  cache2.insert("/ndn/chunks/b", 2);
+  cache2.insert("/ndn/chunks/c", 4);
+  BOOST_REQUIRE(cache2.save());
+
+  VersionCache loaded(path, time::seconds(60));
+  loaded.load();
+  uint64_t version = 0;
+  BOOST_CHECK_EQUAL(loaded.find("/ndn/chunks/a", version), true);
+  BOOST_CHECK_EQUAL(version, 1);
+  BOOST_CHECK_EQUAL(loaded.find("/ndn/chunks/b", version), true);
+  BOOST_CHECK_EQUAL(version, 2);
+  BOOST_CHECK_EQUAL(loaded.find("/ndn/chunks/c", version), true);
+  BOOST_CHECK_EQUAL(version, 4);
+
+  // an older discovery does not overwrite a newer one
+  BOOST_REQUIRE(cache1.save());
+  loaded.load();
+  BOOST_CHECK_EQUAL(loaded.find("/ndn/chunks/c", version), true);
+  BOOST_CHECK_EQUAL(version, 4);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestVersionCache
+BOOST_AUTO_TEST_SUITE_END() // Chunks
+
+} // namespace tests
+} // namespace chunks
+} // namespace ndn
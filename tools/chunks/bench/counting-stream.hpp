@@ -0,0 +1,88 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#ifndef NDN_TOOLS_CHUNKS_BENCH_COUNTING_STREAM_HPP
+#define NDN_TOOLS_CHUNKS_BENCH_COUNTING_STREAM_HPP
+
+#include "core/common.hpp"
+
+#include <ostream>
+#include <streambuf>
+
+namespace ndn {
+namespace chunks {
+namespace bench {
+
+/**
+ * @brief Output stream that discards what is written to it and only counts the bytes
+ *
+ * Used as the output of the Consumer, so that writing the retrieved object costs nothing.
+ */
+class CountingStream : public std::ostream
+{
+public:
+  CountingStream()
+    : std::ostream(&m_buf)
+  {
+  }
+
+  /**
+   * @return number of bytes written to the stream
+   */
+  uint64_t
+  getCount() const
+  {
+    return m_buf.count;
+  }
+
+private:
+  class CountingBuf : public std::streambuf
+  {
+  public:
+    uint64_t count = 0;
+
+  protected:
+    int_type
+    overflow(int_type ch) final
+    {
+      if (!traits_type::eq_int_type(ch, traits_type::eof()))
+        ++count;
+      return traits_type::not_eof(ch);
+    }
+
+    std::streamsize
+    xsputn(const char_type* s, std::streamsize n) final
+    {
+      count += n;
+      return n;
+    }
+  };
+
+  CountingBuf m_buf;
+};
+
+} // namespace bench
+} // namespace chunks
+} // namespace ndn
+
+#endif // NDN_TOOLS_CHUNKS_BENCH_COUNTING_STREAM_HPP
@@ -0,0 +1,83 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "emulated-transfer.hpp"
+#include "counting-stream.hpp"
+#include "tools/chunks/catchunks/consumer.hpp"
+#include "tools/chunks/catchunks/discover-version-fixed.hpp"
+
+#include <ndn-cxx/security/validator-null.hpp>
+
+namespace ndn {
+namespace chunks {
+namespace bench {
+
+EmulationResult
+runEmulatedTransfer(const EmulationParameters& emulation, const PipelineParameters& params,
+                    const chunks::Options& options,
+                    const function<void(PipelineSetup&)>& beforeTransfer)
+{
+  NetworkEmulator emulator(emulation.path, emulation.seed);
+  Name prefix("/bench/object");
+  prefix.appendVersion(1);
+  emulator.setContent(prefix, emulation.objectSize, emulation.segmentSize);
+
+  PipelineSetup setup(emulator.getFace(), params);
+  if (beforeTransfer)
+    beforeTransfer(setup);
+
+  CountingStream output;
+  ValidatorNull validator;
+  Consumer consumer(validator, options.isVerbose, output);
+  consumer.run(make_unique<DiscoverVersionFixed>(prefix, emulator.getFace(), options),
+               setup.releasePipeline());
+
+  uint64_t objectSize = emulation.objectSize;
+  EmulationResult result;
+  result.isComplete = emulator.run([&output, objectSize] { return output.getCount() >= objectSize; },
+                                   emulation.tick, emulation.timeLimit);
+  result.nBytes = output.getCount();
+  result.duration = emulator.getElapsedTime();
+  result.nServedSegments = emulator.getNServedSegments();
+  result.nLossEvents = setup.getNLossEvents();
+  if (setup.getRttEstimator() != nullptr)
+    result.rttP50 = setup.getRttEstimator()->getRttP50().count();
+  for (const auto& link : emulator.getForwardPath())
+    result.forwardPath.push_back(link->getCounters());
+  for (const auto& link : emulator.getReversePath())
+    result.reversePath.push_back(link->getCounters());
+  return result;
+}
+
+double
+getPropagationRtt(const std::vector<LinkProfile>& path)
+{
+  time::nanoseconds delay = time::nanoseconds::zero();
+  for (const auto& link : path)
+    delay += link.delay;
+  return 2 * time::duration_cast<time::duration<double, time::milliseconds::period>>(delay).count();
+}
+
+} // namespace bench
+} // namespace chunks
+} // namespace ndn
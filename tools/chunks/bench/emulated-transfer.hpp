@@ -0,0 +1,89 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#ifndef NDN_TOOLS_CHUNKS_BENCH_EMULATED_TRANSFER_HPP
+#define NDN_TOOLS_CHUNKS_BENCH_EMULATED_TRANSFER_HPP
+
+#include "network-emulator.hpp"
+#include "pipeline-setup.hpp"
+
+#include <limits>
+
+namespace ndn {
+namespace chunks {
+namespace bench {
+
+/**
+ * @brief Network and object of an emulated transfer
+ */
+struct EmulationParameters
+{
+  std::vector<LinkProfile> path; ///< links from the consumer to the producer
+  uint32_t seed = 1; ///< seed of the random losses
+  uint64_t objectSize = 10 * 1024 * 1024; ///< size of the object (bytes)
+  size_t segmentSize = 4400; ///< payload size of each segment (bytes)
+  time::nanoseconds tick = time::microseconds(100); ///< granularity of the virtual time
+  time::nanoseconds timeLimit = time::seconds(600); ///< maximum virtual duration of the transfer
+};
+
+/**
+ * @brief Outcome of an emulated transfer
+ */
+struct EmulationResult
+{
+  bool isComplete = false; ///< whether the whole object has been received
+  uint64_t nBytes = 0; ///< bytes written out by the Consumer
+  time::nanoseconds duration = time::nanoseconds::zero(); ///< virtual duration of the transfer
+  uint64_t nServedSegments = 0; ///< Data sent by the producer, including retransmissions
+  uint64_t nLossEvents = 0; ///< loss events seen by the pipeline
+  double rttP50 = std::numeric_limits<double>::quiet_NaN(); ///< median RTT (ms), NaN if not measured
+  std::vector<LinkCounters> forwardPath;
+  std::vector<LinkCounters> reversePath;
+};
+
+/**
+ * @brief retrieve an object over an emulated network
+ *
+ * @param emulation the network and the object
+ * @param params the pipeline used by the Consumer
+ * @param options the options of the version discovery
+ * @param beforeTransfer invoked with the pipeline before the transfer starts, e.g. to enable
+ *                      its statistics
+ */
+EmulationResult
+runEmulatedTransfer(const EmulationParameters& emulation, const PipelineParameters& params,
+                    const chunks::Options& options,
+                    const function<void(PipelineSetup&)>& beforeTransfer = nullptr);
+
+/**
+ * @return the sum of the one-way delays of @p path times two, i.e. the RTT without queueing
+ *         nor transmission delays (ms)
+ */
+double
+getPropagationRtt(const std::vector<LinkProfile>& path);
+
+} // namespace bench
+} // namespace chunks
+} // namespace ndn
+
+#endif // NDN_TOOLS_CHUNKS_BENCH_EMULATED_TRANSFER_HPP
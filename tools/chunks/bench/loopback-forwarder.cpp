@@ -0,0 +1,54 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "loopback-forwarder.hpp"
+
+namespace ndn {
+namespace chunks {
+namespace bench {
+
+LoopbackForwarder::LoopbackForwarder(boost::asio::io_service& io)
+  : m_io(io)
+  , m_consumerFace(io, util::DummyClientFace::Options{false, false})
+  , m_producerFace(io, util::DummyClientFace::Options{false, true})
+{
+  m_consumerFace.onSendInterest.connect([this] (const Interest& interest) {
+    m_counters.nInterests++;
+    m_io.post([this, interest] { m_producerFace.receive(interest); });
+  });
+
+  m_producerFace.onSendData.connect([this] (const Data& data) {
+    m_counters.nData++;
+    m_counters.nDataBytes += data.wireEncode().size();
+    m_io.post([this, data] { m_consumerFace.receive(data); });
+  });
+
+  m_producerFace.onSendNack.connect([this] (const lp::Nack& nack) {
+    m_counters.nNacks++;
+    m_io.post([this, nack] { m_consumerFace.receive(nack); });
+  });
+}
+
+} // namespace bench
+} // namespace chunks
+} // namespace ndn
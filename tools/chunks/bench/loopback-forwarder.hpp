@@ -0,0 +1,93 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#ifndef NDN_TOOLS_CHUNKS_BENCH_LOOPBACK_FORWARDER_HPP
+#define NDN_TOOLS_CHUNKS_BENCH_LOOPBACK_FORWARDER_HPP
+
+#include "core/common.hpp"
+
+#include <ndn-cxx/util/dummy-client-face.hpp>
+
+namespace ndn {
+namespace chunks {
+namespace bench {
+
+/**
+ * @brief Counters of the packets exchanged through a LoopbackForwarder
+ */
+struct LoopbackCounters
+{
+  uint64_t nInterests = 0;
+  uint64_t nData = 0;
+  uint64_t nNacks = 0;
+  uint64_t nDataBytes = 0; ///< size of the encoded Data
+};
+
+/**
+ * @brief Minimal stand-in for a forwarder, connecting a consumer and a producer in one process
+ *
+ * Both ends are DummyClientFaces on the same io_service. Interests expressed on the consumer
+ * Face are received by the producer Face, and Data and Nacks put on the producer Face are
+ * received by the consumer Face. Prefix registrations are answered successfully, so that
+ * Producer can be used as is. There are no tables and no caching: the cost measured through
+ * the loopback is only the cost of the tools and of ndn-cxx.
+ *
+ * Packets are handed over through the io_service instead of synchronously, as they would be by
+ * a real transport, so that a sender never reenters the receiver.
+ */
+class LoopbackForwarder : noncopyable
+{
+public:
+  explicit
+  LoopbackForwarder(boost::asio::io_service& io);
+
+  Face&
+  getConsumerFace()
+  {
+    return m_consumerFace;
+  }
+
+  Face&
+  getProducerFace()
+  {
+    return m_producerFace;
+  }
+
+  const LoopbackCounters&
+  getCounters() const
+  {
+    return m_counters;
+  }
+
+private:
+  boost::asio::io_service& m_io;
+  util::DummyClientFace m_consumerFace;
+  util::DummyClientFace m_producerFace;
+  LoopbackCounters m_counters;
+};
+
+} // namespace bench
+} // namespace chunks
+} // namespace ndn
+
+#endif // NDN_TOOLS_CHUNKS_BENCH_LOOPBACK_FORWARDER_HPP
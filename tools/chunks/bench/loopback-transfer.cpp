@@ -0,0 +1,155 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "loopback-transfer.hpp"
+#include "counting-stream.hpp"
+#include "object-stream.hpp"
+#include "tools/chunks/catchunks/consumer.hpp"
+#include "tools/chunks/catchunks/discover-version-fixed.hpp"
+#include "tools/chunks/putchunks/producer.hpp"
+
+#include <ndn-cxx/security/signing-helpers.hpp>
+#include <ndn-cxx/security/validator-null.hpp>
+
+namespace ndn {
+namespace chunks {
+namespace bench {
+
+/**
+ * @brief Producer stand-in that generates and signs each segment when it is requested
+ *
+ * Unlike Producer, it does not hold the object in memory, so that objects too large to load can
+ * be transferred. The content is the pattern of ObjectStream.
+ */
+class SegmentGenerator : noncopyable
+{
+public:
+  SegmentGenerator(const Name& versionedPrefix, Face& face, KeyChain& keyChain,
+                   uint64_t objectSize, size_t segmentSize)
+    : m_versionedPrefix(versionedPrefix)
+    , m_face(face)
+    , m_keyChain(keyChain)
+    , m_objectSize(objectSize)
+    , m_segmentSize(segmentSize)
+    , m_nSegments(std::max<uint64_t>(1, (objectSize + segmentSize - 1) / segmentSize))
+    , m_buffer(segmentSize)
+  {
+    m_face.setInterestFilter(m_versionedPrefix.getPrefix(-1),
+                             bind(&SegmentGenerator::onInterest, this, _2),
+                             RegisterPrefixSuccessCallback(),
+                             [] (const Name& prefix, const std::string& reason) {
+                               throw std::runtime_error("cannot register " + prefix.toUri() +
+                                                        ": " + reason);
+                             });
+  }
+
+private:
+  void
+  onInterest(const Interest& interest)
+  {
+    const Name& name = interest.getName();
+    uint64_t segmentNo = 0;
+    if (name.size() == m_versionedPrefix.size() + 1 && m_versionedPrefix.isPrefixOf(name) &&
+        name[-1].isSegment())
+      segmentNo = name[-1].toSegment();
+    else if (!name.isPrefixOf(m_versionedPrefix))
+      return;
+
+    if (segmentNo >= m_nSegments)
+      return;
+
+    // the same bytes as ObjectStream, whose pattern repeats every 65536 bytes
+    uint64_t offset = segmentNo * m_segmentSize;
+    size_t size = static_cast<size_t>(std::min<uint64_t>(m_segmentSize, m_objectSize - offset));
+    for (size_t i = 0; i < size; ++i)
+      m_buffer[i] = static_cast<uint8_t>('a' + (offset + i) % 65536 % 26);
+
+    Data data(Name(m_versionedPrefix).appendSegment(segmentNo));
+    data.setFreshnessPeriod(time::seconds(10));
+    data.setContent(m_buffer.data(), size);
+    data.setFinalBlockId(name::Component::fromSegment(m_nSegments - 1));
+    m_keyChain.sign(data, security::signingWithSha256());
+    m_face.put(data);
+  }
+
+private:
+  const Name m_versionedPrefix;
+  Face& m_face;
+  KeyChain& m_keyChain;
+  const uint64_t m_objectSize;
+  const size_t m_segmentSize;
+  const uint64_t m_nSegments;
+  std::vector<uint8_t> m_buffer;
+};
+
+TransferResult
+runLoopbackTransfer(const PipelineParameters& params, const chunks::Options& options,
+                    uint64_t objectSize, size_t segmentSize, bool isGenerated,
+                    const function<void()>& beforeTransfer)
+{
+  boost::asio::io_service io;
+  LoopbackForwarder forwarder(io);
+
+  // segments are signed with a plain digest, the cost of RSA signing is not of interest here
+  KeyChain keyChain("pib-memory:", "tpm-memory:");
+  Name prefix("/bench/object");
+  prefix.appendVersion(1);
+  unique_ptr<Producer> producer;
+  unique_ptr<SegmentGenerator> generator;
+  if (isGenerated) {
+    generator = make_unique<SegmentGenerator>(prefix, forwarder.getProducerFace(), keyChain,
+                                              objectSize, segmentSize);
+  }
+  else {
+    ObjectStream input(objectSize);
+    producer = make_unique<Producer>(prefix, forwarder.getProducerFace(), keyChain,
+                                     security::signingWithSha256(), time::seconds(10), segmentSize,
+                                     false, false, input);
+  }
+
+  PipelineSetup setup(forwarder.getConsumerFace(), params);
+  CountingStream output;
+  ValidatorNull validator;
+  Consumer consumer(validator, options.isVerbose, output);
+
+  if (beforeTransfer)
+    beforeTransfer();
+
+  auto start = time::steady_clock::now();
+  consumer.run(make_unique<DiscoverVersionFixed>(prefix, forwarder.getConsumerFace(), options),
+               setup.releasePipeline());
+  while (output.getCount() < objectSize && io.run_one() > 0) {
+  }
+
+  TransferResult result;
+  result.duration = time::steady_clock::now() - start;
+  result.nBytes = output.getCount();
+  result.isComplete = result.nBytes >= objectSize;
+  result.maxBufferedSegments = consumer.getMaxBufferedSegments();
+  result.counters = forwarder.getCounters();
+  return result;
+}
+
+} // namespace bench
+} // namespace chunks
+} // namespace ndn
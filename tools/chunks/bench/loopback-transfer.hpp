@@ -0,0 +1,70 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#ifndef NDN_TOOLS_CHUNKS_BENCH_LOOPBACK_TRANSFER_HPP
+#define NDN_TOOLS_CHUNKS_BENCH_LOOPBACK_TRANSFER_HPP
+
+#include "loopback-forwarder.hpp"
+#include "pipeline-setup.hpp"
+
+namespace ndn {
+namespace chunks {
+namespace bench {
+
+/**
+ * @brief Outcome of a transfer through a LoopbackForwarder
+ */
+struct TransferResult
+{
+  bool isComplete = false; ///< whether the whole object has been received
+  uint64_t nBytes = 0; ///< bytes written out by the Consumer
+  time::nanoseconds duration = time::nanoseconds::zero(); ///< from the start of the Consumer to the end
+  size_t maxBufferedSegments = 0; ///< high-water mark of the Consumer reorder buffer
+  LoopbackCounters counters;
+};
+
+/**
+ * @brief transfer a generated object from a Producer to a Consumer in this process
+ *
+ * The Producer loads and signs the object before the transfer starts; that time is not part of
+ * TransferResult::duration. If @p isGenerated is true, a stand-in producer generates and signs
+ * each segment when it is requested instead, so that the object is never held in memory; that
+ * time is then part of TransferResult::duration.
+ *
+ * @param params the pipeline used by the Consumer
+ * @param options the options of the version discovery
+ * @param objectSize size of the object (bytes)
+ * @param segmentSize maximum payload size of each segment (bytes)
+ * @param isGenerated whether the segments are generated on demand instead of by a Producer
+ * @param beforeTransfer invoked after the producer is ready and just before the Consumer starts
+ */
+TransferResult
+runLoopbackTransfer(const PipelineParameters& params, const chunks::Options& options,
+                    uint64_t objectSize, size_t segmentSize, bool isGenerated,
+                    const function<void()>& beforeTransfer = nullptr);
+
+} // namespace bench
+} // namespace chunks
+} // namespace ndn
+
+#endif // NDN_TOOLS_CHUNKS_BENCH_LOOPBACK_TRANSFER_HPP
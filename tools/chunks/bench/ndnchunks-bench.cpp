@@ -0,0 +1,341 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "core/version.hpp"
+#include "loopback-transfer.hpp"
+
+#include <boost/algorithm/string/classification.hpp>
+#include <boost/algorithm/string/split.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include <fstream>
+#include <sstream>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace ndn {
+namespace chunks {
+namespace bench {
+
+/**
+ * @brief Measurements of one run, passed from the child process that ran it
+ */
+struct RunRecord
+{
+  bool isComplete;
+  uint64_t nBytes;
+  int64_t durationNs;
+  uint64_t nSegments;
+  int64_t cpuNs; ///< user and system time spent during the transfer
+  int64_t maxRssKb; ///< peak resident set size of the process
+  uint64_t maxBufferedSegments;
+  int64_t transferRssKb; ///< growth of the resident set size during the transfer
+};
+
+static int64_t
+toNanoseconds(const timeval& tv)
+{
+  return static_cast<int64_t>(tv.tv_sec) * 1000000000 + static_cast<int64_t>(tv.tv_usec) * 1000;
+}
+
+static int64_t
+getCpuTime(const rusage& usage)
+{
+  return toNanoseconds(usage.ru_utime) + toNanoseconds(usage.ru_stime);
+}
+
+/**
+ * @return resident set size of the process (unit: kilobyte), -1 if it cannot be obtained
+ */
+static int64_t
+getCurrentRss()
+{
+  std::ifstream statm("/proc/self/statm");
+  int64_t nTotalPages = 0, nResidentPages = 0;
+  if (!(statm >> nTotalPages >> nResidentPages))
+    return -1;
+  return nResidentPages * (::sysconf(_SC_PAGESIZE) / 1024);
+}
+
+/**
+ * @brief reset the peak resident set size of the process to its current value
+ * @return whether the peak has been reset
+ */
+static bool
+resetPeakRss()
+{
+  // supported by Linux since 4.0
+  std::ofstream clearRefs("/proc/self/clear_refs");
+  clearRefs << "5" << std::flush;
+  return clearRefs.good();
+}
+
+/**
+ * @return peak resident set size of the process since the last resetPeakRss (unit: kilobyte),
+ *         -1 if it cannot be obtained
+ */
+static int64_t
+getPeakRssSinceReset()
+{
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    if (line.compare(0, 6, "VmHWM:") == 0) {
+      std::istringstream is(line.substr(6));
+      int64_t peakRss = -1;
+      is >> peakRss;
+      return peakRss;
+    }
+  }
+  return -1;
+}
+
+/**
+ * @brief parse a comma-separated list of sizes, each with an optional K, M or G suffix
+ * @throw std::invalid_argument the list is malformed
+ */
+static std::vector<uint64_t>
+parseSizes(const std::string& str)
+{
+  std::vector<std::string> fields;
+  boost::algorithm::split(fields, str, boost::algorithm::is_any_of(","));
+
+  std::vector<uint64_t> sizes;
+  for (auto field : fields) {
+    uint64_t multiplier = 1;
+    if (!field.empty()) {
+      switch (field.back()) {
+        case 'K': multiplier = 1024; break;
+        case 'M': multiplier = 1024 * 1024; break;
+        case 'G': multiplier = 1024 * 1024 * 1024; break;
+      }
+      if (multiplier > 1)
+        field.pop_back();
+    }
+    try {
+      sizes.push_back(boost::lexical_cast<uint64_t>(field) * multiplier);
+    }
+    catch (const boost::bad_lexical_cast&) {
+      throw std::invalid_argument("malformed size: " + field);
+    }
+    if (sizes.back() == 0)
+      throw std::invalid_argument("sizes must be positive");
+  }
+  return sizes;
+}
+
+/**
+ * @brief run one transfer in a child process
+ *
+ * Running each transfer in its own process gives every run a fresh heap, so that the peak RSS
+ * and the CPU time of a run are not affected by the runs before it.
+ *
+ * @return whether the child process produced a record
+ */
+static bool
+runInChild(const PipelineParameters& params, const chunks::Options& options,
+           uint64_t objectSize, size_t segmentSize, bool isGenerated, RunRecord& record)
+{
+  int fds[2];
+  if (::pipe(fds) != 0)
+    throw std::runtime_error("cannot create pipe");
+
+  pid_t pid = ::fork();
+  if (pid < 0)
+    throw std::runtime_error("cannot fork");
+
+  if (pid == 0) {
+    ::close(fds[0]);
+    int status = 1;
+    try {
+      // the Producer store and the rest of the setup are resident before the transfer starts,
+      // the growth during the transfer is what the Consumer and the pipeline take
+      rusage before;
+      int64_t rssBefore = -1;
+      bool isPeakReset = false;
+      auto result = runLoopbackTransfer(params, options, objectSize, segmentSize, isGenerated,
+                                        [&] {
+                                          ::getrusage(RUSAGE_SELF, &before);
+                                          rssBefore = getCurrentRss();
+                                          isPeakReset = rssBefore >= 0 && resetPeakRss();
+                                        });
+      rusage after;
+      ::getrusage(RUSAGE_SELF, &after);
+      int64_t peakSinceReset = isPeakReset ? getPeakRssSinceReset() : -1;
+
+      RunRecord r;
+      r.isComplete = result.isComplete;
+      r.nBytes = result.nBytes;
+      r.durationNs = result.duration.count();
+      r.nSegments = result.counters.nData;
+      r.cpuNs = getCpuTime(after) - getCpuTime(before);
+      r.maxRssKb = std::max(before.ru_maxrss, after.ru_maxrss);
+      r.maxBufferedSegments = result.maxBufferedSegments;
+      r.transferRssKb = peakSinceReset >= 0 ? std::max<int64_t>(0, peakSinceReset - rssBefore) : -1;
+      if (::write(fds[1], &r, sizeof(r)) == sizeof(r))
+        status = 0;
+    }
+    catch (const std::exception& e) {
+      std::cerr << "ERROR: " << e.what() << std::endl;
+    }
+    ::_exit(status);
+  }
+
+  ::close(fds[1]);
+  ssize_t nRead = ::read(fds[0], &record, sizeof(record));
+  ::close(fds[0]);
+
+  int status = 0;
+  ::waitpid(pid, &status, 0);
+  return nRead == sizeof(record) && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+static int
+main(int argc, char** argv)
+{
+  std::string programName(argv[0]);
+  chunks::Options options;
+  std::string pipelineTypes("fixed,aimd,cubic,tcpbic");
+  std::string objectSizes("1M,100M,1G");
+  std::string segmentSizes("1000,4400,8000");
+  size_t maxPipelineSize(64);
+  std::string outputPath;
+  bool isGenerated(false);
+
+  namespace po = boost::program_options;
+  po::options_description visibleDesc("Options");
+  visibleDesc.add_options()
+    ("help,h",      "print this help message and exit")
+    ("pipeline-types,t", po::value<std::string>(&pipelineTypes)->default_value(pipelineTypes),
+                         "comma-separated list of the Interest pipelines to run")
+    ("sizes",       po::value<std::string>(&objectSizes)->default_value(objectSizes),
+                    "comma-separated list of object sizes, in bytes, with an optional K, M or G suffix")
+    ("segment-sizes", po::value<std::string>(&segmentSizes)->default_value(segmentSizes),
+                      "comma-separated list of segment payload sizes, in bytes")
+    ("pipeline-size,s", po::value<size_t>(&maxPipelineSize)->default_value(maxPipelineSize),
+                        "size of the fixed Interest pipeline")
+    ("generate",    po::bool_switch(&isGenerated),
+                    "generate and sign each segment when it is requested, instead of loading "
+                    "the object into a Producer; the CPU time includes the generation and signing")
+    ("output,o",    po::value<std::string>(&outputPath),
+                    "write the results to this file instead of the standard output")
+    ("version,V",   "print program version and exit")
+    ;
+
+  po::variables_map vm;
+  try {
+    po::store(po::parse_command_line(argc, argv, visibleDesc), vm);
+    po::notify(vm);
+  }
+  catch (const po::error& e) {
+    std::cerr << "ERROR: " << e.what() << std::endl;
+    return 2;
+  }
+
+  if (vm.count("help") > 0) {
+    std::cout << "Usage: " << programName << " [options]" << std::endl;
+    std::cout << visibleDesc;
+    return 0;
+  }
+
+  if (vm.count("version") > 0) {
+    std::cout << "ndnchunks-bench " << tools::VERSION << std::endl;
+    return 0;
+  }
+
+  std::vector<std::string> pipelines;
+  std::vector<uint64_t> sizes, segSizes;
+  try {
+    boost::algorithm::split(pipelines, pipelineTypes, boost::algorithm::is_any_of(","));
+    sizes = parseSizes(objectSizes);
+    segSizes = parseSizes(segmentSizes);
+  }
+  catch (const std::invalid_argument& e) {
+    std::cerr << "ERROR: " << e.what() << std::endl;
+    return 2;
+  }
+
+  std::ofstream outputFile;
+  if (!outputPath.empty()) {
+    outputFile.open(outputPath);
+    if (outputFile.fail()) {
+      std::cerr << "ERROR: failed to open " << outputPath << std::endl;
+      return 4;
+    }
+  }
+  std::ostream& os = outputPath.empty() ? std::cout : outputFile;
+
+  // the columns are fixed, new ones are only ever appended
+  os << "pipeline\tobject_bytes\tsegment_bytes\tstatus\tseconds\tgoodput_gbps\tsegments"
+     << "\tsegments_per_s\tcpu_ns_per_segment\tpeak_rss_kb\treorder_hwm_segments"
+     << "\ttransfer_rss_kb" << std::endl;
+
+  bool hasFailed = false;
+  for (const auto& pipeline : pipelines) {
+    for (auto size : sizes) {
+      for (auto segSize : segSizes) {
+        std::cerr << "Running " << pipeline << ", " << size << " bytes, "
+                  << segSize << " bytes per segment" << std::endl;
+
+        RunRecord r{};
+        bool hasRecord = false;
+        try {
+          auto params = makePipelineParameters(pipeline, options, maxPipelineSize, 1, 1.0, 0.5);
+          hasRecord = runInChild(params, options, size, static_cast<size_t>(segSize),
+                                 isGenerated, r);
+        }
+        catch (const std::exception& e) {
+          std::cerr << "ERROR: " << e.what() << std::endl;
+        }
+
+        double seconds = r.durationNs / 1e9;
+        os << pipeline << '\t' << size << '\t' << segSize << '\t'
+           << (!hasRecord ? "failed" : r.isComplete ? "ok" : "incomplete") << '\t'
+           << seconds << '\t'
+           << (seconds > 0 ? r.nBytes * 8 / seconds / 1e9 : 0) << '\t'
+           << r.nSegments << '\t'
+           << (seconds > 0 ? r.nSegments / seconds : 0) << '\t'
+           << (r.nSegments > 0 ? r.cpuNs / static_cast<double>(r.nSegments) : 0) << '\t'
+           << r.maxRssKb << '\t'
+           << r.maxBufferedSegments << '\t'
+           << r.transferRssKb << std::endl;
+
+        hasFailed = hasFailed || !hasRecord || !r.isComplete;
+      }
+    }
+  }
+
+  return hasFailed ? 1 : 0;
+}
+
+} // namespace bench
+} // namespace chunks
+} // namespace ndn
+
+int
+main(int argc, char** argv)
+{
+  return ndn::chunks::bench::main(argc, argv);
+}
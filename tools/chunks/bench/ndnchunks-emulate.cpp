@@ -0,0 +1,213 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "core/version.hpp"
+#include "emulated-transfer.hpp"
+#include "tools/chunks/catchunks/consumer.hpp"
+
+#include <fstream>
+
+namespace ndn {
+namespace chunks {
+namespace bench {
+
+static int
+main(int argc, char** argv)
+{
+  std::string programName(argv[0]);
+  chunks::Options options;
+  std::string pipelineType("aimd");
+  size_t maxPipelineSize(1);
+  int initCwnd(1);
+  double aiStep(1.0), mdCoef(0.5);
+  std::vector<std::string> links;
+  uint64_t objectSize(10 * 1024 * 1024);
+  size_t segmentSize(4400);
+  uint32_t seed(1);
+  int64_t tickUs(100);
+  double timeLimit(600.0);
+  std::string cwndPath, rttPath, ratePath;
+
+  namespace po = boost::program_options;
+  po::options_description visibleDesc("Options");
+  visibleDesc.add_options()
+    ("help,h",      "print this help message and exit")
+    ("pipeline-type,t", po::value<std::string>(&pipelineType)->default_value(pipelineType),
+                        "type of Interest pipeline to use; valid values are: 'fixed', 'aimd', 'cubic', 'tcpbic'")
+    ("link",        po::value<std::vector<std::string>>(&links),
+                    "link of the path from the consumer to the producer, as "
+                    "BANDWIDTH_MBPS,DELAY_MS,QUEUE_PACKETS,LOSS_RATE; can be repeated "
+                    "(default: 100,10,100,0)")
+    ("size",        po::value<uint64_t>(&objectSize)->default_value(objectSize),
+                    "size of the retrieved object, in bytes")
+    ("segment-size", po::value<size_t>(&segmentSize)->default_value(segmentSize),
+                     "payload size of each segment, in bytes")
+    ("seed",        po::value<uint32_t>(&seed)->default_value(seed),
+                    "seed of the random losses")
+    ("tick",        po::value<int64_t>(&tickUs)->default_value(tickUs),
+                    "granularity of the virtual time, in microseconds")
+    ("time-limit",  po::value<double>(&timeLimit)->default_value(timeLimit),
+                    "maximum virtual duration of the transfer, in seconds")
+    ("lifetime,l",  po::value<uint64_t>()->default_value(options.interestLifetime.count()),
+                    "lifetime of expressed Interests, in milliseconds")
+    ("retries,r",   po::value<int>(&options.maxRetriesOnTimeoutOrNack)->default_value(options.maxRetriesOnTimeoutOrNack),
+                    "maximum number of retries in case of Nack or timeout (-1 = no limit)")
+    ("pipeline-size,s", po::value<size_t>(&maxPipelineSize)->default_value(maxPipelineSize),
+                        "size of the fixed Interest pipeline")
+    ("initial-cwnd", po::value<int>(&initCwnd)->default_value(initCwnd),
+                     "initial cwnd")
+    ("aistep",      po::value<double>(&aiStep)->default_value(aiStep),
+                    "additive-increase step")
+    ("mdcoef",      po::value<double>(&mdCoef)->default_value(mdCoef),
+                    "multiplicative-decrease coefficient")
+    ("debug-cwnd",  po::value<std::string>(&cwndPath), "log file for cwnd statistics")
+    ("debug-rtt",   po::value<std::string>(&rttPath), "log file for rtt statistics")
+    ("debug-rate",  po::value<std::string>(&ratePath), "log file for rate statistics")
+    ("verbose,v",   po::bool_switch(&options.isVerbose), "turn on verbose output")
+    ("version,V",   "print program version and exit")
+    ;
+
+  po::variables_map vm;
+  try {
+    po::store(po::parse_command_line(argc, argv, visibleDesc), vm);
+    po::notify(vm);
+  }
+  catch (const po::error& e) {
+    std::cerr << "ERROR: " << e.what() << std::endl;
+    return 2;
+  }
+  catch (const boost::bad_any_cast& e) {
+    std::cerr << "ERROR: " << e.what() << std::endl;
+    return 2;
+  }
+
+  if (vm.count("help") > 0) {
+    std::cout << "Usage: " << programName << " [options]" << std::endl;
+    std::cout << visibleDesc;
+    return 0;
+  }
+
+  if (vm.count("version") > 0) {
+    std::cout << "ndnchunks-emulate " << tools::VERSION << std::endl;
+    return 0;
+  }
+
+  if (objectSize == 0 || segmentSize == 0) {
+    std::cerr << "ERROR: object and segment size must be positive" << std::endl;
+    return 2;
+  }
+
+  if (tickUs <= 0 || timeLimit <= 0) {
+    std::cerr << "ERROR: tick and time limit must be positive" << std::endl;
+    return 2;
+  }
+
+  if (maxPipelineSize < 1 || maxPipelineSize > 1024) {
+    std::cerr << "ERROR: pipeline size must be between 1 and 1024" << std::endl;
+    return 2;
+  }
+
+  options.interestLifetime = time::milliseconds(vm["lifetime"].as<uint64_t>());
+
+  EmulationParameters emulation;
+  emulation.seed = seed;
+  emulation.objectSize = objectSize;
+  emulation.segmentSize = segmentSize;
+  emulation.tick = time::microseconds(tickUs);
+  emulation.timeLimit = time::duration_cast<time::nanoseconds>(time::duration<double>(timeLimit));
+  try {
+    if (links.empty())
+      links.push_back("100,10,100,0");
+    for (const auto& link : links)
+      emulation.path.push_back(parseLinkProfile(link));
+  }
+  catch (const std::invalid_argument& e) {
+    std::cerr << "ERROR: " << e.what() << std::endl;
+    return 2;
+  }
+
+  auto params = makePipelineParameters(pipelineType, options, maxPipelineSize,
+                                       initCwnd, aiStep, mdCoef);
+
+  std::ofstream statsFileCwnd, statsFileRtt, statsFileRate;
+  for (const auto& file : {std::make_pair(&statsFileCwnd, cwndPath),
+                           std::make_pair(&statsFileRtt, rttPath),
+                           std::make_pair(&statsFileRate, ratePath)}) {
+    if (file.second.empty())
+      continue;
+    file.first->open(file.second);
+    if (file.first->fail()) {
+      std::cerr << "ERROR: failed to open " << file.second << std::endl;
+      return 4;
+    }
+  }
+
+  try {
+    auto result = runEmulatedTransfer(emulation, params, options, [&] (PipelineSetup& setup) {
+      if (!cwndPath.empty() || !rttPath.empty() || !ratePath.empty())
+        setup.enableStatistics(statsFileCwnd, statsFileRtt, statsFileRate);
+    });
+
+    double elapsed = time::duration_cast<time::duration<double>>(result.duration).count();
+    std::cout << "Pipeline: " << pipelineType << "\n"
+              << "Completed: " << (result.isComplete ? "yes" : "no") << "\n"
+              << "Received: " << result.nBytes << " of " << objectSize << " bytes\n"
+              << "Virtual time: " << elapsed << " s\n"
+              << "Goodput: " << (elapsed > 0 ? result.nBytes * 8 / elapsed / 1e6 : 0) << " Mbit/s\n"
+              << "Segments served: " << result.nServedSegments << "\n"
+              << "Loss events: " << result.nLossEvents << "\n";
+    for (size_t i = 0; i < emulation.path.size(); ++i) {
+      const auto& fwd = result.forwardPath[i];
+      const auto& rev = result.reversePath[emulation.path.size() - 1 - i];
+      std::cout << "Link " << i << " (" << emulation.path[i] << "): "
+                << "forward " << fwd.nPackets << " pkts, " << fwd.nQueueDrops << " queue drops, "
+                << fwd.nLosses << " losses, max queue " << fwd.maxQueueLength << "; "
+                << "reverse " << rev.nPackets << " pkts, " << rev.nQueueDrops << " queue drops, "
+                << rev.nLosses << " losses, max queue " << rev.maxQueueLength << "\n";
+    }
+    std::cout.flush();
+
+    if (!result.isComplete)
+      return 1;
+  }
+  catch (const Consumer::ApplicationNackError& e) {
+    std::cerr << "ERROR: " << e.what() << std::endl;
+    return 3;
+  }
+  catch (const std::exception& e) {
+    std::cerr << "ERROR: " << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
+
+} // namespace bench
+} // namespace chunks
+} // namespace ndn
+
+int
+main(int argc, char** argv)
+{
+  return ndn::chunks::bench::main(argc, argv);
+}
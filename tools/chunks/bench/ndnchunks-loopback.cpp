@@ -0,0 +1,152 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "core/version.hpp"
+#include "loopback-transfer.hpp"
+#include "tools/chunks/catchunks/consumer.hpp"
+
+namespace ndn {
+namespace chunks {
+namespace bench {
+
+static int
+main(int argc, char** argv)
+{
+  std::string programName(argv[0]);
+  chunks::Options options;
+  std::string pipelineType("aimd");
+  size_t maxPipelineSize(1);
+  int initCwnd(1);
+  double aiStep(1.0), mdCoef(0.5);
+  uint64_t objectSize(100 * 1024 * 1024);
+  size_t segmentSize(4400);
+  bool isGenerated(false);
+
+  namespace po = boost::program_options;
+  po::options_description visibleDesc("Options");
+  visibleDesc.add_options()
+    ("help,h",      "print this help message and exit")
+    ("pipeline-type,t", po::value<std::string>(&pipelineType)->default_value(pipelineType),
+                        "type of Interest pipeline to use; valid values are: 'fixed', 'aimd', 'cubic', 'tcpbic'")
+    ("size",        po::value<uint64_t>(&objectSize)->default_value(objectSize),
+                    "size of the transferred object, in bytes")
+    ("segment-size", po::value<size_t>(&segmentSize)->default_value(segmentSize),
+                     "payload size of each segment, in bytes")
+    ("generate",    po::bool_switch(&isGenerated),
+                    "generate and sign each segment when it is requested, instead of loading "
+                    "the object into a Producer; the time includes the generation and signing")
+    ("lifetime,l",  po::value<uint64_t>()->default_value(options.interestLifetime.count()),
+                    "lifetime of expressed Interests, in milliseconds")
+    ("retries,r",   po::value<int>(&options.maxRetriesOnTimeoutOrNack)->default_value(options.maxRetriesOnTimeoutOrNack),
+                    "maximum number of retries in case of Nack or timeout (-1 = no limit)")
+    ("pipeline-size,s", po::value<size_t>(&maxPipelineSize)->default_value(maxPipelineSize),
+                        "size of the fixed Interest pipeline")
+    ("initial-cwnd", po::value<int>(&initCwnd)->default_value(initCwnd),
+                     "initial cwnd")
+    ("aistep",      po::value<double>(&aiStep)->default_value(aiStep),
+                    "additive-increase step")
+    ("mdcoef",      po::value<double>(&mdCoef)->default_value(mdCoef),
+                    "multiplicative-decrease coefficient")
+    ("verbose,v",   po::bool_switch(&options.isVerbose), "turn on verbose output")
+    ("version,V",   "print program version and exit")
+    ;
+
+  po::variables_map vm;
+  try {
+    po::store(po::parse_command_line(argc, argv, visibleDesc), vm);
+    po::notify(vm);
+  }
+  catch (const po::error& e) {
+    std::cerr << "ERROR: " << e.what() << std::endl;
+    return 2;
+  }
+  catch (const boost::bad_any_cast& e) {
+    std::cerr << "ERROR: " << e.what() << std::endl;
+    return 2;
+  }
+
+  if (vm.count("help") > 0) {
+    std::cout << "Usage: " << programName << " [options]" << std::endl;
+    std::cout << visibleDesc;
+    return 0;
+  }
+
+  if (vm.count("version") > 0) {
+    std::cout << "ndnchunks-loopback " << tools::VERSION << std::endl;
+    return 0;
+  }
+
+  if (objectSize == 0 || segmentSize == 0) {
+    std::cerr << "ERROR: object and segment size must be positive" << std::endl;
+    return 2;
+  }
+
+  if (maxPipelineSize < 1 || maxPipelineSize > 1024) {
+    std::cerr << "ERROR: pipeline size must be between 1 and 1024" << std::endl;
+    return 2;
+  }
+
+  options.interestLifetime = time::milliseconds(vm["lifetime"].as<uint64_t>());
+
+  try {
+    auto result = runLoopbackTransfer(makePipelineParameters(pipelineType, options, maxPipelineSize,
+                                                             initCwnd, aiStep, mdCoef),
+                                      options, objectSize, segmentSize, isGenerated);
+    double elapsed = time::duration_cast<time::duration<double>>(result.duration).count();
+
+    const auto& counters = result.counters;
+    std::cout << "Pipeline: " << pipelineType << "\n"
+              << "Completed: " << (result.isComplete ? "yes" : "no") << "\n"
+              << "Received: " << result.nBytes << " of " << objectSize << " bytes\n"
+              << "Time: " << elapsed << " s\n"
+              << "Goodput: " << result.nBytes * 8 / elapsed / 1e9 << " Gbit/s\n"
+              << "Segments/s: " << counters.nData / elapsed << "\n"
+              << "Interests: " << counters.nInterests << ", Data: " << counters.nData
+              << " (" << counters.nDataBytes << " bytes), Nacks: " << counters.nNacks << "\n"
+              << "Reorder buffer high-water mark: " << result.maxBufferedSegments
+              << " segments" << std::endl;
+
+    if (!result.isComplete)
+      return 1;
+  }
+  catch (const Consumer::ApplicationNackError& e) {
+    std::cerr << "ERROR: " << e.what() << std::endl;
+    return 3;
+  }
+  catch (const std::exception& e) {
+    std::cerr << "ERROR: " << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
+
+} // namespace bench
+} // namespace chunks
+} // namespace ndn
+
+int
+main(int argc, char** argv)
+{
+  return ndn::chunks::bench::main(argc, argv);
+}
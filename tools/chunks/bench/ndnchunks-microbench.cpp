@@ -0,0 +1,594 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "core/version.hpp"
+#include "counting-stream.hpp"
+#include "object-stream.hpp"
+#include "pipeline-setup.hpp"
+#include "tools/chunks/catchunks/consumer.hpp"
+#include "tools/chunks/catchunks/data-fetcher.hpp"
+#include "tools/chunks/catchunks/interest-template.hpp"
+#include "tools/chunks/putchunks/producer.hpp"
+
+#include <ndn-cxx/security/signature-sha256-with-rsa.hpp>
+#include <ndn-cxx/security/signing-helpers.hpp>
+#include <ndn-cxx/security/validator-null.hpp>
+#include <ndn-cxx/util/dummy-client-face.hpp>
+#include <ndn-cxx/util/random.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <random>
+
+/// number of calls to the global operator new
+static uint64_t g_nAllocations = 0;
+
+void*
+operator new(std::size_t size)
+{
+  ++g_nAllocations;
+  void* p = std::malloc(size == 0 ? 1 : size);
+  if (p == nullptr)
+    throw std::bad_alloc();
+  return p;
+}
+
+void
+operator delete(void* p) noexcept
+{
+  std::free(p);
+}
+
+namespace ndn {
+namespace chunks {
+namespace bench {
+
+/**
+ * @brief Accumulates the time and the allocations of the measured parts of a benchmark
+ */
+class Measurement
+{
+public:
+  void
+  start()
+  {
+    m_startAllocations = g_nAllocations;
+    m_startTime = time::steady_clock::now();
+  }
+
+  void
+  stop(uint64_t nOps)
+  {
+    auto now = time::steady_clock::now();
+    m_duration += now - m_startTime;
+    m_nAllocations += g_nAllocations - m_startAllocations;
+    m_nOps += nOps;
+  }
+
+  void
+  print(std::ostream& os, const std::string& name) const
+  {
+    double nOps = std::max<uint64_t>(m_nOps, 1);
+    os << name << '\t' << m_duration.count() / nOps << '\t'
+       << m_nAllocations / nOps << '\t' << m_nOps << std::endl;
+  }
+
+private:
+  time::steady_clock::TimePoint m_startTime;
+  uint64_t m_startAllocations = 0;
+  time::nanoseconds m_duration = time::nanoseconds::zero();
+  uint64_t m_nAllocations = 0;
+  uint64_t m_nOps = 0;
+};
+
+static shared_ptr<Data>
+makeSegment(const Name& prefix, uint64_t segmentNo, uint64_t lastSegmentNo, size_t payloadSize)
+{
+  static const std::vector<uint8_t> payload(65536, 'x');
+
+  auto data = make_shared<Data>(Name(prefix).appendSegment(segmentNo));
+  data->setContent(payload.data(), std::min(payloadSize, payload.size()));
+  data->setFinalBlockId(name::Component::fromSegment(lastSegmentNo));
+
+  SignatureSha256WithRsa fakeSignature;
+  fakeSignature.setValue(encoding::makeEmptyBlock(tlv::SignatureValue));
+  data->setSignature(fakeSignature);
+  data->wireEncode();
+  return data;
+}
+
+/**
+ * @brief Version discovery that immediately reports a given first segment
+ */
+class DiscoverVersionReplay : public DiscoverVersion
+{
+public:
+  DiscoverVersionReplay(Face& face, const Data& firstSegment)
+    : DiscoverVersion(firstSegment.getName().getPrefix(-1), face, Options())
+    , m_firstSegment(firstSegment)
+  {
+  }
+
+  void
+  run() final
+  {
+    this->emitSignal(onDiscoverySuccess, m_firstSegment);
+  }
+
+private:
+  const Data& m_firstSegment;
+};
+
+/**
+ * @brief Pipeline that sends nothing, the segments are delivered by the benchmark
+ */
+class PipelineInterestsReplay : public PipelineInterests
+{
+public:
+  explicit
+  PipelineInterestsReplay(Face& face)
+    : PipelineInterests(face)
+  {
+  }
+
+  void
+  deliver(const Interest& interest, const Data& data) const
+  {
+    onData(interest, data);
+  }
+
+private:
+  void
+  doRun() final
+  {
+  }
+
+  void
+  doCancel() final
+  {
+  }
+};
+
+/**
+ * @return the order in which segments 1 to @p nSegments - 1 are delivered
+ */
+static std::vector<uint64_t>
+makeDeliveryOrder(const std::string& pattern, uint64_t nSegments)
+{
+  std::vector<uint64_t> order;
+  for (uint64_t i = 1; i < nSegments; ++i)
+    order.push_back(i);
+
+  auto forEachBlock = [&order] (size_t blockSize, const function<void(std::vector<uint64_t>::iterator,
+                                                                      std::vector<uint64_t>::iterator)>& f) {
+    for (size_t i = 0; i < order.size(); i += blockSize)
+      f(order.begin() + i, order.begin() + std::min(i + blockSize, order.size()));
+  };
+
+  std::mt19937 rng(1);
+  if (pattern == "reversed-16") {
+    forEachBlock(16, [] (std::vector<uint64_t>::iterator b, std::vector<uint64_t>::iterator e) {
+      std::reverse(b, e);
+    });
+  }
+  else if (pattern == "shuffled-64") {
+    forEachBlock(64, [&rng] (std::vector<uint64_t>::iterator b, std::vector<uint64_t>::iterator e) {
+      std::shuffle(b, e, rng);
+    });
+  }
+  else if (pattern == "hole-1024") {
+    // the first segment of each block arrives last, as after a loss
+    forEachBlock(1024, [] (std::vector<uint64_t>::iterator b, std::vector<uint64_t>::iterator e) {
+      std::rotate(b, b + 1, e);
+    });
+  }
+  return order;
+}
+
+static void
+benchConsumerReorder(const std::string& pattern, uint64_t nSegments, size_t nRepeats,
+                     Measurement& m)
+{
+  util::DummyClientFace face;
+  Name prefix("/bench/object");
+  prefix.appendVersion(1);
+
+  std::vector<shared_ptr<Data>> segments;
+  for (uint64_t i = 0; i < nSegments; ++i)
+    segments.push_back(makeSegment(prefix, i, nSegments - 1, 4400));
+  auto order = makeDeliveryOrder(pattern, nSegments);
+  Interest interest(prefix);
+
+  for (size_t r = 0; r < nRepeats; ++r) {
+    CountingStream output;
+    ValidatorNull validator;
+    Consumer consumer(validator, false, output);
+    auto pipeline = make_unique<PipelineInterestsReplay>(face);
+    auto pipelinePtr = pipeline.get();
+    consumer.run(make_unique<DiscoverVersionReplay>(face, *segments[0]), std::move(pipeline));
+
+    m.start();
+    for (auto segNo : order)
+      pipelinePtr->deliver(interest, *segments[segNo]);
+    m.stop(order.size());
+
+    if (output.getCount() != nSegments * 4400)
+      throw std::runtime_error("consumer-reorder: the object was not written completely");
+  }
+}
+
+static void
+benchRttEstimator(uint64_t nOps, Measurement& m)
+{
+  aimd::RttEstimator rttEstimator;
+
+  m.start();
+  for (uint64_t i = 0; i < nOps; ++i)
+    rttEstimator.addMeasurement(i, i * 0.001, aimd::Milliseconds(50.0 + i % 20), 1);
+  m.stop(nOps);
+}
+
+/**
+ * @param statistics "text" or "binary" to log the statistics of the pipeline, empty for none
+ */
+static void
+benchPipeline(const std::string& type, const std::string& statistics, uint64_t nSegments,
+              Measurement& m)
+{
+  boost::asio::io_service io;
+  util::DummyClientFace face(io, util::DummyClientFace::Options{false, false});
+  Name prefix("/bench/object");
+  prefix.appendVersion(1);
+
+  // the pipelines do not look at the content, small segments keep the working set small
+  std::vector<shared_ptr<Data>> segments;
+  for (uint64_t i = 0; i < nSegments; ++i)
+    segments.push_back(makeSegment(prefix, i, nSegments - 1, 100));
+
+  std::deque<uint64_t> requested;
+  face.onSendInterest.connect([&requested] (const Interest& interest) {
+    requested.push_back(interest.getName()[-1].toSegment());
+  });
+
+  auto params = makePipelineParameters(type, chunks::Options(), 64, 1, 1.0, 0.5);
+  CountingStream osCwnd, osRtt, osRate; // outlive the statistics collectors in setup
+  PipelineSetup setup(face, params);
+  if (statistics == "text")
+    setup.enableStatistics(osCwnd, osRtt, osRate);
+  else if (statistics == "binary")
+    setup.enableBinaryStatistics(osCwnd);
+  auto pipeline = setup.releasePipeline();
+
+  uint64_t nReceived = 0;
+  m.start();
+  pipeline->run(*segments[0], [&nReceived] (const Interest&, const Data&) { ++nReceived; },
+                [] (const std::string& reason) { throw std::runtime_error(reason); });
+  io.poll();
+  // each operation is the arrival of a Data, its processing and the Interests it triggers
+  uint64_t nOps = 0;
+  while (!requested.empty()) {
+    uint64_t segNo = requested.front();
+    requested.pop_front();
+    face.receive(*segments[segNo]);
+    io.poll();
+    ++nOps;
+  }
+  m.stop(nOps);
+  pipeline->cancel();
+
+  if (nReceived < nSegments - 1)
+    throw std::runtime_error("pipeline-" + type + ": not all the segments were received");
+}
+
+/**
+ * @brief produce one segment Interest per operation, encoded as it is sent on the Face
+ *
+ * With @p isDecoded, each Interest is obtained as InterestTemplate did before it kept a decoded
+ * template: the wire of a template Interest is copied, patched with the segment number and the
+ * Nonce, and decoded. Otherwise it is a copy of the template Interest made by
+ * InterestTemplate::makeInterest, which the Face encodes when it expresses it.
+ */
+static void
+benchInterestTemplate(bool isDecoded, uint64_t nOps, Measurement& m)
+{
+  Name prefix("/bench/object");
+  prefix.appendVersion(1);
+  InterestTemplate interestTemplate(prefix, chunks::Options());
+
+  // segment numbers encoded with two octets, so that a single wire template is needed
+  const uint64_t firstSegmentNo = 256;
+  Interest wireTemplate = interestTemplate.makeInterest(firstSegmentNo);
+  const Block& wire = wireTemplate.wireEncode();
+  wire.parse();
+  size_t segmentOffset = std::distance(wire.begin(), wire.get(tlv::Name).end()) - 2;
+  size_t nonceOffset = std::distance(wire.begin(), wire.get(tlv::Nonce).value_begin());
+
+  size_t nEncodedBytes = 0;
+  m.start();
+  for (uint64_t i = 0; i < nOps; ++i) {
+    uint64_t segNo = firstSegmentNo + i % 65280;
+    if (isDecoded) {
+      auto buffer = make_shared<Buffer>(wire.begin(), wire.end());
+      (*buffer)[segmentOffset] = static_cast<uint8_t>(segNo >> 8);
+      (*buffer)[segmentOffset + 1] = static_cast<uint8_t>(segNo & 0xFF);
+      uint32_t nonce = random::generateWord32();
+      std::memcpy(buffer->data() + nonceOffset, &nonce, sizeof(nonce));
+
+      Interest interest;
+      interest.wireDecode(Block(buffer));
+      nEncodedBytes += interest.wireEncode().size();
+    }
+    else {
+      nEncodedBytes += interestTemplate.makeInterest(segNo).wireEncode().size();
+    }
+  }
+  m.stop(nOps);
+
+  if (nEncodedBytes != nOps * wire.size())
+    throw std::runtime_error("interest-template: unexpected Interest encoding");
+}
+
+static void
+benchDataFetcherCreate(uint64_t nOps, Measurement& m)
+{
+  boost::asio::io_service io;
+  util::DummyClientFace face(io, util::DummyClientFace::Options{false, false});
+  Scheduler scheduler(io);
+
+  m.start();
+  for (uint64_t i = 0; i < nOps; ++i) {
+    auto fetcher = DataFetcher::create(face, scheduler, 3, 3,
+                                       [] (const Interest&, const Data&) {},
+                                       [] (const Interest&, const std::string&) {},
+                                       [] (const Interest&, const std::string&) {},
+                                       false);
+  }
+  m.stop(nOps);
+}
+
+static void
+benchDataFetcherFetch(uint64_t nOps, Measurement& m)
+{
+  boost::asio::io_service io;
+  util::DummyClientFace face(io, util::DummyClientFace::Options{false, false});
+  Interest interest(Name("/bench/object").appendVersion(1).appendSegment(0));
+
+  m.start();
+  for (uint64_t i = 0; i < nOps; ++i) {
+    auto fetcher = DataFetcher::fetch(face, interest, 3, 3,
+                                      [] (const Interest&, const Data&) {},
+                                      [] (const Interest&, const std::string&) {},
+                                      [] (const Interest&, const std::string&) {},
+                                      false);
+    fetcher->cancel();
+    io.poll();
+  }
+  m.stop(nOps);
+}
+
+/**
+ * @brief fetch one segment per operation, through a single DataFetcher restarted for each
+ *        segment if @p isPooled is true, or through a new DataFetcher for each segment otherwise
+ *
+ * The pooled variant is how the fixed-window pipeline uses its fetchers; the other one is how it
+ * used them before they were pooled, each fetcher with its own Scheduler.
+ */
+static void
+benchDataFetcherSegment(bool isPooled, uint64_t nOps, Measurement& m)
+{
+  boost::asio::io_service io;
+  util::DummyClientFace face(io, util::DummyClientFace::Options{false, false});
+  Scheduler scheduler(io);
+  Name prefix("/bench/object");
+  prefix.appendVersion(1);
+
+  std::vector<Interest> interests;
+  std::vector<shared_ptr<Data>> segments;
+  for (uint64_t i = 0; i < 1024; ++i) {
+    interests.emplace_back(Name(prefix).appendSegment(i));
+    segments.push_back(makeSegment(prefix, i, 1023, 100));
+  }
+
+  uint64_t nReceived = 0;
+  auto onData = [&nReceived] (const Interest&, const Data&) { ++nReceived; };
+  auto onFailure = [] (const Interest&, const std::string& reason) {
+    throw std::runtime_error(reason);
+  };
+
+  shared_ptr<DataFetcher> pooledFetcher;
+  if (isPooled)
+    pooledFetcher = DataFetcher::create(face, scheduler, 3, 3, onData, onFailure, onFailure, false);
+
+  m.start();
+  for (uint64_t i = 0; i < nOps; ++i) {
+    size_t index = i % interests.size();
+    shared_ptr<DataFetcher> fetcher;
+    if (isPooled)
+      pooledFetcher->restart(interests[index]);
+    else
+      fetcher = DataFetcher::fetch(face, interests[index], 3, 3, onData, onFailure, onFailure, false);
+    io.poll();
+    face.receive(*segments[index]);
+    io.poll();
+  }
+  m.stop(nOps);
+
+  if (nReceived != nOps)
+    throw std::runtime_error("data-fetcher: not all the segments were received");
+}
+
+static void
+benchProducer(uint64_t nSegments, uint64_t nOps, Measurement& m)
+{
+  boost::asio::io_service io;
+  util::DummyClientFace face(io, util::DummyClientFace::Options{false, true});
+  KeyChain keyChain("pib-memory:", "tpm-memory:");
+  Name prefix("/bench/object");
+  prefix.appendVersion(1);
+  ObjectStream input(nSegments * 4400);
+  Producer producer(prefix, face, keyChain, security::signingWithSha256(), time::seconds(10),
+                    4400, false, false, input);
+  io.poll();
+
+  uint64_t nServed = 0;
+  face.onSendData.connect([&nServed] (const Data&) { ++nServed; });
+
+  std::mt19937 rng(1);
+  std::uniform_int_distribution<uint64_t> segmentDistribution(0, nSegments - 1);
+  std::vector<Interest> interests;
+  for (size_t i = 0; i < 1024; ++i) {
+    interests.emplace_back(Name(prefix).appendSegment(segmentDistribution(rng)));
+    interests.back().wireEncode();
+  }
+
+  m.start();
+  for (uint64_t i = 0; i < nOps; ++i) {
+    face.receive(interests[i % interests.size()]);
+    io.poll();
+  }
+  m.stop(nOps);
+
+  if (nServed != nOps)
+    throw std::runtime_error("producer: not all the Interests were answered");
+}
+
+static int
+main(int argc, char** argv)
+{
+  std::string programName(argv[0]);
+  std::string filter;
+  double scale(1.0);
+
+  namespace po = boost::program_options;
+  po::options_description visibleDesc("Options");
+  visibleDesc.add_options()
+    ("help,h",    "print this help message and exit")
+    ("filter,f",  po::value<std::string>(&filter),
+                  "only run the benchmarks whose name contains this string")
+    ("scale",     po::value<double>(&scale)->default_value(scale),
+                  "multiply the number of operations of every benchmark by this factor")
+    ("version,V", "print program version and exit")
+    ;
+
+  po::variables_map vm;
+  try {
+    po::store(po::parse_command_line(argc, argv, visibleDesc), vm);
+    po::notify(vm);
+  }
+  catch (const po::error& e) {
+    std::cerr << "ERROR: " << e.what() << std::endl;
+    return 2;
+  }
+
+  if (vm.count("help") > 0) {
+    std::cout << "Usage: " << programName << " [options]" << std::endl;
+    std::cout << visibleDesc;
+    return 0;
+  }
+
+  if (vm.count("version") > 0) {
+    std::cout << "ndnchunks-microbench " << tools::VERSION << std::endl;
+    return 0;
+  }
+
+  if (scale <= 0) {
+    std::cerr << "ERROR: scale must be positive" << std::endl;
+    return 2;
+  }
+
+  auto n = [scale] (uint64_t nOps) {
+    return std::max<uint64_t>(static_cast<uint64_t>(nOps * scale), 2);
+  };
+
+  std::vector<std::pair<std::string, function<void(Measurement&)>>> benchmarks;
+  for (std::string pattern : {"in-order", "reversed-16", "shuffled-64", "hole-1024"}) {
+    benchmarks.emplace_back("consumer-reorder/" + pattern, [=] (Measurement& m) {
+      benchConsumerReorder(pattern, 4096, n(100), m);
+    });
+  }
+  benchmarks.emplace_back("rtt-estimator/addMeasurement", [=] (Measurement& m) {
+    benchRttEstimator(n(1000000), m);
+  });
+  for (std::string type : {"fixed", "aimd", "cubic", "tcpbic"}) {
+    benchmarks.emplace_back("pipeline/" + type + "/handleData+sendInterest", [=] (Measurement& m) {
+      benchPipeline(type, "", n(100000), m);
+    });
+  }
+  for (bool isDecoded : {false, true}) {
+    benchmarks.emplace_back(std::string("pipeline/interest-template/") + (isDecoded ? "decode" : "copy"),
+                            [=] (Measurement& m) {
+      benchInterestTemplate(isDecoded, n(1000000), m);
+    });
+  }
+  for (std::string statistics : {"text", "binary"}) {
+    benchmarks.emplace_back("pipeline/aimd/handleData+sendInterest+" + statistics + "-stats",
+                            [=] (Measurement& m) {
+      benchPipeline("aimd", statistics, n(100000), m);
+    });
+  }
+  benchmarks.emplace_back("data-fetcher/create", [=] (Measurement& m) {
+    benchDataFetcherCreate(n(100000), m);
+  });
+  benchmarks.emplace_back("data-fetcher/fetch", [=] (Measurement& m) {
+    benchDataFetcherFetch(n(100000), m);
+  });
+  for (bool isPooled : {true, false}) {
+    benchmarks.emplace_back(std::string("data-fetcher/segment-") + (isPooled ? "pooled" : "per-fetcher"),
+                            [=] (Measurement& m) {
+      benchDataFetcherSegment(isPooled, n(100000), m);
+    });
+  }
+  benchmarks.emplace_back("producer/onInterest", [=] (Measurement& m) {
+    benchProducer(10000, n(100000), m);
+  });
+
+  std::cout << "benchmark\tns_per_op\tallocs_per_op\tops" << std::endl;
+  try {
+    for (const auto& benchmark : benchmarks) {
+      if (benchmark.first.find(filter) == std::string::npos)
+        continue;
+
+      Measurement m;
+      benchmark.second(m);
+      m.print(std::cout, benchmark.first);
+    }
+  }
+  catch (const std::exception& e) {
+    std::cerr << "ERROR: " << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
+
+} // namespace bench
+} // namespace chunks
+} // namespace ndn
+
+int
+main(int argc, char** argv)
+{
+  return ndn::chunks::bench::main(argc, argv);
+}
@@ -0,0 +1,321 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "core/version.hpp"
+#include "emulated-transfer.hpp"
+
+#include <boost/algorithm/string/classification.hpp>
+#include <boost/algorithm/string/split.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include <cmath>
+#include <sstream>
+
+namespace ndn {
+namespace chunks {
+namespace bench {
+
+/**
+ * @brief A tunable parameter and the values it takes in the sweep
+ */
+struct GridAxis
+{
+  std::string name;
+  std::vector<double> values;
+};
+
+/**
+ * @brief set the parameter @p name of the pipelines and estimators to @p value
+ * @throw std::invalid_argument the parameter is unknown
+ */
+static void
+applyParameter(PipelineParameters& params, const std::string& name, double value)
+{
+  if (name == "init-cwnd") {
+    params.aimd.initCwnd = params.cubic.initCwnd = params.tcpbic.initCwnd = value;
+  }
+  else if (name == "aistep") {
+    params.aimd.aiStep = params.cubic.aiStep = params.tcpbic.aiStep = value;
+  }
+  else if (name == "mdcoef") {
+    params.aimd.mdCoef = params.cubic.mdCoef = params.tcpbic.mdCoef = value;
+  }
+  else if (name == "rto-alpha") {
+    params.rttEstimator.alpha = value;
+  }
+  else if (name == "rto-beta") {
+    params.rttEstimator.beta = value;
+  }
+  else if (name == "rto-k") {
+    params.rttEstimator.k = static_cast<int>(value);
+  }
+  else if (name == "rto-min") {
+    params.rttEstimator.minRto = aimd::Milliseconds(value);
+  }
+  else if (name == "rto-max") {
+    params.rttEstimator.maxRto = aimd::Milliseconds(value);
+  }
+  else if (name == "cubic-beta") {
+    params.cubic.cubicBeta = value;
+  }
+  else if (name == "cubic-scale") {
+    params.cubic.cubicScale = value;
+  }
+  else if (name == "bic-beta") {
+    params.tcpbic.bicBeta = value;
+  }
+  else if (name == "bic-max-increment") {
+    params.tcpbic.bicMaxIncrement = static_cast<int>(value);
+  }
+  else if (name == "bic-low-window") {
+    params.tcpbic.bicLowWindow = static_cast<int>(value);
+  }
+  else if (name == "pipeline-size") {
+    params.fixed.maxPipelineSize = static_cast<size_t>(value);
+  }
+  else {
+    throw std::invalid_argument("unknown parameter: " + name);
+  }
+}
+
+/**
+ * @brief parse a grid axis written as NAME=VALUE1,VALUE2,...
+ * @throw std::invalid_argument the axis is malformed
+ */
+static GridAxis
+parseGridAxis(const std::string& str)
+{
+  auto pos = str.find('=');
+  if (pos == std::string::npos || pos == 0)
+    throw std::invalid_argument("grid axis must be NAME=VALUE1,VALUE2,...: " + str);
+
+  GridAxis axis;
+  axis.name = str.substr(0, pos);
+  std::string values = str.substr(pos + 1);
+  std::vector<std::string> fields;
+  boost::algorithm::split(fields, values, boost::algorithm::is_any_of(","));
+  try {
+    for (const auto& field : fields)
+      axis.values.push_back(boost::lexical_cast<double>(field));
+  }
+  catch (const boost::bad_lexical_cast&) {
+    throw std::invalid_argument("malformed grid axis: " + str);
+  }
+
+  // reject unknown names before running anything
+  PipelineParameters params;
+  applyParameter(params, axis.name, axis.values.front());
+  return axis;
+}
+
+/**
+ * @brief Outcome of one point of the grid on one profile
+ */
+struct SweepPoint
+{
+  std::string parameters;
+  EmulationResult result;
+  double goodput; ///< Mbit/s
+  double rttInflation; ///< median RTT divided by the propagation RTT
+  uint64_t nDrops; ///< packets dropped or lost on the links
+};
+
+static bool
+isBetter(const SweepPoint& a, const SweepPoint& b)
+{
+  if (a.result.isComplete != b.result.isComplete)
+    return a.result.isComplete;
+  if (a.goodput != b.goodput)
+    return a.goodput > b.goodput;
+  // prefer the configuration that builds the smaller queues
+  return !std::isnan(a.rttInflation) && (std::isnan(b.rttInflation) || a.rttInflation < b.rttInflation);
+}
+
+static int
+main(int argc, char** argv)
+{
+  std::string programName(argv[0]);
+  chunks::Options options;
+  std::string pipelineType("aimd");
+  std::vector<std::string> profiles;
+  std::vector<std::string> axes;
+  EmulationParameters emulation;
+  emulation.objectSize = 20 * 1024 * 1024;
+  int64_t tickUs(100);
+  double timeLimit(600.0);
+
+  namespace po = boost::program_options;
+  po::options_description visibleDesc("Options");
+  visibleDesc.add_options()
+    ("help,h",      "print this help message and exit")
+    ("pipeline-type,t", po::value<std::string>(&pipelineType)->default_value(pipelineType),
+                        "type of Interest pipeline to tune; valid values are: 'fixed', 'aimd', 'cubic', 'tcpbic'")
+    ("profile",     po::value<std::vector<std::string>>(&profiles),
+                    "link between the consumer and the producer, as "
+                    "BANDWIDTH_MBPS,DELAY_MS,QUEUE_PACKETS,LOSS_RATE, where the RTT is twice the delay; "
+                    "can be repeated, every profile is swept separately (default: 100,10,100,0)")
+    ("grid",        po::value<std::vector<std::string>>(&axes),
+                    "values of a parameter, as NAME=VALUE1,VALUE2,...; can be repeated, the sweep "
+                    "covers every combination. Parameters: init-cwnd, aistep, mdcoef, rto-alpha, "
+                    "rto-beta, rto-k, rto-min, rto-max, cubic-beta, cubic-scale, bic-beta, "
+                    "bic-max-increment, bic-low-window, pipeline-size")
+    ("size",        po::value<uint64_t>(&emulation.objectSize)->default_value(emulation.objectSize),
+                    "size of the retrieved object, in bytes")
+    ("segment-size", po::value<size_t>(&emulation.segmentSize)->default_value(emulation.segmentSize),
+                     "payload size of each segment, in bytes")
+    ("seed",        po::value<uint32_t>(&emulation.seed)->default_value(emulation.seed),
+                    "seed of the random losses")
+    ("tick",        po::value<int64_t>(&tickUs)->default_value(tickUs),
+                    "granularity of the virtual time, in microseconds")
+    ("time-limit",  po::value<double>(&timeLimit)->default_value(timeLimit),
+                    "maximum virtual duration of each transfer, in seconds")
+    ("version,V",   "print program version and exit")
+    ;
+
+  po::variables_map vm;
+  try {
+    po::store(po::parse_command_line(argc, argv, visibleDesc), vm);
+    po::notify(vm);
+  }
+  catch (const po::error& e) {
+    std::cerr << "ERROR: " << e.what() << std::endl;
+    return 2;
+  }
+
+  if (vm.count("help") > 0) {
+    std::cout << "Usage: " << programName << " [options]" << std::endl;
+    std::cout << visibleDesc;
+    return 0;
+  }
+
+  if (vm.count("version") > 0) {
+    std::cout << "ndnchunks-sweep " << tools::VERSION << std::endl;
+    return 0;
+  }
+
+  if (emulation.objectSize == 0 || emulation.segmentSize == 0) {
+    std::cerr << "ERROR: object and segment size must be positive" << std::endl;
+    return 2;
+  }
+
+  if (tickUs <= 0 || timeLimit <= 0) {
+    std::cerr << "ERROR: tick and time limit must be positive" << std::endl;
+    return 2;
+  }
+
+  emulation.tick = time::microseconds(tickUs);
+  emulation.timeLimit = time::duration_cast<time::nanoseconds>(time::duration<double>(timeLimit));
+
+  std::vector<LinkProfile> links;
+  std::vector<GridAxis> grid;
+  try {
+    if (profiles.empty())
+      profiles.push_back("100,10,100,0");
+    for (const auto& profile : profiles)
+      links.push_back(parseLinkProfile(profile));
+    for (const auto& axis : axes)
+      grid.push_back(parseGridAxis(axis));
+  }
+  catch (const std::invalid_argument& e) {
+    std::cerr << "ERROR: " << e.what() << std::endl;
+    return 2;
+  }
+
+  std::cout << "profile\tparameters\tstatus\tgoodput_mbps\tloss_events\tlink_drops"
+            << "\trtt_inflation\tseconds" << std::endl;
+
+  std::vector<SweepPoint> best;
+  try {
+    for (size_t p = 0; p < links.size(); ++p) {
+      emulation.path = {links[p]};
+      double propagationRtt = getPropagationRtt(emulation.path);
+
+      std::vector<size_t> index(grid.size(), 0);
+      for (bool hasNext = true; hasNext; ) {
+        auto params = makePipelineParameters(pipelineType, options, 1, 1, 1.0, 0.5);
+        std::ostringstream description;
+        for (size_t i = 0; i < grid.size(); ++i) {
+          applyParameter(params, grid[i].name, grid[i].values[index[i]]);
+          description << (i > 0 ? ";" : "") << grid[i].name << '=' << grid[i].values[index[i]];
+        }
+
+        SweepPoint point;
+        point.parameters = grid.empty() ? "default" : description.str();
+        point.result = runEmulatedTransfer(emulation, params, options);
+        double seconds = time::duration_cast<time::duration<double>>(point.result.duration).count();
+        point.goodput = seconds > 0 ? point.result.nBytes * 8 / seconds / 1e6 : 0;
+        point.rttInflation = point.result.rttP50 / propagationRtt;
+        point.nDrops = 0;
+        for (const auto& counters : point.result.forwardPath)
+          point.nDrops += counters.nQueueDrops + counters.nLosses;
+        for (const auto& counters : point.result.reversePath)
+          point.nDrops += counters.nQueueDrops + counters.nLosses;
+
+        std::cout << profiles[p] << '\t' << point.parameters << '\t'
+                  << (point.result.isComplete ? "ok" : "incomplete") << '\t'
+                  << point.goodput << '\t' << point.result.nLossEvents << '\t' << point.nDrops << '\t'
+                  << point.rttInflation << '\t' << seconds << std::endl;
+
+        if (best.size() == p)
+          best.push_back(point);
+        else if (isBetter(point, best[p]))
+          best[p] = point;
+
+        // advance to the next combination, the last axis varies fastest
+        size_t i = grid.size();
+        while (i > 0 && ++index[i - 1] == grid[i - 1].values.size()) {
+          index[i - 1] = 0;
+          --i;
+        }
+        hasNext = i > 0;
+      }
+    }
+  }
+  catch (const std::exception& e) {
+    std::cerr << "ERROR: " << e.what() << std::endl;
+    return 1;
+  }
+
+  std::cout << "\nBest configuration per profile (" << pipelineType << "):\n";
+  for (size_t p = 0; p < links.size(); ++p) {
+    const auto& point = best[p];
+    std::cout << "  " << profiles[p] << ": " << point.parameters
+              << (point.result.isComplete ? "" : " (incomplete)")
+              << ", goodput " << point.goodput << " Mbit/s"
+              << ", " << point.result.nLossEvents << " loss events"
+              << ", RTT inflation " << point.rttInflation << "\n";
+  }
+  std::cout.flush();
+
+  return 0;
+}
+
+} // namespace bench
+} // namespace chunks
+} // namespace ndn
+
+int
+main(int argc, char** argv)
+{
+  return ndn::chunks::bench::main(argc, argv);
+}
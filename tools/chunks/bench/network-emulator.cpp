@@ -0,0 +1,235 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "network-emulator.hpp"
+
+#include <ndn-cxx/security/signature-sha256-with-rsa.hpp>
+
+#include <boost/algorithm/string/split.hpp>
+#include <boost/algorithm/string/classification.hpp>
+#include <boost/lexical_cast.hpp>
+
+namespace ndn {
+namespace chunks {
+namespace bench {
+
+LinkProfile
+parseLinkProfile(const std::string& str)
+{
+  std::vector<std::string> fields;
+  boost::algorithm::split(fields, str, boost::algorithm::is_any_of(","));
+  if (fields.size() != 4)
+    throw std::invalid_argument("link profile must be BANDWIDTH_MBPS,DELAY_MS,QUEUE,LOSS: " + str);
+
+  LinkProfile profile;
+  try {
+    profile.bandwidth = boost::lexical_cast<double>(fields[0]) * 1e6;
+    profile.delay = time::duration_cast<time::nanoseconds>(
+                      time::duration<double, time::milliseconds::period>(
+                        boost::lexical_cast<double>(fields[1])));
+    profile.queueSize = boost::lexical_cast<size_t>(fields[2]);
+    profile.lossRate = boost::lexical_cast<double>(fields[3]);
+  }
+  catch (const boost::bad_lexical_cast&) {
+    throw std::invalid_argument("malformed link profile: " + str);
+  }
+
+  if (profile.bandwidth <= 0 || profile.delay < time::nanoseconds::zero() ||
+      profile.queueSize == 0 || profile.lossRate < 0 || profile.lossRate >= 1)
+    throw std::invalid_argument("link profile out of range: " + str);
+
+  return profile;
+}
+
+std::ostream&
+operator<<(std::ostream& os, const LinkProfile& profile)
+{
+  return os << profile.bandwidth / 1e6 << "Mbps,"
+            << time::duration_cast<time::microseconds>(profile.delay).count() / 1000.0 << "ms,"
+            << profile.queueSize << "pkts," << profile.lossRate << "loss";
+}
+
+EmulatedLink::EmulatedLink(Scheduler& scheduler, std::mt19937& rng, const LinkProfile& profile)
+  : m_scheduler(scheduler)
+  , m_rng(rng)
+  , m_lossDistribution(0.0, 1.0)
+  , m_profile(profile)
+{
+}
+
+void
+EmulatedLink::send(const Block& packet, const DeliverCallback& deliver)
+{
+  auto now = time::steady_clock::now();
+  m_counters.nPackets++;
+
+  while (!m_departures.empty() && m_departures.front() <= now) {
+    m_departures.pop_front();
+  }
+
+  if (m_departures.size() >= m_profile.queueSize) {
+    m_counters.nQueueDrops++;
+    return;
+  }
+
+  time::nanoseconds txTime(static_cast<int64_t>(packet.size() * 8 * 1e9 / m_profile.bandwidth));
+  auto departure = (m_departures.empty() ? now : m_departures.back()) + txTime;
+  m_departures.push_back(departure);
+  m_counters.maxQueueLength = std::max(m_counters.maxQueueLength, m_departures.size());
+
+  // the packet occupies the link even if it is lost along the way
+  if (m_profile.lossRate > 0 && m_lossDistribution(m_rng) < m_profile.lossRate) {
+    m_counters.nLosses++;
+    return;
+  }
+
+  m_scheduler.scheduleEvent(departure - now + m_profile.delay, [packet, deliver] {
+    deliver(packet);
+  });
+}
+
+NetworkEmulator::NetworkEmulator(const std::vector<LinkProfile>& path, uint32_t seed)
+  : m_steadyClock(make_shared<time::UnitTestSteadyClock>())
+  , m_systemClock(make_shared<time::UnitTestSystemClock>())
+  , m_elapsedTime(time::nanoseconds::zero())
+  , m_face(m_io, util::DummyClientFace::Options{false, false})
+  , m_scheduler(m_io)
+  , m_rng(seed)
+  , m_objectSize(0)
+  , m_segmentSize(0)
+  , m_nSegments(0)
+  , m_nServedSegments(0)
+{
+  BOOST_ASSERT(!path.empty());
+
+  time::setCustomClocks(m_steadyClock, m_systemClock);
+
+  for (const auto& profile : path) {
+    m_forwardPath.push_back(make_unique<EmulatedLink>(m_scheduler, m_rng, profile));
+  }
+  for (auto it = path.rbegin(); it != path.rend(); ++it) {
+    m_reversePath.push_back(make_unique<EmulatedLink>(m_scheduler, m_rng, *it));
+  }
+
+  m_face.onSendInterest.connect([this] (const Interest& interest) {
+    transmit(m_forwardPath, 0, interest.wireEncode(), bind(&NetworkEmulator::serve, this, _1));
+  });
+}
+
+NetworkEmulator::~NetworkEmulator()
+{
+  time::setCustomClocks(nullptr, nullptr);
+}
+
+void
+NetworkEmulator::setContent(const Name& versionedPrefix, uint64_t objectSize, size_t segmentSize)
+{
+  BOOST_ASSERT(segmentSize > 0);
+
+  m_prefix = versionedPrefix;
+  m_objectSize = objectSize;
+  m_segmentSize = segmentSize;
+  m_nSegments = std::max<uint64_t>((objectSize + segmentSize - 1) / segmentSize, 1);
+  m_payload.assign(segmentSize, 'x');
+}
+
+bool
+NetworkEmulator::run(const function<bool()>& isDone, time::nanoseconds tick,
+                     time::nanoseconds timeLimit)
+{
+  BOOST_ASSERT(tick > time::nanoseconds::zero());
+
+  auto deadline = m_elapsedTime + timeLimit;
+  while (!isDone()) {
+    if (m_elapsedTime >= deadline)
+      return false;
+
+    m_steadyClock->advance(tick);
+    m_systemClock->advance(tick);
+    m_elapsedTime += tick;
+
+    if (m_io.stopped())
+      m_io.reset();
+    m_io.poll();
+  }
+  return true;
+}
+
+void
+NetworkEmulator::transmit(std::vector<unique_ptr<EmulatedLink>>& path, size_t hop,
+                          const Block& packet, const EmulatedLink::DeliverCallback& arrive)
+{
+  if (hop == path.size()) {
+    arrive(packet);
+    return;
+  }
+
+  path[hop]->send(packet, [this, &path, hop, arrive] (const Block& p) {
+    transmit(path, hop + 1, p, arrive);
+  });
+}
+
+void
+NetworkEmulator::serve(const Block& interestWire)
+{
+  Interest interest(interestWire);
+  const Name& name = interest.getName();
+  if (!m_prefix.isPrefixOf(name))
+    return;
+
+  uint64_t segmentNo = 0; // an Interest for the version is answered with the first segment
+  if (name.size() == m_prefix.size() + 1 && name[-1].isSegment())
+    segmentNo = name[-1].toSegment();
+  else if (name.size() != m_prefix.size())
+    return;
+
+  if (segmentNo >= m_nSegments)
+    return;
+
+  m_nServedSegments++;
+  transmit(m_reversePath, 0, makeSegment(segmentNo)->wireEncode(), [this] (const Block& wire) {
+    m_face.receive(Data(wire));
+  });
+}
+
+shared_ptr<Data>
+NetworkEmulator::makeSegment(uint64_t segmentNo) const
+{
+  uint64_t offset = segmentNo * m_segmentSize;
+  size_t size = static_cast<size_t>(std::min<uint64_t>(m_segmentSize, m_objectSize - offset));
+
+  auto data = make_shared<Data>(Name(m_prefix).appendSegment(segmentNo));
+  data->setContent(m_payload.data(), size);
+  data->setFinalBlockId(name::Component::fromSegment(m_nSegments - 1));
+
+  // the consumer does not verify signatures, a placeholder is enough
+  SignatureSha256WithRsa fakeSignature;
+  fakeSignature.setValue(encoding::makeEmptyBlock(tlv::SignatureValue));
+  data->setSignature(fakeSignature);
+  data->wireEncode();
+  return data;
+}
+
+} // namespace bench
+} // namespace chunks
+} // namespace ndn
@@ -0,0 +1,230 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#ifndef NDN_TOOLS_CHUNKS_BENCH_NETWORK_EMULATOR_HPP
+#define NDN_TOOLS_CHUNKS_BENCH_NETWORK_EMULATOR_HPP
+
+#include "core/common.hpp"
+
+#include <ndn-cxx/util/dummy-client-face.hpp>
+#include <ndn-cxx/util/time-unit-test-clock.hpp>
+
+#include <deque>
+#include <random>
+
+namespace ndn {
+namespace chunks {
+namespace bench {
+
+/**
+ * @brief Characteristics of an emulated link
+ */
+struct LinkProfile
+{
+  double bandwidth; ///< capacity (bit/s)
+  time::nanoseconds delay; ///< one-way propagation delay
+  size_t queueSize; ///< capacity of the drop-tail queue (packets)
+  double lossRate; ///< probability of losing a packet on the link
+};
+
+/**
+ * @brief parse a link profile written as BANDWIDTH_MBPS,DELAY_MS,QUEUE_PACKETS,LOSS_RATE
+ * @throw std::invalid_argument the profile is malformed
+ */
+LinkProfile
+parseLinkProfile(const std::string& str);
+
+std::ostream&
+operator<<(std::ostream& os, const LinkProfile& profile);
+
+/**
+ * @brief Counters of an emulated link
+ */
+struct LinkCounters
+{
+  uint64_t nPackets = 0; ///< packets offered to the link
+  uint64_t nQueueDrops = 0; ///< packets dropped because the queue was full
+  uint64_t nLosses = 0; ///< packets lost on the link
+  size_t maxQueueLength = 0; ///< largest number of packets waiting or in transmission
+};
+
+/**
+ * @brief One direction of an emulated link
+ *
+ * Packets are serialized at the link bandwidth in FIFO order, and arrive at the other end after
+ * the propagation delay. A packet finding the queue full is dropped, and every packet is lost with
+ * probability LinkProfile::lossRate.
+ */
+class EmulatedLink : noncopyable
+{
+public:
+  typedef function<void(const Block& packet)> DeliverCallback;
+
+  EmulatedLink(Scheduler& scheduler, std::mt19937& rng, const LinkProfile& profile);
+
+  /**
+   * @brief transmit @p packet, @p deliver is invoked when it reaches the other end
+   */
+  void
+  send(const Block& packet, const DeliverCallback& deliver);
+
+  const LinkProfile&
+  getProfile() const
+  {
+    return m_profile;
+  }
+
+  const LinkCounters&
+  getCounters() const
+  {
+    return m_counters;
+  }
+
+private:
+  Scheduler& m_scheduler;
+  std::mt19937& m_rng;
+  std::uniform_real_distribution<double> m_lossDistribution;
+  const LinkProfile m_profile;
+  LinkCounters m_counters;
+  std::deque<time::steady_clock::TimePoint> m_departures; ///< end of transmission of queued packets
+};
+
+/**
+ * @brief Emulated network between a consumer Face and a producer of a segmented object
+ *
+ * Interests expressed on the consumer Face (a DummyClientFace) traverse the links of the path
+ * in order, reach an emulated producer that answers with segments of an object of the given
+ * size, and the Data traverse the links in the reverse order back to the Face.
+ *
+ * The emulator replaces the steady and system clocks with virtual clocks for its lifetime.
+ * Time only advances within run(), in fixed ticks, so that the emulation does not depend on
+ * the speed of the host and runs faster than real time. Random losses are drawn from a
+ * generator with a fixed seed, hence every run with the same parameters gives the same result.
+ */
+class NetworkEmulator : noncopyable
+{
+public:
+  /**
+   * @param path the links from the consumer to the producer, must not be empty
+   * @param seed seed of the random loss generator
+   */
+  NetworkEmulator(const std::vector<LinkProfile>& path, uint32_t seed);
+
+  ~NetworkEmulator();
+
+  /**
+   * @return the Face of the consumer
+   */
+  Face&
+  getFace()
+  {
+    return m_face;
+  }
+
+  /**
+   * @brief set the object served by the producer
+   *
+   * @param versionedPrefix name of the object, ending with a version component
+   * @param objectSize size of the object (bytes)
+   * @param segmentSize size of the payload of each segment (bytes)
+   */
+  void
+  setContent(const Name& versionedPrefix, uint64_t objectSize, size_t segmentSize);
+
+  /**
+   * @brief advance the virtual time and process the events
+   *
+   * @param isDone checked after each tick, the emulation stops when it returns true
+   * @param tick granularity of the virtual time
+   * @param timeLimit the emulation stops after this virtual time
+   * @return whether @p isDone returned true within @p timeLimit
+   */
+  bool
+  run(const function<bool()>& isDone, time::nanoseconds tick, time::nanoseconds timeLimit);
+
+  /**
+   * @return the virtual time elapsed since the emulator was created
+   */
+  time::nanoseconds
+  getElapsedTime() const
+  {
+    return m_elapsedTime;
+  }
+
+  const std::vector<unique_ptr<EmulatedLink>>&
+  getForwardPath() const
+  {
+    return m_forwardPath;
+  }
+
+  const std::vector<unique_ptr<EmulatedLink>>&
+  getReversePath() const
+  {
+    return m_reversePath;
+  }
+
+  /**
+   * @return number of Data sent by the producer
+   */
+  uint64_t
+  getNServedSegments() const
+  {
+    return m_nServedSegments;
+  }
+
+private:
+  void
+  transmit(std::vector<unique_ptr<EmulatedLink>>& path, size_t hop, const Block& packet,
+           const EmulatedLink::DeliverCallback& arrive);
+
+  void
+  serve(const Block& interestWire);
+
+  shared_ptr<Data>
+  makeSegment(uint64_t segmentNo) const;
+
+private:
+  shared_ptr<time::UnitTestSteadyClock> m_steadyClock;
+  shared_ptr<time::UnitTestSystemClock> m_systemClock;
+  time::nanoseconds m_elapsedTime;
+
+  boost::asio::io_service m_io;
+  util::DummyClientFace m_face;
+  Scheduler m_scheduler;
+  std::mt19937 m_rng;
+  std::vector<unique_ptr<EmulatedLink>> m_forwardPath;
+  std::vector<unique_ptr<EmulatedLink>> m_reversePath;
+
+  Name m_prefix;
+  uint64_t m_objectSize;
+  size_t m_segmentSize;
+  uint64_t m_nSegments;
+  std::vector<uint8_t> m_payload;
+  uint64_t m_nServedSegments;
+};
+
+} // namespace bench
+} // namespace chunks
+} // namespace ndn
+
+#endif // NDN_TOOLS_CHUNKS_BENCH_NETWORK_EMULATOR_HPP
@@ -0,0 +1,89 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#ifndef NDN_TOOLS_CHUNKS_BENCH_OBJECT_STREAM_HPP
+#define NDN_TOOLS_CHUNKS_BENCH_OBJECT_STREAM_HPP
+
+#include "core/common.hpp"
+
+#include <istream>
+#include <streambuf>
+
+namespace ndn {
+namespace chunks {
+namespace bench {
+
+/**
+ * @brief Input stream generating an object of a given size
+ *
+ * The object is produced on demand from a small repeated pattern, so that the input of the
+ * Producer does not have to be held in memory besides the segments themselves.
+ */
+class ObjectStream : public std::istream
+{
+public:
+  explicit
+  ObjectStream(uint64_t size)
+    : std::istream(&m_buf)
+    , m_buf(size)
+  {
+  }
+
+private:
+  class ObjectBuf : public std::streambuf
+  {
+  public:
+    explicit
+    ObjectBuf(uint64_t size)
+      : m_remaining(size)
+    {
+      for (size_t i = 0; i < sizeof(m_pattern); ++i)
+        m_pattern[i] = static_cast<char>('a' + i % 26);
+    }
+
+  protected:
+    int_type
+    underflow() final
+    {
+      if (m_remaining == 0)
+        return traits_type::eof();
+
+      auto n = static_cast<size_t>(std::min<uint64_t>(m_remaining, sizeof(m_pattern)));
+      m_remaining -= n;
+      setg(m_pattern, m_pattern, m_pattern + n);
+      return traits_type::to_int_type(m_pattern[0]);
+    }
+
+  private:
+    uint64_t m_remaining;
+    char m_pattern[65536];
+  };
+
+  ObjectBuf m_buf;
+};
+
+} // namespace bench
+} // namespace chunks
+} // namespace ndn
+
+#endif // NDN_TOOLS_CHUNKS_BENCH_OBJECT_STREAM_HPP
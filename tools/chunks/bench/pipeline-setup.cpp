@@ -0,0 +1,152 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "pipeline-setup.hpp"
+
+namespace ndn {
+namespace chunks {
+namespace bench {
+
+template<typename PipelineOptions>
+static void
+setCongestionOptions(PipelineOptions& options, const chunks::Options& base,
+                     int initCwnd, double aiStep, double mdCoef)
+{
+  static_cast<chunks::Options&>(options) = base;
+  options.isVerbose = base.isVerbose;
+  options.initCwnd = static_cast<double>(initCwnd);
+  options.aiStep = aiStep;
+  options.mdCoef = mdCoef;
+}
+
+PipelineParameters
+makePipelineParameters(const std::string& type, const chunks::Options& options,
+                       size_t maxPipelineSize, int initCwnd, double aiStep, double mdCoef)
+{
+  PipelineParameters params;
+  params.type = type;
+  params.fixed = PipelineInterestsFixedWindow::Options(options);
+  params.fixed.maxPipelineSize = maxPipelineSize;
+  setCongestionOptions(params.aimd, options, initCwnd, aiStep, mdCoef);
+  setCongestionOptions(params.cubic, options, initCwnd, aiStep, mdCoef);
+  setCongestionOptions(params.tcpbic, options, initCwnd, aiStep, mdCoef);
+  params.rttEstimator.isVerbose = options.isVerbose;
+  params.rateEstimator.isVerbose = options.isVerbose;
+  return params;
+}
+
+PipelineSetup::PipelineSetup(Face& face, const PipelineParameters& params)
+  : m_aimdPipeline(nullptr)
+  , m_cubicPipeline(nullptr)
+  , m_tcpbicPipeline(nullptr)
+{
+  if (params.type == "fixed") {
+    m_pipeline = make_unique<PipelineInterestsFixedWindow>(face, params.fixed);
+    return;
+  }
+
+  m_rttEstimator = make_unique<aimd::RttEstimator>(params.rttEstimator);
+  m_rateEstimator = make_unique<aimd::RateEstimator>(params.rateEstimator);
+
+  if (params.type == "aimd") {
+    auto pipeline = make_unique<PipelineInterestsAimd>(face, *m_rttEstimator, *m_rateEstimator,
+                                                       params.aimd);
+    m_aimdPipeline = pipeline.get();
+    m_pipeline = std::move(pipeline);
+  }
+  else if (params.type == "cubic") {
+    auto pipeline = make_unique<PipelineInterestsCubic>(face, *m_rttEstimator, *m_rateEstimator,
+                                                        params.cubic);
+    m_cubicPipeline = pipeline.get();
+    m_pipeline = std::move(pipeline);
+  }
+  else if (params.type == "tcpbic") {
+    auto pipeline = make_unique<PipelineInterestsTcpBic>(face, *m_rttEstimator, *m_rateEstimator,
+                                                         params.tcpbic);
+    m_tcpbicPipeline = pipeline.get();
+    m_pipeline = std::move(pipeline);
+  }
+  else {
+    throw std::invalid_argument("Interest pipeline type not valid: " + params.type);
+  }
+}
+
+void
+PipelineSetup::enableStatistics(std::ostream& osCwnd, std::ostream& osRtt, std::ostream& osRate)
+{
+  if (m_aimdPipeline != nullptr) {
+    m_statsCollector = make_unique<aimd::StatisticsCollector>(*m_aimdPipeline, *m_rttEstimator,
+                                                              *m_rateEstimator,
+                                                              osCwnd, osRtt, osRate);
+  }
+  else if (m_cubicPipeline != nullptr) {
+    m_statsCollector = make_unique<aimd::StatisticsCollector>(*m_cubicPipeline, *m_rttEstimator,
+                                                              *m_rateEstimator,
+                                                              osCwnd, osRtt, osRate);
+  }
+  else if (m_tcpbicPipeline != nullptr) {
+    m_statsCollector = make_unique<aimd::StatisticsCollector>(*m_tcpbicPipeline, *m_rttEstimator,
+                                                              *m_rateEstimator,
+                                                              osCwnd, osRtt, osRate);
+  }
+}
+
+void
+PipelineSetup::enableBinaryStatistics(std::ostream& os,
+                                      const aimd::BinaryStatisticsCollector::Options& options)
+{
+  if (m_aimdPipeline != nullptr) {
+    m_binaryStatsCollector = make_unique<aimd::BinaryStatisticsCollector>(*m_aimdPipeline,
+                                                                          *m_rttEstimator,
+                                                                          *m_rateEstimator,
+                                                                          os, options);
+  }
+  else if (m_cubicPipeline != nullptr) {
+    m_binaryStatsCollector = make_unique<aimd::BinaryStatisticsCollector>(*m_cubicPipeline,
+                                                                          *m_rttEstimator,
+                                                                          *m_rateEstimator,
+                                                                          os, options);
+  }
+  else if (m_tcpbicPipeline != nullptr) {
+    m_binaryStatsCollector = make_unique<aimd::BinaryStatisticsCollector>(*m_tcpbicPipeline,
+                                                                          *m_rttEstimator,
+                                                                          *m_rateEstimator,
+                                                                          os, options);
+  }
+}
+
+uint64_t
+PipelineSetup::getNLossEvents() const
+{
+  if (m_aimdPipeline != nullptr)
+    return m_aimdPipeline->getNLossEvents();
+  if (m_cubicPipeline != nullptr)
+    return m_cubicPipeline->getNLossEvents();
+  if (m_tcpbicPipeline != nullptr)
+    return m_tcpbicPipeline->getNLossEvents();
+  return 0;
+}
+
+} // namespace bench
+} // namespace chunks
+} // namespace ndn
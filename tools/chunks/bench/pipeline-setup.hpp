@@ -0,0 +1,134 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#ifndef NDN_TOOLS_CHUNKS_BENCH_PIPELINE_SETUP_HPP
+#define NDN_TOOLS_CHUNKS_BENCH_PIPELINE_SETUP_HPP
+
+#include "tools/chunks/catchunks/aimd-binary-statistics-collector.hpp"
+#include "tools/chunks/catchunks/aimd-rate-estimator.hpp"
+#include "tools/chunks/catchunks/aimd-rtt-estimator.hpp"
+#include "tools/chunks/catchunks/aimd-statistics-collector.hpp"
+#include "tools/chunks/catchunks/pipeline-interests-aimd.hpp"
+#include "tools/chunks/catchunks/pipeline-interests-cubic.hpp"
+#include "tools/chunks/catchunks/pipeline-interests-fixed-window.hpp"
+#include "tools/chunks/catchunks/pipeline-interests-tcpbic.hpp"
+
+namespace ndn {
+namespace chunks {
+namespace bench {
+
+/**
+ * @brief Parameters of the Interest pipeline under test
+ */
+struct PipelineParameters
+{
+  std::string type = "aimd"; ///< 'fixed', 'aimd', 'cubic' or 'tcpbic'
+  PipelineInterestsFixedWindow::Options fixed;
+  PipelineInterestsAimd::Options aimd;
+  PipelineInterestsCubic::Options cubic;
+  PipelineInterestsTcpBic::Options tcpbic;
+  aimd::RttEstimator::Options rttEstimator;
+  aimd::RateEstimator::Options rateEstimator;
+};
+
+/**
+ * @brief make the parameters of a pipeline from the options shared by the benchmark tools
+ *
+ * @p options is used as the base options of every pipeline, while @p initCwnd, @p aiStep and
+ * @p mdCoef are applied to the aimd, cubic and tcpbic pipelines.
+ */
+PipelineParameters
+makePipelineParameters(const std::string& type, const chunks::Options& options,
+                       size_t maxPipelineSize, int initCwnd, double aiStep, double mdCoef);
+
+/**
+ * @brief Creates an Interest pipeline together with the estimators it depends on
+ *
+ * The pipeline is set up as in ndncatchunks, so that the benchmarks exercise the same code.
+ */
+class PipelineSetup : noncopyable
+{
+public:
+  /**
+   * @throw std::invalid_argument the pipeline type is not valid
+   */
+  PipelineSetup(Face& face, const PipelineParameters& params);
+
+  /**
+   * @brief log the cwnd, rtt and rate statistics in the format of ndncatchunks
+   *
+   * Has no effect on the fixed pipeline, which keeps no such statistics.
+   */
+  void
+  enableStatistics(std::ostream& osCwnd, std::ostream& osRtt, std::ostream& osRate);
+
+  /**
+   * @brief log the same statistics through aimd::BinaryStatisticsCollector
+   *
+   * Has no effect on the fixed pipeline.
+   */
+  void
+  enableBinaryStatistics(std::ostream& os, const aimd::BinaryStatisticsCollector::Options& options =
+                                             aimd::BinaryStatisticsCollector::Options());
+
+  /**
+   * @brief hand the pipeline over to its user, e.g. Consumer::run
+   */
+  unique_ptr<PipelineInterests>
+  releasePipeline()
+  {
+    return std::move(m_pipeline);
+  }
+
+  /**
+   * @return number of loss events of the pipeline, 0 for the fixed pipeline
+   * @pre the pipeline, even if released, still exists
+   */
+  uint64_t
+  getNLossEvents() const;
+
+  /**
+   * @return the RTT estimator, nullptr for the fixed pipeline
+   */
+  aimd::RttEstimator*
+  getRttEstimator() const
+  {
+    return m_rttEstimator.get();
+  }
+
+private:
+  unique_ptr<aimd::RttEstimator> m_rttEstimator;
+  unique_ptr<aimd::RateEstimator> m_rateEstimator;
+  unique_ptr<PipelineInterests> m_pipeline;
+  PipelineInterestsAimd* m_aimdPipeline;
+  PipelineInterestsCubic* m_cubicPipeline;
+  PipelineInterestsTcpBic* m_tcpbicPipeline;
+  unique_ptr<aimd::StatisticsCollector> m_statsCollector;
+  unique_ptr<aimd::BinaryStatisticsCollector> m_binaryStatsCollector;
+};
+
+} // namespace bench
+} // namespace chunks
+} // namespace ndn
+
+#endif // NDN_TOOLS_CHUNKS_BENCH_PIPELINE_SETUP_HPP
@@ -0,0 +1,276 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "aimd-binary-statistics-collector.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <limits>
+
+namespace ndn {
+namespace chunks {
+namespace aimd {
+
+static_assert(sizeof(StatisticsRecord) == 88, "StatisticsRecord must not contain padding");
+
+static const char MAGIC[8] = {'N', 'D', 'N', 'C', 'S', 'T', 'A', 'T'};
+static const uint32_t FORMAT_VERSION = 1;
+
+StatisticsRing::StatisticsRing(size_t capacity)
+  : m_head(0)
+  , m_tail(0)
+{
+  size_t size = 1;
+  while (size < capacity)
+    size <<= 1;
+  m_records.resize(size);
+  m_mask = size - 1;
+}
+
+bool
+StatisticsRing::push(const StatisticsRecord& record)
+{
+  size_t head = m_head.load(std::memory_order_relaxed);
+  if (head - m_tail.load(std::memory_order_acquire) == m_records.size())
+    return false;
+
+  m_records[head & m_mask] = record;
+  m_head.store(head + 1, std::memory_order_release);
+  return true;
+}
+
+size_t
+StatisticsRing::drain(const std::function<void(const StatisticsRecord*, size_t)>& write)
+{
+  size_t tail = m_tail.load(std::memory_order_relaxed);
+  size_t nAvailable = m_head.load(std::memory_order_acquire) - tail;
+  if (nAvailable == 0)
+    return 0;
+
+  // the available records are contiguous in the ring, or wrap around once
+  size_t first = tail & m_mask;
+  size_t nFirst = std::min(nAvailable, m_records.size() - first);
+  write(&m_records[first], nFirst);
+  if (nFirst < nAvailable)
+    write(&m_records[0], nAvailable - nFirst);
+
+  m_tail.store(tail + nAvailable, std::memory_order_release);
+  return nAvailable;
+}
+
+BinaryStatisticsCollector::BinaryStatisticsCollector(RttEstimator& rttEstimator,
+                                                     RateEstimator& rateEstimator,
+                                                     std::ostream& os,
+                                                     const Options& options)
+  : m_options(options)
+  , m_os(os)
+  , m_ring(options.ringSize)
+  , m_nDropped(0)
+  , m_isStopping(false)
+{
+  std::fill(std::begin(m_lastRecordTime), std::end(m_lastRecordTime),
+            -std::numeric_limits<double>::infinity());
+
+  uint32_t header[] = {FORMAT_VERSION, sizeof(StatisticsRecord)};
+  m_os.write(MAGIC, sizeof(MAGIC));
+  m_os.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+  m_rttConnection = rttEstimator.afterRttMeasurement.connect(
+    bind(&BinaryStatisticsCollector::onRttMeasurement, this, _1));
+  m_rateConnection = rateEstimator.afterRateMeasurement.connect(
+    bind(&BinaryStatisticsCollector::onRateMeasurement, this, _1));
+
+  m_writer = std::thread(&BinaryStatisticsCollector::writeRecords, this);
+}
+
+BinaryStatisticsCollector::BinaryStatisticsCollector(PipelineInterestsAimd& pipeline,
+                                                     RttEstimator& rttEstimator,
+                                                     RateEstimator& rateEstimator,
+                                                     std::ostream& os,
+                                                     const Options& options)
+  : BinaryStatisticsCollector(rttEstimator, rateEstimator, os, options)
+{
+  m_cwndConnection = pipeline.afterCwndChange.connect(
+    bind(&BinaryStatisticsCollector::onCwndChange, this, _1, _2));
+}
+
+BinaryStatisticsCollector::BinaryStatisticsCollector(PipelineInterestsCubic& pipeline,
+                                                     RttEstimator& rttEstimator,
+                                                     RateEstimator& rateEstimator,
+                                                     std::ostream& os,
+                                                     const Options& options)
+  : BinaryStatisticsCollector(rttEstimator, rateEstimator, os, options)
+{
+  m_cwndConnection = pipeline.afterCwndChange.connect(
+    bind(&BinaryStatisticsCollector::onCwndChange, this, _1, _2));
+}
+
+BinaryStatisticsCollector::BinaryStatisticsCollector(PipelineInterestsTcpBic& pipeline,
+                                                     RttEstimator& rttEstimator,
+                                                     RateEstimator& rateEstimator,
+                                                     std::ostream& os,
+                                                     const Options& options)
+  : BinaryStatisticsCollector(rttEstimator, rateEstimator, os, options)
+{
+  m_cwndConnection = pipeline.afterCwndChange.connect(
+    bind(&BinaryStatisticsCollector::onCwndChange, this, _1, _2));
+}
+
+BinaryStatisticsCollector::~BinaryStatisticsCollector()
+{
+  m_isStopping.store(true, std::memory_order_release);
+  if (m_writer.joinable())
+    m_writer.join();
+}
+
+void
+BinaryStatisticsCollector::onCwndChange(Milliseconds timeElapsed, double cwnd)
+{
+  StatisticsRecord rec;
+  rec.type = StatisticsRecord::CWND;
+  rec.nValues = 1;
+  rec.segNo = 0;
+  rec.time = timeElapsed.count() / 1000;
+  rec.values[0] = cwnd;
+  record(rec);
+}
+
+void
+BinaryStatisticsCollector::onRttMeasurement(const RttRtoSample& rttSample)
+{
+  StatisticsRecord rec;
+  rec.type = StatisticsRecord::RTT;
+  rec.nValues = 8;
+  rec.segNo = rttSample.segNo;
+  rec.time = rttSample.now;
+  rec.values[0] = rttSample.rtt.count();
+  rec.values[1] = rttSample.rttVar.count();
+  rec.values[2] = rttSample.sRtt.count();
+  rec.values[3] = rttSample.rto.count();
+  rec.values[4] = rttSample.minRtt.count();
+  rec.values[5] = rttSample.rttP50.count();
+  rec.values[6] = rttSample.rttP90.count();
+  rec.values[7] = rttSample.rttP99.count();
+  record(rec);
+}
+
+void
+BinaryStatisticsCollector::onRateMeasurement(const RateSample& rateSample)
+{
+  StatisticsRecord rec;
+  rec.type = StatisticsRecord::RATE;
+  rec.nValues = 4;
+  rec.segNo = 0;
+  rec.time = rateSample.now;
+  rec.values[0] = rateSample.pps;
+  rec.values[1] = rateSample.kbps;
+  rec.values[2] = rateSample.deliveryRate;
+  rec.values[3] = rateSample.maxDeliveryRate;
+  record(rec);
+}
+
+void
+BinaryStatisticsCollector::record(const StatisticsRecord& rec)
+{
+  double& lastTime = m_lastRecordTime[rec.type];
+  if (rec.time - lastTime < m_options.downsampleInterval)
+    return;
+
+  if (m_ring.push(rec))
+    lastTime = rec.time;
+  else
+    ++m_nDropped;
+}
+
+void
+BinaryStatisticsCollector::writeRecords()
+{
+  auto write = [this] (const StatisticsRecord* records, size_t nRecords) {
+    m_os.write(reinterpret_cast<const char*>(records), nRecords * sizeof(StatisticsRecord));
+  };
+
+  while (!m_isStopping.load(std::memory_order_acquire)) {
+    if (m_ring.drain(write) == 0)
+      std::this_thread::sleep_for(std::chrono::nanoseconds(m_options.writerIdleInterval.count()));
+  }
+
+  // the producer is done, write what is left
+  m_ring.drain(write);
+  m_os.flush();
+}
+
+uint64_t
+BinaryStatisticsCollector::convertToTsv(std::istream& is, std::ostream& osCwnd,
+                                        std::ostream& osRtt, std::ostream& osRate)
+{
+  char magic[sizeof(MAGIC)];
+  uint32_t header[2];
+  is.read(magic, sizeof(magic));
+  is.read(reinterpret_cast<char*>(header), sizeof(header));
+  if (!is || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0)
+    throw Error("Not a binary statistics log");
+  if (header[0] != FORMAT_VERSION || header[1] != sizeof(StatisticsRecord))
+    throw Error("Unsupported binary statistics log version " + to_string(header[0]));
+
+  osCwnd << "time\tcwndsize\n";
+  osRtt  << "segment\ttime\trtt\trttvar\tsrtt\trto\tminrtt\tp50\tp90\tp99\n";
+  osRate << "time\tpps\tkbps\tdrate\tmaxdrate\n";
+
+  uint64_t nRecords = 0;
+  StatisticsRecord rec;
+  while (is.read(reinterpret_cast<char*>(&rec), sizeof(rec))) {
+    std::ostream* os = nullptr;
+    switch (rec.type) {
+      case StatisticsRecord::CWND:
+        os = &osCwnd;
+        *os << rec.time;
+        break;
+      case StatisticsRecord::RTT:
+        os = &osRtt;
+        *os << rec.segNo << '\t' << rec.time;
+        break;
+      case StatisticsRecord::RATE:
+        os = &osRate;
+        *os << rec.time;
+        break;
+      default:
+        throw Error("Unknown record type " + to_string(rec.type));
+    }
+
+    uint32_t nValues = std::min<uint32_t>(rec.nValues, sizeof(rec.values) / sizeof(rec.values[0]));
+    for (uint32_t i = 0; i < nValues; ++i)
+      *os << '\t' << rec.values[i];
+    *os << '\n';
+    ++nRecords;
+  }
+
+  if (is.gcount() != 0)
+    throw Error("Truncated binary statistics log");
+
+  return nRecords;
+}
+
+} // namespace aimd
+} // namespace chunks
+} // namespace ndn
@@ -0,0 +1,231 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#ifndef NDN_TOOLS_CHUNKS_CATCHUNKS_AIMD_BINARY_STATISTICS_COLLECTOR_HPP
+#define NDN_TOOLS_CHUNKS_CATCHUNKS_AIMD_BINARY_STATISTICS_COLLECTOR_HPP
+
+#include "pipeline-interests-aimd.hpp"
+#include "pipeline-interests-cubic.hpp"
+#include "pipeline-interests-tcpbic.hpp"
+#include "aimd-rtt-estimator.hpp"
+#include "aimd-rate-estimator.hpp"
+
+#include <atomic>
+#include <functional>
+#include <thread>
+
+namespace ndn {
+namespace chunks {
+namespace aimd {
+
+/**
+ * @brief Fixed-size record of the binary statistics log
+ *
+ * The values are stored in the column order of the corresponding TSV file of
+ * StatisticsCollector, after its time (and segment) column.
+ */
+struct StatisticsRecord
+{
+  enum Type : uint32_t {
+    CWND = 0,
+    RTT = 1,
+    RATE = 2,
+    N_TYPES = 3
+  };
+
+  uint32_t type;
+  uint32_t nValues; ///< number of meaningful entries of values
+  uint64_t segNo; ///< segment number of RTT records, 0 otherwise
+  double time; ///< time since the start of the pipeline (unit: second)
+  double values[8];
+};
+
+/**
+ * @brief Single-producer single-consumer lock-free ring of statistics records
+ *
+ * The producer (the Face thread) never blocks: push() fails when the ring is full.
+ */
+class StatisticsRing : noncopyable
+{
+public:
+  /**
+   * @param capacity number of records, rounded up to a power of two
+   */
+  explicit
+  StatisticsRing(size_t capacity);
+
+  /**
+   * @brief append a record, called by the producer only
+   * @return false if the ring is full and the record was dropped
+   */
+  bool
+  push(const StatisticsRecord& record);
+
+  /**
+   * @brief pass the contiguous runs of available records to @p write, then release them
+   *
+   * Called by the consumer only.
+   * @return number of records consumed
+   */
+  size_t
+  drain(const std::function<void(const StatisticsRecord*, size_t)>& write);
+
+  size_t
+  getCapacity() const
+  {
+    return m_records.size();
+  }
+
+private:
+  std::vector<StatisticsRecord> m_records;
+  size_t m_mask;
+  std::atomic<size_t> m_head; ///< next slot written by the producer
+  std::atomic<size_t> m_tail; ///< next slot read by the consumer
+};
+
+/**
+ * @brief Statistics collector writing binary records from a background thread
+ *
+ * Unlike StatisticsCollector, which formats a text line in the Face thread for every event,
+ * this collector only copies a StatisticsRecord into a StatisticsRing. A writer thread drains
+ * the ring into the output stream. The log starts with a header (magic, format version and
+ * record size) followed by records in the native byte order of the host; convertToTsv()
+ * turns it back into the TSV files produced by StatisticsCollector.
+ *
+ * Records are dropped, and counted, when the writer cannot keep up and the ring is full.
+ */
+class BinaryStatisticsCollector : noncopyable
+{
+public:
+  class Error : public std::runtime_error
+  {
+  public:
+    explicit
+    Error(const std::string& what)
+      : std::runtime_error(what)
+    {
+    }
+  };
+
+  class Options
+  {
+  public:
+    Options()
+      : ringSize(65536)
+      , downsampleInterval(0.0)
+      , writerIdleInterval(time::milliseconds(1))
+    {
+    }
+
+  public:
+    size_t ringSize; ///< capacity of the ring (unit: record)
+    double downsampleInterval; ///< min time between two records of the same type, 0 keeps all (unit: second)
+    time::nanoseconds writerIdleInterval; ///< sleep of the writer thread when the ring is empty
+  };
+
+  BinaryStatisticsCollector(PipelineInterestsAimd& pipeline,
+                            RttEstimator& rttEstimator,
+                            RateEstimator& rateEstimator,
+                            std::ostream& os,
+                            const Options& options = Options());
+
+  BinaryStatisticsCollector(PipelineInterestsCubic& pipeline,
+                            RttEstimator& rttEstimator,
+                            RateEstimator& rateEstimator,
+                            std::ostream& os,
+                            const Options& options = Options());
+
+  BinaryStatisticsCollector(PipelineInterestsTcpBic& pipeline,
+                            RttEstimator& rttEstimator,
+                            RateEstimator& rateEstimator,
+                            std::ostream& os,
+                            const Options& options = Options());
+
+  /**
+   * @brief stop the writer thread after it wrote the remaining records
+   */
+  ~BinaryStatisticsCollector();
+
+  /**
+   * @return number of records dropped because the ring was full
+   */
+  uint64_t
+  getNDroppedRecords() const
+  {
+    return m_nDropped;
+  }
+
+  /**
+   * @brief convert a binary statistics log into the TSV files of StatisticsCollector
+   *
+   * @return number of records converted
+   * @throw Error the log is truncated or was not written by this collector
+   */
+  static uint64_t
+  convertToTsv(std::istream& is, std::ostream& osCwnd, std::ostream& osRtt, std::ostream& osRate);
+
+PUBLIC_WITH_TESTS_ELSE_PRIVATE:
+  void
+  onCwndChange(Milliseconds timeElapsed, double cwnd);
+
+  void
+  onRttMeasurement(const RttRtoSample& rttSample);
+
+  void
+  onRateMeasurement(const RateSample& rateSample);
+
+private:
+  BinaryStatisticsCollector(RttEstimator& rttEstimator,
+                            RateEstimator& rateEstimator,
+                            std::ostream& os,
+                            const Options& options);
+
+  /**
+   * @brief apply the downsampling and push @p record into the ring
+   */
+  void
+  record(const StatisticsRecord& record);
+
+  void
+  writeRecords();
+
+private:
+  const Options m_options;
+  std::ostream& m_os;
+  StatisticsRing m_ring;
+  double m_lastRecordTime[StatisticsRecord::N_TYPES];
+  uint64_t m_nDropped;
+
+  std::atomic<bool> m_isStopping;
+  std::thread m_writer;
+
+  signal::ScopedConnection m_cwndConnection;
+  signal::ScopedConnection m_rttConnection;
+  signal::ScopedConnection m_rateConnection;
+};
+
+} // namespace aimd
+} // namespace chunks
+} // namespace ndn
+
+#endif // NDN_TOOLS_CHUNKS_CATCHUNKS_AIMD_BINARY_STATISTICS_COLLECTOR_HPP
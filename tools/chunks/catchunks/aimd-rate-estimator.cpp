@@ -27,27 +27,66 @@ namespace ndn {
 namespace chunks {
 namespace aimd {
 
-RateEstimator::RateEstimator(double rateInterval)
-  : m_rateInterval(rateInterval)
+RateEstimator::RateEstimator(const Options& options)
+  : m_options(options)
+  , m_nDelivered(0)
+  , m_deliveredTime(std::numeric_limits<double>::quiet_NaN())
+  , m_deliveryRate(std::numeric_limits<double>::quiet_NaN())
 {
+  if (m_options.isVerbose) {
+    std::cerr << m_options;
+  }
 }
 
 void
 RateEstimator::addMeasurement(double now, uint64_t nPackets, uint64_t nBits)
 {
-  double pps = nPackets / m_rateInterval;
-  double kbps = (nBits / m_rateInterval) / 1000;
+  double pps = nPackets / m_options.rateInterval;
+  double kbps = (nBits / m_options.rateInterval) / 1000;
 
-  afterRateMeasurement({now, pps, kbps});
+  afterRateMeasurement({now, pps, kbps, getDeliveryRate(), getMaxDeliveryRate()});
 }
 
-// std::ostream&
-// operator<<(std::ostream& os, double rateInterval)
-// {
-//   os << "RateEstimator initial parameters:\n"
-//      << "\tRate Interval = " << rateInterval << "\n";
-//   return os;
-// }
+DeliveryState
+RateEstimator::onInterestSent(double now)
+{
+  if (std::isnan(m_deliveredTime)) { // nothing delivered yet, start measuring from now
+    m_deliveredTime = now;
+  }
+  return {m_nDelivered, m_deliveredTime};
+}
+
+void
+RateEstimator::addDeliverySample(double now, const DeliveryState& state, Milliseconds rtt)
+{
+  m_nDelivered++;
+  m_deliveredTime = now;
+
+  double interval = now - state.deliveredTime;
+  if (!(interval > 0)) // cannot take a sample
+    return;
+
+  double rate = (m_nDelivered - state.nDelivered) / interval;
+  if (std::isnan(m_deliveryRate)) { // first sample
+    m_deliveryRate = rate;
+  }
+  else {
+    m_deliveryRate = (1 - m_options.alpha) * m_deliveryRate + m_options.alpha * rate;
+  }
+
+  double window = m_options.maxFilterRtts * rtt.count() / 1000;
+  m_maxDeliveryRate.update(now, rate, window);
+}
+
+std::ostream&
+operator<<(std::ostream& os, const RateEstimator::Options& options)
+{
+  os << "RateEstimator initial parameters:\n"
+     << "\tRate interval = " << options.rateInterval << "\n"
+     << "\tAlpha = " << options.alpha << "\n"
+     << "\tMax filter window (RTTs) = " << options.maxFilterRtts << "\n";
+  return os;
+}
 
 } // namespace aimd
 } // namespace chunks
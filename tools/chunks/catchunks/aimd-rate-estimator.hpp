@@ -24,6 +24,7 @@
 #define NDN_TOOLS_CHUNKS_CATCHUNKS_AIMD_RATE_ESTIMATOR_HPP
 
 #include "core/common.hpp"
+#include "windowed-filter.hpp"
 
 namespace ndn {
 namespace chunks {
@@ -36,46 +37,133 @@ struct RateSample
   double now;
   double pps;
   double kbps;
+  double deliveryRate; ///< smoothed delivery rate (segments/s)
+  double maxDeliveryRate; ///< windowed maximum of the delivery rate (segments/s)
+};
+
+/**
+ * @brief Delivery progress recorded when an Interest is sent
+ */
+struct DeliveryState
+{
+  uint64_t nDelivered; ///< # of segments delivered so far
+  double deliveredTime; ///< time of the most recent delivery (in seconds)
 };
 
 /**
  * @brief Rate Estimator.
  *
+ * Measures the rate of received Data in two ways:
+ *  - the number of packets and bits received during each rate interval, which is reported
+ *    through afterRateMeasurement;
+ *  - the delivery rate, sampled for each received segment as the number of segments delivered
+ *    between the transmission of its Interest and its arrival, divided by the elapsed time.
+ *    The samples are smoothed with an EWMA, and a windowed max filter tracks the highest rate
+ *    of the last few RTTs, which estimates the bottleneck bandwidth. Pipelines can use these
+ *    values for pacing or to cap their window to the bandwidth-delay product.
  */
 class RateEstimator
 {
 public:
-
+  class Options
+  {
+  public:
+    Options()
+      : isVerbose(false)
+      , rateInterval(0.1)
+      , alpha(0.125)
+      , maxFilterRtts(10)
+    {
+    }
+
+  public:
+    bool isVerbose;
+    double rateInterval; ///< interval between rate measurements (in seconds)
+    double alpha; ///< weight of a new sample in the smoothed delivery rate
+    int maxFilterRtts; ///< length of the max filter window (in RTTs)
+  };
 
   /**
-   * @brief create a RTT Estimator
+   * @brief create a Rate Estimator
    *
-   * Configures the RTT Estimator with the default parameters if an instance of Options
+   * Configures the Rate Estimator with the default parameters if an instance of Options
    * is not passed to the constructor.
-   */ 
+   */
   explicit
-  RateEstimator(double rateInterval);
-
+  RateEstimator(const Options& options = Options());
 
+  /**
+   * @brief report the packets and bits received during the last rate interval
+   */
   void
   addMeasurement(double now, uint64_t nPackets, uint64_t nBits);
 
+  /**
+   * @brief record the delivery progress when an Interest is sent
+   *
+   * @param now current time (in seconds)
+   * @return the state to be passed to addDeliverySample when the segment is received
+   */
+  DeliveryState
+  onInterestSent(double now);
+
+  /**
+   * @brief add a delivery rate sample for a received segment
+   *
+   * @param now current time (in seconds)
+   * @param state delivery progress recorded when the Interest for the segment was sent
+   * @param rtt current RTT estimate, used to size the max filter window
+   */
+  void
+  addDeliverySample(double now, const DeliveryState& state, Milliseconds rtt);
+
+  /**
+   * @return smoothed delivery rate (segments/s), NaN if no sample has been taken yet
+   */
+  double
+  getDeliveryRate() const
+  {
+    return m_deliveryRate;
+  }
+
+  /**
+   * @return highest delivery rate of the last Options::maxFilterRtts RTTs (segments/s),
+   *         NaN if no sample has been taken yet
+   */
+  double
+  getMaxDeliveryRate() const
+  {
+    return m_maxDeliveryRate.empty() ? std::numeric_limits<double>::quiet_NaN()
+                                     : m_maxDeliveryRate.get();
+  }
+
+  /**
+   * @return estimated bandwidth-delay product (in segments) for the given minimum RTT
+   */
+  double
+  getBdp(Milliseconds minRtt) const
+  {
+    return getMaxDeliveryRate() * minRtt.count() / 1000;
+  }
+
   /**
    * @brief Signals after rate is measured
    */
   signal::Signal<RateEstimator, RateSample> afterRateMeasurement;
 
-
 PUBLIC_WITH_TESTS_ELSE_PRIVATE:
-  double m_rateInterval;
+  const Options m_options;
+  uint64_t m_nDelivered; ///< total # of segments delivered
+  double m_deliveredTime; ///< time of the most recent delivery, NaN before the first Interest
+  double m_deliveryRate; ///< smoothed delivery rate
+  WindowedMaxFilter<double> m_maxDeliveryRate;
 };
 
-
-// std::ostream&
-// operator<<(std::ostream& os, double rateInterval);
+std::ostream&
+operator<<(std::ostream& os, const RateEstimator::Options& options);
 
 } // namespace aimd
 } // namespace chunks
 } // namespace ndn
 
-#endif // NDN_TOOLS_CHUNKS_CATCHUNKS_RTT_ESTIMATOR_HPP
+#endif // NDN_TOOLS_CHUNKS_CATCHUNKS_AIMD_RATE_ESTIMATOR_HPP
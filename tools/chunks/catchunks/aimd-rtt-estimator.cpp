@@ -33,6 +33,9 @@ RttEstimator::RttEstimator(const Options& options)
   , m_sRtt(std::numeric_limits<double>::quiet_NaN())
   , m_rttVar(std::numeric_limits<double>::quiet_NaN())
   , m_rto(m_options.initialRto.count())
+  , m_rttP50(0.5)
+  , m_rttP90(0.9)
+  , m_rttP99(0.99)
 {
   if (m_options.isVerbose) {
     std::cerr << m_options;
@@ -59,7 +62,13 @@ RttEstimator::addMeasurement(uint64_t segNo, double now, Milliseconds rtt, size_
 
   m_rto = ndn::clamp(m_rto, m_options.minRto, m_options.maxRto);
 
-  afterRttMeasurement({segNo, now, rtt, m_sRtt, m_rttVar, m_rto});
+  m_minRtt.update(now, rtt, m_options.minRttWindow.count() / 1000);
+  m_rttP50.add(rtt.count());
+  m_rttP90.add(rtt.count());
+  m_rttP99.add(rtt.count());
+
+  afterRttMeasurement({segNo, now, rtt, m_sRtt, m_rttVar, m_rto,
+                       getMinRtt(), getRttP50(), getRttP90(), getRttP99()});
 }
 
 void
@@ -78,7 +87,8 @@ operator<<(std::ostream& os, const RttEstimator::Options& options)
      << "\tK = " << options.k << "\n"
      << "\tInitial RTO = " << options.initialRto << "\n"
      << "\tMin RTO = " << options.minRto << "\n"
-     << "\tMax RTO = " << options.maxRto << "\n";
+     << "\tMax RTO = " << options.maxRto << "\n"
+     << "\tMin RTT window = " << options.minRttWindow << "\n";
   return os;
 }
 
@@ -25,6 +25,8 @@
 #define NDN_TOOLS_CHUNKS_CATCHUNKS_AIMD_RTT_ESTIMATOR_HPP
 
 #include "core/common.hpp"
+#include "streaming-quantile.hpp"
+#include "windowed-filter.hpp"
 
 namespace ndn {
 namespace chunks {
@@ -40,6 +42,10 @@ struct RttRtoSample
   Milliseconds sRtt; ///< smoothed RTT
   Milliseconds rttVar; ///< RTT variation
   Milliseconds rto; ///< retransmission timeout
+  Milliseconds minRtt; ///< minimum RTT within the min RTT window
+  Milliseconds rttP50; ///< estimated median of the RTT samples
+  Milliseconds rttP90; ///< estimated 90th percentile of the RTT samples
+  Milliseconds rttP99; ///< estimated 99th percentile of the RTT samples
 };
 
 /**
@@ -47,6 +53,10 @@ struct RttRtoSample
  *
  * This class implements the "Mean--Deviation" RTT estimator, as discussed in RFC6298,
  * with the modifications to RTO calculation described in RFC 7323 Appendix G.
+ *
+ * In addition, it tracks the minimum RTT over a sliding time window, so that the estimate
+ * follows path changes, and streaming estimates of the median, 90th and 99th percentiles
+ * of all RTT samples.
  */
 class RttEstimator
 {
@@ -63,6 +73,7 @@ public:
       , minRto(200.0)
       , maxRto(20000.0)
       , rtoBackoffMultiplier(2)
+      , minRttWindow(10000.0)
     {
     }
 
@@ -75,6 +86,7 @@ public:
     Milliseconds minRto; ///< lower bound of RTO
     Milliseconds maxRto; ///< upper bound of RTO
     int rtoBackoffMultiplier;
+    Milliseconds minRttWindow; ///< length of the time window of the min RTT filter
   };
 
   /**
@@ -86,11 +98,18 @@ public:
   explicit
   RttEstimator(const Options& options = Options());
 
+  const Options&
+  getOptions() const
+  {
+    return m_options;
+  }
+
   /**
    * @brief Add a new RTT measurement to the estimator for the given received segment.
    *
    * @note Don't take RTT measurement for retransmitted segments
    * @param segNo the segment number of the received segmented Data
+   * @param now current time (in seconds), used to expire old samples from the min RTT filter
    * @param rtt the sampled rtt
    * @param nExpectedSamples number of expected samples, must be greater than 0.
    *        It should be set to current number of in-flight Interests. Please
@@ -110,6 +129,41 @@ public:
   {
     return m_sRtt;
   }
+
+  /**
+   * @return minimum RTT measured within the last Options::minRttWindow,
+   *         NaN if no measurement has been taken yet
+   */
+  Milliseconds
+  getMinRtt() const;
+
+  /**
+   * @return estimated median RTT, NaN if no measurement has been taken yet
+   */
+  Milliseconds
+  getRttP50() const
+  {
+    return Milliseconds(m_rttP50.get());
+  }
+
+  /**
+   * @return estimated 90th percentile of RTT, NaN if no measurement has been taken yet
+   */
+  Milliseconds
+  getRttP90() const
+  {
+    return Milliseconds(m_rttP90.get());
+  }
+
+  /**
+   * @return estimated 99th percentile of RTT, NaN if no measurement has been taken yet
+   */
+  Milliseconds
+  getRttP99() const
+  {
+    return Milliseconds(m_rttP99.get());
+  }
+
   /**
    * @brief backoff RTO by the factor of RttEstimatorOptions::rtoBackoffMultiplier
    */
@@ -126,6 +180,10 @@ PUBLIC_WITH_TESTS_ELSE_PRIVATE:
   Milliseconds m_sRtt; ///< smoothed round-trip time
   Milliseconds m_rttVar; ///< round-trip time variation
   Milliseconds m_rto; ///< retransmission timeout
+  WindowedMinFilter<Milliseconds> m_minRtt; ///< windowed minimum round-trip time
+  StreamingQuantile m_rttP50;
+  StreamingQuantile m_rttP90;
+  StreamingQuantile m_rttP99;
 };
 
 /**
@@ -137,6 +195,13 @@ RttEstimator::getEstimatedRto() const
   return m_rto;
 }
 
+inline Milliseconds
+RttEstimator::getMinRtt() const
+{
+  return m_minRtt.empty() ? Milliseconds(std::numeric_limits<double>::quiet_NaN())
+                          : m_minRtt.get();
+}
+
 std::ostream&
 operator<<(std::ostream& os, const RttEstimator::Options& options);
 
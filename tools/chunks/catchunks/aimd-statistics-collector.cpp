@@ -39,8 +39,8 @@ StatisticsCollector::StatisticsCollector(PipelineInterestsAimd& pipeline,
   , m_osRate(osRate)
 {
   m_osCwnd << "time\tcwndsize\n";
-  m_osRtt  << "segment\ttime\trtt\trttvar\tsrtt\trto\n";
-  m_osRate << "time\tpps\tkbps\n";
+  m_osRtt  << "segment\ttime\trtt\trttvar\tsrtt\trto\tminrtt\tp50\tp90\tp99\n";
+  m_osRate << "time\tpps\tkbps\tdrate\tmaxdrate\n";
   pipeline.afterCwndChange.connect(
     [this] (Milliseconds timeElapsed, double cwnd) {
       m_osCwnd << timeElapsed.count() / 1000 << '\t' << cwnd << '\n';
@@ -52,13 +52,19 @@ StatisticsCollector::StatisticsCollector(PipelineInterestsAimd& pipeline,
               << rttSample.rtt.count() << '\t'
               << rttSample.rttVar.count() << '\t'
               << rttSample.sRtt.count() << '\t'
-              << rttSample.rto.count() << '\n';
+              << rttSample.rto.count() << '\t'
+              << rttSample.minRtt.count() << '\t'
+              << rttSample.rttP50.count() << '\t'
+              << rttSample.rttP90.count() << '\t'
+              << rttSample.rttP99.count() << '\n';
     });
   rateEstimator.afterRateMeasurement.connect(
     [this] (const RateSample& rateSample) {
       m_osRate << rateSample.now << '\t'
                << rateSample.pps << '\t'
-               << rateSample.kbps << '\n';
+               << rateSample.kbps << '\t'
+               << rateSample.deliveryRate << '\t'
+               << rateSample.maxDeliveryRate << '\n';
     });
 }
 
@@ -73,8 +79,8 @@ StatisticsCollector::StatisticsCollector(PipelineInterestsCubic& pipeline,
   , m_osRate(osRate)
 {
   m_osCwnd << "time\tcwndsize\n";
-  m_osRtt  << "segment\ttime\trtt\trttvar\tsrtt\trto\n";
-  m_osRate << "time\tpps\tkbps\n";
+  m_osRtt  << "segment\ttime\trtt\trttvar\tsrtt\trto\tminrtt\tp50\tp90\tp99\n";
+  m_osRate << "time\tpps\tkbps\tdrate\tmaxdrate\n";
   pipeline.afterCwndChange.connect(
     [this] (Milliseconds timeElapsed, double cwnd) {
       m_osCwnd << timeElapsed.count() / 1000 << '\t' << cwnd << '\n';
@@ -86,13 +92,19 @@ StatisticsCollector::StatisticsCollector(PipelineInterestsCubic& pipeline,
              << rttSample.rtt.count() << '\t'
              << rttSample.rttVar.count() << '\t'
              << rttSample.sRtt.count() << '\t'
-             << rttSample.rto.count() << '\n';
+             << rttSample.rto.count() << '\t'
+             << rttSample.minRtt.count() << '\t'
+             << rttSample.rttP50.count() << '\t'
+             << rttSample.rttP90.count() << '\t'
+             << rttSample.rttP99.count() << '\n';
     });
   rateEstimator.afterRateMeasurement.connect(
     [this] (const RateSample& rateSample) {
       m_osRate << rateSample.now << '\t'
                << rateSample.pps << '\t'
-               << rateSample.kbps << '\n';
+               << rateSample.kbps << '\t'
+               << rateSample.deliveryRate << '\t'
+               << rateSample.maxDeliveryRate << '\n';
     });
 }
 
@@ -107,8 +119,8 @@ StatisticsCollector::StatisticsCollector(PipelineInterestsTcpBic& pipeline,
   , m_osRate(osRate)
 {
   m_osCwnd << "time\tcwndsize\n";
-  m_osRtt  << "segment\ttime\trtt\trttvar\tsrtt\trto\n";
-  m_osRate << "time\tpps\tkbps\n";
+  m_osRtt  << "segment\ttime\trtt\trttvar\tsrtt\trto\tminrtt\tp50\tp90\tp99\n";
+  m_osRate << "time\tpps\tkbps\tdrate\tmaxdrate\n";
   pipeline.afterCwndChange.connect(
     [this] (Milliseconds timeElapsed, double cwnd) {
       m_osCwnd << timeElapsed.count() / 1000 << '\t' << cwnd << '\n';
@@ -120,13 +132,19 @@ StatisticsCollector::StatisticsCollector(PipelineInterestsTcpBic& pipeline,
              << rttSample.rtt.count() << '\t'
              << rttSample.rttVar.count() << '\t'
              << rttSample.sRtt.count() << '\t'
-             << rttSample.rto.count() << '\n';
+             << rttSample.rto.count() << '\t'
+             << rttSample.minRtt.count() << '\t'
+             << rttSample.rttP50.count() << '\t'
+             << rttSample.rttP90.count() << '\t'
+             << rttSample.rttP99.count() << '\n';
     });
   rateEstimator.afterRateMeasurement.connect(
     [this] (const RateSample& rateSample) {
       m_osRate << rateSample.now << '\t'
                << rateSample.pps << '\t'
-               << rateSample.kbps << '\n';
+               << rateSample.kbps << '\t'
+               << rateSample.deliveryRate << '\t'
+               << rateSample.maxDeliveryRate << '\n';
     });
 }
 
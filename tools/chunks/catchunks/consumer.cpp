@@ -26,6 +26,9 @@
  */
 
 #include "consumer.hpp"
+#include "memory-usage.hpp"
+
+#include <limits>
 
 namespace ndn {
 namespace chunks {
@@ -35,25 +38,103 @@ Consumer::Consumer(Validator& validator, bool isVerbose, std::ostream& os)
   , m_outputStream(os)
   , m_nextToPrint(0)
   , m_isVerbose(isVerbose)
+  , m_maxBufferedSegments(0)
+  , m_nBufferedBytes(0)
+  , m_maxBufferedBytes(0)
+  , m_nWrittenBytes(0)
+  , m_backpressureThreshold(0)
+  , m_clock(&PipelineClock::getDefault())
+  , m_tracer(nullptr)
+  , m_writer(nullptr)
+  , m_nextToDigest(0)
+  , m_hasCompleted(false)
+  , m_hasRange(false)
+  , m_firstSegmentNo(0)
+  , m_rangeLastSegmentNo(0)
+  , m_hasByteRange(false)
+  , m_firstByte(0)
+  , m_lastByte(0)
+  , m_firstByteOffset(0)
+  , m_lastSegmentEnd(0)
+  , m_lastSegmentNo(0)
+  , m_hasLastSegment(false)
 {
 }
 
+void
+Consumer::setSegmentRange(uint64_t first, uint64_t last)
+{
+  BOOST_ASSERT(first <= last);
+  m_hasRange = true;
+  m_hasByteRange = false;
+  m_firstSegmentNo = first;
+  m_rangeLastSegmentNo = last;
+}
+
+void
+Consumer::setByteRange(uint64_t first, uint64_t last)
+{
+  BOOST_ASSERT(first <= last);
+  m_hasRange = true;
+  m_hasByteRange = true;
+  m_firstByte = first;
+  m_lastByte = last;
+}
+
 void
 Consumer::run(unique_ptr<DiscoverVersion> discover, unique_ptr<PipelineInterests> pipeline)
 {
   m_discover = std::move(discover);
   m_pipeline = std::move(pipeline);
   m_nextToPrint = 0;
+  m_hasLastSegment = false;
   m_bufferedData.clear();
+  m_maxBufferedSegments = 0;
+  m_nBufferedBytes = 0;
+  m_maxBufferedBytes = 0;
+  m_nWrittenBytes = 0;
+  m_segmentsInWriter.clear();
+  m_nextToDigest = 0;
+  m_hasCompleted = false;
+  if (m_sha256 != nullptr)
+    m_sha256->reset();
 
   m_discover->onDiscoverySuccess.connect(bind(&Consumer::startPipeline, this, _1));
   m_discover->onDiscoveryFailure.connect(bind(&Consumer::onFailure, this, _1));
+  m_discover->onNewerVersion.connect(bind(&Consumer::onNewerVersion, this, _1));
   m_discover->run();
 }
 
 void
 Consumer::startPipeline(const Data& data)
 {
+  if (m_hasByteRange) {
+    uint64_t segNo = data.getName()[-1].toSegment();
+    size_t segmentSize = data.getContent().value_size();
+    bool isLastSegment = !data.getFinalBlockId().empty() &&
+                         data.getFinalBlockId().toSegment() == segNo;
+    // the last segment may be shorter than the others, unless it is the only one
+    if (segmentSize == 0 || (isLastSegment && segNo != 0))
+      return onFailure("Cannot learn the segment size of the content from segment #" +
+                       to_string(segNo));
+
+    m_firstSegmentNo = m_firstByte / segmentSize;
+    m_rangeLastSegmentNo = m_lastByte / segmentSize;
+    m_firstByteOffset = m_firstByte % segmentSize;
+    m_lastSegmentEnd = m_lastByte % segmentSize + 1;
+  }
+
+  if (m_hasRange) {
+    if (!data.getFinalBlockId().empty() && data.getFinalBlockId().toSegment() < m_firstSegmentNo)
+      return onFailure("The requested range starts after the end of the content");
+
+    m_nextToPrint = m_firstSegmentNo;
+    m_nextToDigest = m_firstSegmentNo;
+    m_lastSegmentNo = m_rangeLastSegmentNo;
+    m_hasLastSegment = true;
+    m_pipeline->setSegmentRange(m_firstSegmentNo, m_rangeLastSegmentNo);
+  }
+
   m_validator.validate(data,
                        bind(&Consumer::onDataValidated, this, _1),
                        bind(&Consumer::onFailure, this, _2));
@@ -82,8 +163,125 @@ Consumer::onDataValidated(shared_ptr<const Data> data)
     throw ApplicationNackError(*data);
   }
 
-  m_bufferedData[data->getName()[-1].toSegment()] = data;
+  if (!data->getFinalBlockId().empty()) {
+    // the end of a requested range is lowered to the end of the content
+    uint64_t finalSegNo = data->getFinalBlockId().toSegment();
+    if (!m_hasLastSegment || (m_hasRange && finalSegNo < m_lastSegmentNo)) {
+      m_lastSegmentNo = finalSegNo;
+      m_hasLastSegment = true;
+    }
+  }
+
+  uint64_t segNo = data->getName()[-1].toSegment();
+  if (m_tracer != nullptr)
+    m_tracer->record(segNo, SegmentTracer::DATA_VALIDATED, m_clock->now());
+
+  bufferData(std::move(data));
+  processBufferedData();
+}
+
+void
+Consumer::processBufferedData()
+{
   writeInOrderData();
+  updateBackpressure();
+
+  if (!m_hasCompleted && isComplete()) {
+    m_hasCompleted = true;
+    // everything has been written, a speculative discovery need not be confirmed any longer
+    if (m_discover != nullptr)
+      m_discover->cancel();
+    afterComplete();
+  }
+}
+
+uint64_t
+Consumer::getNWrittenBytes() const
+{
+  return m_writer != nullptr ? m_writer->getNWrittenBytes() : m_nWrittenBytes;
+}
+
+void
+Consumer::setClock(const PipelineClock& clock)
+{
+  m_clock = &clock;
+  if (m_tracer != nullptr && m_writer != nullptr)
+    m_writer->enableWriteTimes(*m_clock);
+}
+
+void
+Consumer::setTracer(SegmentTracer* tracer)
+{
+  m_tracer = tracer;
+  if (m_tracer != nullptr && m_writer != nullptr)
+    m_writer->enableWriteTimes(*m_clock);
+}
+
+void
+Consumer::setOutputWriter(OutputWriter* writer)
+{
+  m_writer = writer;
+  if (m_writer != nullptr) {
+    m_writer->setSpaceCallback(bind(&Consumer::processBufferedData, this));
+    m_writer->setFailureCallback(bind(&Consumer::onWriterFailure, this, _1));
+    if (m_tracer != nullptr)
+      m_writer->enableWriteTimes(*m_clock);
+  }
+}
+
+void
+Consumer::flushOutput()
+{
+  if (m_writer == nullptr) {
+    m_outputStream.flush();
+    return;
+  }
+
+  m_writer->flush();
+  traceWrittenSegments();
+}
+
+void
+Consumer::traceWrittenSegments()
+{
+  if (m_tracer == nullptr || m_writer == nullptr)
+    return;
+
+  m_writer->takeWriteTimes(m_writeTimes);
+  for (const auto& writeTime : m_writeTimes) {
+    if (m_segmentsInWriter.empty())
+      break;
+    m_tracer->record(m_segmentsInWriter.front(), SegmentTracer::DATA_WRITTEN, writeTime);
+    m_segmentsInWriter.pop_front();
+  }
+}
+
+std::string
+Consumer::getDigest()
+{
+  if (m_sha256 == nullptr)
+    return "";
+  return m_sha256->toString();
+}
+
+double
+Consumer::getProgress() const
+{
+  if (!m_hasLastSegment)
+    return std::numeric_limits<double>::quiet_NaN();
+
+  return static_cast<double>(m_nextToPrint - m_firstSegmentNo) /
+         (m_lastSegmentNo - m_firstSegmentNo + 1);
+}
+
+void
+Consumer::onNewerVersion(const Data& data)
+{
+  // the retrieved segments have already been written out, so the retrieval cannot be
+  // restarted on the newer version
+  m_pipeline->cancel();
+  onFailure("A newer version was discovered during the retrieval: " +
+            data.getName().getPrefix(-1).toUri());
 }
 
 void
@@ -92,14 +290,131 @@ Consumer::onFailure(const std::string& reason)
   throw std::runtime_error(reason);
 }
 
+void
+Consumer::onWriterFailure(const std::string& reason)
+{
+  // stop fetching segments that cannot be written
+  if (m_discover != nullptr)
+    m_discover->cancel();
+  if (m_pipeline != nullptr)
+    m_pipeline->cancel();
+  throw OutputWriter::Error(reason);
+}
+
+void
+Consumer::bufferData(shared_ptr<const Data> data)
+{
+  uint64_t segNo = data->getName()[-1].toSegment();
+  if (segNo < m_nextToPrint || (m_hasRange && segNo > m_rangeLastSegmentNo))
+    return;
+
+  if (m_hasByteRange && (segNo == m_firstSegmentNo || segNo == m_rangeLastSegmentNo))
+    data = trimToByteRange(*data);
+
+  shared_ptr<const Data>& entry = m_bufferedData[segNo];
+  if (entry != nullptr)
+    m_nBufferedBytes -= entry->getContent().value_size();
+  entry = std::move(data);
+  m_nBufferedBytes += entry->getContent().value_size();
+
+  m_maxBufferedSegments = std::max(m_maxBufferedSegments, m_bufferedData.size());
+  m_maxBufferedBytes = std::max(m_maxBufferedBytes, m_nBufferedBytes);
+  checkMemoryLimits(segNo);
+}
+
+shared_ptr<const Data>
+Consumer::trimToByteRange(const Data& data) const
+{
+  uint64_t segNo = data.getName()[-1].toSegment();
+  const Block& content = data.getContent();
+
+  size_t end = segNo == m_rangeLastSegmentNo ? std::min(m_lastSegmentEnd, content.value_size())
+                                             : content.value_size();
+  size_t begin = segNo == m_firstSegmentNo ? std::min(m_firstByteOffset, end) : 0;
+
+  auto trimmed = make_shared<Data>(data.getName());
+  trimmed->setContent(content.value() + begin, end - begin);
+  return trimmed;
+}
+
+void
+Consumer::checkMemoryLimits(uint64_t segNo)
+{
+  std::string reason;
+  if (m_limits.maxBufferedSegments > 0 && m_bufferedData.size() > m_limits.maxBufferedSegments) {
+    reason = "The reorder buffer exceeds " + to_string(m_limits.maxBufferedSegments) + " segments";
+  }
+  else if (m_limits.maxBufferedBytes > 0 && m_nBufferedBytes > m_limits.maxBufferedBytes) {
+    reason = "The reorder buffer exceeds " + to_string(m_limits.maxBufferedBytes) + " bytes";
+  }
+  // getrusage is a system call, so the resident set size is checked every 64 segments only
+  else if (m_limits.maxRss > 0 && segNo % 64 == 0) {
+    uint64_t rss = getPeakRss();
+    if (rss > m_limits.maxRss)
+      reason = "The resident set size reached " + to_string(rss) + " kB, over the limit of " +
+               to_string(m_limits.maxRss) + " kB";
+  }
+
+  if (reason.empty())
+    return;
+
+  if (m_pipeline != nullptr)
+    m_pipeline->cancel();
+  onFailure(reason);
+}
+
+void
+Consumer::updateBackpressure()
+{
+  if (m_backpressureThreshold == 0 || m_pipeline == nullptr)
+    return;
+
+  if (m_nBufferedBytes >= m_backpressureThreshold) {
+    if (m_isVerbose && !m_pipeline->hasBackpressure())
+      std::cerr << "Reorder buffer full, waiting for segment #" << m_nextToPrint << std::endl;
+    m_pipeline->applyBackpressure(m_nextToPrint);
+  }
+  else {
+    m_pipeline->releaseBackpressure();
+  }
+}
+
 void
 Consumer::writeInOrderData()
 {
+  // the segments written by this call share one timestamp
+  time::steady_clock::TimePoint now;
+  if (m_tracer != nullptr) {
+    now = m_clock->now();
+    traceWrittenSegments();
+  }
+
   for (auto it = m_bufferedData.begin();
        it != m_bufferedData.end() && it->first == m_nextToPrint;
        it = m_bufferedData.erase(it), ++m_nextToPrint) {
     const Block& content = it->second->getContent();
-    m_outputStream.write(reinterpret_cast<const char*>(content.value()), content.value_size());
+    size_t size = content.value_size();
+    // a segment the writer cannot take yet is digested only once, before the first attempt
+    if (m_sha256 != nullptr && m_nextToDigest == m_nextToPrint) {
+      m_sha256->update(content.value(), size);
+      ++m_nextToDigest;
+    }
+
+    if (m_writer != nullptr) {
+      // the queue of the writer is full, the space callback resumes writing
+      if (!m_writer->push(it->second))
+        break;
+      // traced once the writer thread has written it
+      if (m_tracer != nullptr)
+        m_segmentsInWriter.push_back(it->first);
+    }
+    else {
+      m_outputStream.write(reinterpret_cast<const char*>(content.value()), size);
+      m_nWrittenBytes += size;
+      if (m_tracer != nullptr)
+        m_tracer->record(it->first, SegmentTracer::DATA_WRITTEN, now);
+    }
+    m_nBufferedBytes -= size;
   }
 }
 
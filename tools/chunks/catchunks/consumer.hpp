@@ -29,9 +29,11 @@
 #define NDN_TOOLS_CHUNKS_CATCHUNKS_CONSUMER_HPP
 
 #include "discover-version.hpp"
+#include "output-writer.hpp"
 #include "pipeline-interests.hpp"
 
 #include <ndn-cxx/security/validator.hpp>
+#include <ndn-cxx/util/sha256.hpp>
 
 namespace ndn {
 namespace chunks {
@@ -45,6 +47,12 @@ namespace chunks {
  */
 class Consumer : noncopyable
 {
+public: // signals
+  /**
+   * @brief Signal emitted once every segment has been written, or handed to the OutputWriter
+   */
+  signal::Signal<Consumer> afterComplete;
+
 public:
   class ApplicationNackError : public std::runtime_error
   {
@@ -56,17 +64,199 @@ public:
     }
   };
 
+  /**
+   * @brief Limits on the memory used by a retrieval, 0 means no limit
+   *
+   * The retrieval fails when one of them is exceeded.
+   */
+  class MemoryLimits
+  {
+  public:
+    MemoryLimits()
+      : maxBufferedSegments(0)
+      , maxBufferedBytes(0)
+      , maxRss(0)
+    {
+    }
+
+  public:
+    size_t maxBufferedSegments; ///< segments held for reordering
+    uint64_t maxBufferedBytes; ///< payload bytes held for reordering
+    uint64_t maxRss; ///< resident set size of the process (unit: kilobyte)
+  };
+
   /**
    * @brief Create the consumer
    */
   Consumer(Validator& validator, bool isVerbose, std::ostream& os = std::cout);
 
+  void
+  setMemoryLimits(const MemoryLimits& limits)
+  {
+    m_limits = limits;
+  }
+
+  /**
+   * @brief apply backpressure to the pipeline while the reorder buffer holds @p nBytes or more
+   *
+   * While the backpressure is applied, the pipeline requests no new segment and retransmits
+   * the segment the consumer is waiting for first. 0 disables the backpressure.
+   */
+  void
+  setBackpressureThreshold(uint64_t nBytes)
+  {
+    m_backpressureThreshold = nBytes;
+  }
+
+  /**
+   * @brief retrieve only the segments from @p first to @p last (inclusive)
+   * @pre the consumer is not running
+   */
+  void
+  setSegmentRange(uint64_t first, uint64_t last);
+
+  /**
+   * @brief retrieve only the bytes from @p first to @p last (inclusive) of the content
+   *
+   * The segments covering the range are computed from the payload size of the segment found by
+   * the version discovery, assuming that all the segments but the last one have this size.
+   * The bytes outside the range are trimmed from the first and the last of these segments.
+   *
+   * @pre the consumer is not running
+   */
+  void
+  setByteRange(uint64_t first, uint64_t last);
+
   /**
    * @brief Run the consumer
    */
   void
   run(unique_ptr<DiscoverVersion> discover, unique_ptr<PipelineInterests> pipeline);
 
+  /**
+   * @return largest number of segments held for reordering, including the one just received
+   */
+  size_t
+  getMaxBufferedSegments() const
+  {
+    return m_maxBufferedSegments;
+  }
+
+  /**
+   * @return the pipeline passed to run, nullptr if run has not been called
+   */
+  const PipelineInterests*
+  getPipeline() const
+  {
+    return m_pipeline.get();
+  }
+
+  /**
+   * @return number of segments held for reordering
+   */
+  size_t
+  getNBufferedSegments() const
+  {
+    return m_bufferedData.size();
+  }
+
+  /**
+   * @return payload bytes of the segments held for reordering
+   */
+  uint64_t
+  getNBufferedBytes() const
+  {
+    return m_nBufferedBytes;
+  }
+
+  /**
+   * @return largest number of payload bytes held for reordering
+   */
+  uint64_t
+  getMaxBufferedBytes() const
+  {
+    return m_maxBufferedBytes;
+  }
+
+  /**
+   * @return payload bytes written to the output stream, or by the OutputWriter if there is one
+   */
+  uint64_t
+  getNWrittenBytes() const;
+
+  /**
+   * @brief compute the SHA-256 digest of the output while it is written
+   * @pre the consumer is not running
+   */
+  void
+  enableDigest()
+  {
+    m_sha256 = make_unique<util::Sha256>();
+  }
+
+  /**
+   * @return the SHA-256 digest of the output in hexadecimal, empty if enableDigest was not called
+   * @note the digest is finalized, so this method is called once the retrieval is complete
+   */
+  std::string
+  getDigest();
+
+  /**
+   * @return fraction of the segments written to the output stream, NaN while the last
+   *         segment number is unknown
+   */
+  double
+  getProgress() const;
+
+  /**
+   * @return true once every segment has been written to the output stream
+   */
+  bool
+  isComplete() const
+  {
+    return m_hasLastSegment && m_nextToPrint > m_lastSegmentNo;
+  }
+
+  /**
+   * @brief time the traced events with @p clock instead of the default clock
+   *
+   * It is the clock of the pipeline and of the SegmentTracer, so that all the events of a
+   * segment are on the same time base.
+   *
+   * @pre the consumer is not running
+   * @note @p clock must outlive the consumer
+   */
+  void
+  setClock(const PipelineClock& clock);
+
+  /**
+   * @brief record the validation and output of each segment in @p tracer, nullptr to stop tracing
+   * @note @p tracer must outlive the consumer
+   * @pre the consumer is not running
+   */
+  void
+  setTracer(SegmentTracer* tracer);
+
+  /**
+   * @brief hand the output over to @p writer instead of writing it on the Face thread
+   *
+   * The segments are then counted as written, and traced, once the thread of @p writer has
+   * written them. A segment that does not fit into the queue of @p writer stays in the reorder
+   * buffer. Once @p writer fails, the retrieval is cancelled and fails with its error.
+   *
+   * @note @p writer must outlive the consumer
+   * @pre the consumer is not running
+   */
+  void
+  setOutputWriter(OutputWriter* writer);
+
+  /**
+   * @brief wait until the output has been written, then trace the last written segments
+   * @throw OutputWriter::Error the OutputWriter failed to write the output
+   */
+  void
+  flushOutput();
+
 private:
   void
   startPipeline(const Data& data);
@@ -77,13 +267,58 @@ private:
   void
   onDataValidated(shared_ptr<const Data> data);
 
+  void
+  onNewerVersion(const Data& data);
+
   void
   onFailure(const std::string& reason);
 
+  void
+  onWriterFailure(const std::string& reason);
+
+  /**
+   * @brief trace the segments that the OutputWriter has written since the last call
+   */
+  void
+  traceWrittenSegments();
+
+  /**
+   * @return a copy of @p data without the bytes outside the requested byte range
+   */
+  shared_ptr<const Data>
+  trimToByteRange(const Data& data) const;
+
+  /**
+   * @brief fail the retrieval if a memory limit is exceeded after @p segNo was buffered
+   */
+  void
+  checkMemoryLimits(uint64_t segNo);
+
 PUBLIC_WITH_TESTS_ELSE_PRIVATE:
+  /**
+   * @brief write the buffered segments that are in order, then update the backpressure; once
+   *        the retrieval is complete, stop the discovery and emit afterComplete
+   */
+  void
+  processBufferedData();
+
+  /**
+   * @brief hold @p data in the reorder buffer until it can be written
+   *
+   * Segments that have already been written are ignored.
+   */
+  void
+  bufferData(shared_ptr<const Data> data);
+
   void
   writeInOrderData();
 
+  /**
+   * @brief apply or release the backpressure according to the size of the reorder buffer
+   */
+  void
+  updateBackpressure();
+
 private:
   Validator& m_validator;
   std::ostream& m_outputStream;
@@ -91,8 +326,33 @@ private:
   unique_ptr<PipelineInterests> m_pipeline;
   uint64_t m_nextToPrint;
   bool m_isVerbose;
+  size_t m_maxBufferedSegments;
+  uint64_t m_nBufferedBytes;
+  uint64_t m_maxBufferedBytes;
+  uint64_t m_nWrittenBytes;
+  MemoryLimits m_limits;
+  uint64_t m_backpressureThreshold;
+  const PipelineClock* m_clock;
+  SegmentTracer* m_tracer;
+  OutputWriter* m_writer;
+  std::deque<uint64_t> m_segmentsInWriter; ///< traced segments handed to m_writer, in order
+  std::vector<time::steady_clock::TimePoint> m_writeTimes;
+  unique_ptr<util::Sha256> m_sha256;
+  uint64_t m_nextToDigest;
+  bool m_hasCompleted; ///< whether afterComplete has been emitted
+
+  bool m_hasRange; ///< true if only a range of segments is retrieved
+  uint64_t m_firstSegmentNo; ///< first segment of the range
+  uint64_t m_rangeLastSegmentNo; ///< last segment of the range
+  bool m_hasByteRange; ///< true if the range was given in bytes
+  uint64_t m_firstByte;
+  uint64_t m_lastByte;
+  size_t m_firstByteOffset; ///< offset of m_firstByte in the first segment of the range
+  size_t m_lastSegmentEnd; ///< offset just after m_lastByte in the last segment of the range
 
 PUBLIC_WITH_TESTS_ELSE_PRIVATE:
+  uint64_t m_lastSegmentNo;
+  bool m_hasLastSegment;
   std::map<uint64_t, shared_ptr<const Data>> m_bufferedData;
 };
 
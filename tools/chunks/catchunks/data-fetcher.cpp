@@ -40,6 +40,7 @@ DataFetcher::fetch(Face& face, const Interest& interest, int maxNackRetries, int
                    bool isVerbose)
 {
   auto dataFetcher = shared_ptr<DataFetcher>(new DataFetcher(face,
+                                                             nullptr,
                                                              maxNackRetries,
                                                              maxTimeoutRetries,
                                                              std::move(onData),
@@ -50,11 +51,31 @@ DataFetcher::fetch(Face& face, const Interest& interest, int maxNackRetries, int
   return dataFetcher;
 }
 
-DataFetcher::DataFetcher(Face& face, int maxNackRetries, int maxTimeoutRetries,
+shared_ptr<DataFetcher>
+DataFetcher::create(Face& face, Scheduler& scheduler, int maxNackRetries, int maxTimeoutRetries,
+                    DataCallback onData, FailureCallback onNack, FailureCallback onTimeout,
+                    bool isVerbose)
+{
+  auto dataFetcher = shared_ptr<DataFetcher>(new DataFetcher(face,
+                                                             &scheduler,
+                                                             maxNackRetries,
+                                                             maxTimeoutRetries,
+                                                             std::move(onData),
+                                                             std::move(onNack),
+                                                             std::move(onTimeout),
+                                                             isVerbose));
+  // idle until restart() is called
+  dataFetcher->m_isStopped = true;
+  return dataFetcher;
+}
+
+DataFetcher::DataFetcher(Face& face, Scheduler* scheduler, int maxNackRetries, int maxTimeoutRetries,
                          DataCallback onData, FailureCallback onNack, FailureCallback onTimeout,
                          bool isVerbose)
   : m_face(face)
-  , m_scheduler(m_face.getIoService())
+  , m_ownScheduler(scheduler == nullptr ? make_unique<Scheduler>(m_face.getIoService()) : nullptr)
+  , m_scheduler(scheduler == nullptr ? *m_ownScheduler : *scheduler)
+  , m_interestId(nullptr)
   , m_onData(std::move(onData))
   , m_onNack(std::move(onNack))
   , m_onTimeout(std::move(onTimeout))
@@ -70,13 +91,25 @@ DataFetcher::DataFetcher(Face& face, int maxNackRetries, int maxTimeoutRetries,
   BOOST_ASSERT(m_onData != nullptr);
 }
 
+void
+DataFetcher::restart(const Interest& interest)
+{
+  BOOST_ASSERT(!isRunning());
+
+  m_nNacks = 0;
+  m_nTimeouts = 0;
+  m_isStopped = false;
+  m_hasError = false;
+  expressInterest(interest, nullptr);
+}
+
 void
 DataFetcher::cancel()
 {
   if (isRunning()) {
     m_isStopped = true;
     m_face.removePendingInterest(m_interestId);
-    m_scheduler.cancelAllEvents();
+    m_scheduler.cancelEvent(m_retryEvent);
   }
 }
 
@@ -84,12 +117,37 @@ void
 DataFetcher::expressInterest(const Interest& interest, const shared_ptr<DataFetcher>& self)
 {
   m_nCongestionRetries = 0;
+
+  if (self == nullptr) {
+    // the owner of a reusable fetcher guarantees its lifetime, capturing only 'this' lets
+    // the callbacks fit into std::function's internal buffer without a heap allocation
+    m_interestId = m_face.expressInterest(interest,
+                                          [this] (const Interest& i, const Data& d) {
+                                            handleData(i, d, nullptr);
+                                          },
+                                          [this] (const Interest& i, const lp::Nack& n) {
+                                            handleNack(i, n, nullptr);
+                                          },
+                                          [this] (const Interest& i) {
+                                            handleTimeout(i, nullptr);
+                                          });
+    return;
+  }
+
   m_interestId = m_face.expressInterest(interest,
                                         bind(&DataFetcher::handleData, this, _1, _2, self),
                                         bind(&DataFetcher::handleNack, this, _1, _2, self),
                                         bind(&DataFetcher::handleTimeout, this, _1, self));
 }
 
+void
+DataFetcher::retryInterest(const Interest& interest, const shared_ptr<DataFetcher>& self)
+{
+  if (m_onRetry)
+    m_onRetry(interest);
+  expressInterest(interest, self);
+}
+
 void
 DataFetcher::handleData(const Interest& interest, const Data& data,
                         const shared_ptr<DataFetcher>& self)
@@ -108,8 +166,7 @@ DataFetcher::handleNack(const Interest& interest, const lp::Nack& nack,
   if (!isRunning())
     return;
 
-  if (m_maxNackRetries != MAX_RETRIES_INFINITE)
-    ++m_nNacks;
+  ++m_nNacks;
 
   if (m_isVerbose)
     std::cerr << "Received Nack with reason " << nack.getReason()
@@ -121,7 +178,7 @@ DataFetcher::handleNack(const Interest& interest, const lp::Nack& nack,
 
     switch (nack.getReason()) {
       case lp::NackReason::DUPLICATE: {
-        expressInterest(newInterest, self);
+        retryInterest(newInterest, self);
         break;
       }
       case lp::NackReason::CONGESTION: {
@@ -131,8 +188,8 @@ DataFetcher::handleNack(const Interest& interest, const lp::Nack& nack,
         else
           m_nCongestionRetries++;
 
-        m_scheduler.scheduleEvent(backoffTime, bind(&DataFetcher::expressInterest, this,
-                                                    newInterest, self));
+        m_retryEvent = m_scheduler.scheduleEvent(backoffTime, bind(&DataFetcher::retryInterest,
+                                                                   this, newInterest, self));
         break;
       }
       default: {
@@ -158,8 +215,7 @@ DataFetcher::handleTimeout(const Interest& interest, const shared_ptr<DataFetche
   if (!isRunning())
     return;
 
-  if (m_maxTimeoutRetries != MAX_RETRIES_INFINITE)
-    ++m_nTimeouts;
+  ++m_nTimeouts;
 
   if (m_isVerbose)
     std::cerr << "Timeout for Interest " << interest << std::endl;
@@ -167,7 +223,7 @@ DataFetcher::handleTimeout(const Interest& interest, const shared_ptr<DataFetche
   if (m_nTimeouts <= m_maxTimeoutRetries || m_maxTimeoutRetries == MAX_RETRIES_INFINITE) {
     Interest newInterest(interest);
     newInterest.refreshNonce();
-    expressInterest(newInterest, self);
+    retryInterest(newInterest, self);
   }
   else {
     m_hasError = true;
@@ -45,6 +45,10 @@ namespace chunks {
  * can be different for timeout and nack. The data callback must be defined but the others callback
  * are optional.
  *
+ * Alternatively, a reusable DataFetcher can be obtained with the static method create. Such a
+ * fetcher is idle until restart is called, uses a Scheduler owned by the caller (so that many
+ * fetchers can share the same one), and can be restarted with a new interest every time the
+ * previous fetch operation has completed. This avoids allocating a new fetcher for each interest.
  */
 class DataFetcher
 {
@@ -62,6 +66,8 @@ public:
 
   typedef function<void(const Interest& interest, const std::string& reason)> FailureCallback;
 
+  typedef function<void(const Interest& interest)> RetryCallback;
+
   /**
    * @brief instantiate a DataFetcher object and start fetching data
    *
@@ -72,6 +78,50 @@ public:
         DataCallback onData, FailureCallback onTimeout, FailureCallback onNack,
         bool isVerbose);
 
+  /**
+   * @brief instantiate an idle DataFetcher that can be used for several fetch operations
+   *
+   * The fetcher does not express any interest until restart is called. Retransmissions after a
+   * congestion Nack are scheduled on @p scheduler, which must outlive the fetcher. The caller
+   * must keep the returned fetcher alive until it is cancelled or has completed.
+   *
+   * @param onData callback for segment correctly received, must not be empty
+   */
+  static shared_ptr<DataFetcher>
+  create(Face& face, Scheduler& scheduler, int maxNackRetries, int maxTimeoutRetries,
+         DataCallback onData, FailureCallback onNack, FailureCallback onTimeout,
+         bool isVerbose);
+
+  /**
+   * @brief start fetching data for @p interest, resetting the retry counters
+   *
+   * @pre the fetcher has been obtained with create and is not running
+   */
+  void
+  restart(const Interest& interest);
+
+  /**
+   * @brief change the maximum number of retries after a timeout
+   *
+   * The new limit is compared against the timeouts of the current Interest, starting from the
+   * next timeout, and is kept across restart.
+   */
+  void
+  setMaxTimeoutRetries(int maxTimeoutRetries)
+  {
+    m_maxTimeoutRetries = maxTimeoutRetries;
+  }
+
+  /**
+   * @brief invoke @p callback every time the Interest is expressed again after a timeout or a
+   *        Nack, just before it is sent
+   */
+  void
+  setRetryCallback(const RetryCallback& callback)
+  {
+    m_onRetry = callback;
+  }
+
   /**
    * @brief stop data fetching without error and calling any callback
    */
@@ -90,14 +140,42 @@ public:
     return m_hasError;
   }
 
+  /**
+   * @return number of times the current Interest was retransmitted after a Nack or a timeout
+   */
+  int
+  getNRetries() const
+  {
+    return m_nNacks + m_nTimeouts;
+  }
+
+  /**
+   * @return number of times the current Interest was expressed again after a timeout
+   */
+  int
+  getNTimeouts() const
+  {
+    return m_nTimeouts;
+  }
+
 private:
-  DataFetcher(Face& face, int maxNackRetries, int maxTimeoutRetries,
+  DataFetcher(Face& face, Scheduler* scheduler, int maxNackRetries, int maxTimeoutRetries,
               DataCallback onData, FailureCallback onNack, FailureCallback onTimeout,
               bool isVerbose);
 
+  /**
+   * @param self the owning pointer to keep the fetcher alive while the interest is pending,
+   *             nullptr if the lifetime is guaranteed by the creator of a reusable fetcher
+   */
   void
   expressInterest(const Interest& interest, const shared_ptr<DataFetcher>& self);
 
+  /**
+   * @brief notify the retry callback, then express @p interest
+   */
+  void
+  retryInterest(const Interest& interest, const shared_ptr<DataFetcher>& self);
+
   void
   handleData(const Interest& interest, const Data& data, const shared_ptr<DataFetcher>& self);
 
@@ -109,11 +187,14 @@ private:
 
 private:
   Face& m_face;
-  Scheduler m_scheduler;
+  unique_ptr<Scheduler> m_ownScheduler; ///< used only if no scheduler is supplied by the caller
+  Scheduler& m_scheduler;
+  scheduler::EventId m_retryEvent;
   const PendingInterestId* m_interestId;
   DataCallback m_onData;
   FailureCallback m_onNack;
   FailureCallback m_onTimeout;
+  RetryCallback m_onRetry;
 
   int m_maxNackRetries;
   int m_maxTimeoutRetries;
@@ -0,0 +1,104 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "discover-version-cached.hpp"
+
+namespace ndn {
+namespace chunks {
+
+DiscoverVersionCached::DiscoverVersionCached(const Name& prefix, Face& face,
+                                             const DiscoverVersionIterative::Options& options,
+                                             VersionCache& cache)
+  : Options(options)
+  , DiscoverVersion(prefix, face, options)
+  , m_iterativeOptions(options)
+  , m_cache(cache)
+{
+}
+
+void
+DiscoverVersionCached::run()
+{
+  uint64_t version;
+  if (!m_cache.find(m_prefix, version)) {
+    runIterative();
+    return;
+  }
+
+  if (isVerbose)
+    std::cerr << "Trying cached version = " << version << std::endl;
+
+  // a stale cached version should not delay the fallback by a whole retry budget
+  Options fixedOptions(m_iterativeOptions);
+  fixedOptions.maxRetriesOnTimeoutOrNack = 0;
+  m_fixed = make_unique<DiscoverVersionFixed>(Name(m_prefix).appendVersion(version), m_face,
+                                              fixedOptions);
+  m_fixed->onDiscoverySuccess.connect([this] (const Data& data) {
+    this->emitSignal(onDiscoverySuccess, data);
+  });
+  m_fixed->onDiscoveryFailure.connect([this] (const std::string& reason) {
+    if (isVerbose)
+      std::cerr << "Cached version is not available (" << reason << "), "
+                << "falling back to iterative discovery" << std::endl;
+    runIterative();
+  });
+  m_fixed->run();
+}
+
+void
+DiscoverVersionCached::cancel()
+{
+  if (m_fixed != nullptr)
+    m_fixed->cancel();
+  if (m_iterative != nullptr)
+    m_iterative->cancel();
+}
+
+void
+DiscoverVersionCached::runIterative()
+{
+  m_iterative = make_unique<DiscoverVersionIterative>(m_prefix, m_face, m_iterativeOptions);
+  m_iterative->onDiscoverySuccess.connect([this] (const Data& data) {
+    updateCache(data);
+    this->emitSignal(onDiscoverySuccess, data);
+  });
+  m_iterative->onNewerVersion.connect([this] (const Data& data) {
+    updateCache(data);
+    this->emitSignal(onNewerVersion, data);
+  });
+  m_iterative->onDiscoveryFailure.connect([this] (const std::string& reason) {
+    this->emitSignal(onDiscoveryFailure, reason);
+  });
+  m_iterative->run();
+}
+
+void
+DiscoverVersionCached::updateCache(const Data& data)
+{
+  m_cache.insert(m_prefix, data.getName()[m_prefix.size()].toVersion());
+  if (!m_cache.save())
+    std::cerr << "WARNING: failed to write the version cache" << std::endl;
+}
+
+} // namespace chunks
+} // namespace ndn
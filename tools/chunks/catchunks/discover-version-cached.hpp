@@ -0,0 +1,80 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#ifndef NDN_TOOLS_CHUNKS_CATCHUNKS_DISCOVER_VERSION_CACHED_HPP
+#define NDN_TOOLS_CHUNKS_CATCHUNKS_DISCOVER_VERSION_CACHED_HPP
+
+#include "discover-version-fixed.hpp"
+#include "discover-version-iterative.hpp"
+#include "version-cache.hpp"
+
+namespace ndn {
+namespace chunks {
+
+/**
+ * @brief Service for discovering the latest Data version with the help of a VersionCache
+ *
+ * If the cache holds an unexpired version for the prefix, that version is requested once,
+ * without retransmissions, in the same way as DiscoverVersionFixed does. When no version is
+ * cached, or the cached version cannot be retrieved, the version is discovered with
+ * DiscoverVersionIterative and the result is stored in the cache.
+ */
+class DiscoverVersionCached : public DiscoverVersion
+{
+public:
+  /**
+   * @brief create a DiscoverVersionCached service
+   *
+   * @param options options of the fallback iterative discovery, also used for the
+   *                retrieval of the cached version (except for maxRetriesOnTimeoutOrNack)
+   */
+  DiscoverVersionCached(const Name& prefix, Face& face,
+                        const DiscoverVersionIterative::Options& options, VersionCache& cache);
+
+  /**
+   * @brief identify the latest Data version published.
+   */
+  void
+  run() final;
+
+  void
+  cancel() final;
+
+private:
+  void
+  runIterative();
+
+  void
+  updateCache(const Data& data);
+
+private:
+  const DiscoverVersionIterative::Options m_iterativeOptions;
+  VersionCache& m_cache;
+  unique_ptr<DiscoverVersionFixed> m_fixed;
+  unique_ptr<DiscoverVersionIterative> m_iterative;
+};
+
+} // namespace chunks
+} // namespace ndn
+
+#endif // NDN_TOOLS_CHUNKS_CATCHUNKS_DISCOVER_VERSION_CACHED_HPP
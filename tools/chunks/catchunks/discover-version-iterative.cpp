@@ -64,12 +64,16 @@ DiscoverVersionIterative::handleData(const Interest& interest, const Data& data)
 
   const Name& name = data.getName();
   Exclude exclude;
+  bool isFirstVersion = false;
+  bool isNewerVersion = false;
 
   if (isVerbose)
     std::cerr << "Data: " << data << std::endl;
 
   BOOST_ASSERT(name.size() > m_prefix.size());
   if (name[versionindex].isVersion()) {
+    isFirstVersion = !m_foundVersion;
+    isNewerVersion = m_foundVersion;
     m_latestVersion = name[versionindex].toVersion();
     m_latestVersionData = make_shared<Data>(data);
     m_foundVersion = true;
@@ -97,6 +101,28 @@ DiscoverVersionIterative::handleData(const Interest& interest, const Data& data)
     expressInterest(newInterest, maxRetriesOnTimeoutOrNack, maxRetriesAfterVersionFound);
   else
     expressInterest(interest, maxRetriesOnTimeoutOrNack, maxRetriesOnTimeoutOrNack);
+
+  if (isSpeculative) {
+    if (isFirstVersion)
+      this->emitSignal(onDiscoverySuccess, data);
+    else if (isNewerVersion)
+      this->emitSignal(onNewerVersion, data);
+  }
+}
+
+void
+DiscoverVersionIterative::handleNack(const Interest& interest, const std::string& reason)
+{
+  // in speculative mode the version has already been reported, and is not failed by a Nack
+  // for the Interests confirming it
+  if (isSpeculative && m_foundVersion) {
+    if (isVerbose)
+      std::cerr << "Confirmation of version " << m_latestVersion << " ended: " << reason
+                << std::endl;
+    return;
+  }
+
+  DiscoverVersion::handleNack(interest, reason);
 }
 
 void
@@ -107,6 +133,10 @@ DiscoverVersionIterative::handleTimeout(const Interest& interest, const std::str
     if (isVerbose)
       std::cerr << "Found data with the latest version: " << m_latestVersion << std::endl;
 
+    // in speculative mode the version has already been reported
+    if (isSpeculative)
+      return;
+
     // we discovered at least one version. assume what we have is the latest.
     this->emitSignal(onDiscoverySuccess, *m_latestVersionData);
   }
@@ -45,11 +45,13 @@ public:
   DiscoverVersionIterativeOptions(const Options& opt = Options())
     : Options(opt)
     , maxRetriesAfterVersionFound(1)
+    , isSpeculative(false)
   {
   }
 
 public:
   int maxRetriesAfterVersionFound;  // used only in timeout handling
+  bool isSpeculative;  // report the first version found and confirm it in the background
 };
 
 /**
@@ -69,6 +71,10 @@ public:
  *
  * DiscoverVersionIterative's user is notified once after identifying the latest retrievable
  * version or on failure to find any version Data.
+ *
+ * In speculative mode (isSpeculative), the first version found is reported right away, so that its
+ * retrieval can start while the discovery continues. If a newer version is found afterwards,
+ * onNewerVersion is emitted; the timeouts or Nacks ending the confirmation are not reported.
  */
 class DiscoverVersionIterative : public DiscoverVersion, protected DiscoverVersionIterativeOptions
 {
@@ -91,6 +97,9 @@ private:
   void
   handleData(const Interest& interest, const Data& data) final;
 
+  void
+  handleNack(const Interest& interest, const std::string& reason) final;
+
   void
   handleTimeout(const Interest& interest, const std::string& reason) final;
 
@@ -49,6 +49,13 @@ DiscoverVersion::expressInterest(const Interest& interest, int maxRetriesNack,
                                isVerbose);
 }
 
+void
+DiscoverVersion::cancel()
+{
+  if (fetcher != nullptr)
+    fetcher->cancel();
+}
+
 void
 DiscoverVersion::handleData(const Interest& interest, const Data& data)
 {
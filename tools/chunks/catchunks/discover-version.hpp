@@ -55,8 +55,17 @@ public: // signals
    */
   signal::Signal<DiscoverVersion, const std::string&> onDiscoveryFailure;
 
+  /**
+   * @brief Signal emitted when a version newer than the one reported through
+   *        onDiscoverySuccess is found.
+   *
+   * Only emitted by discovery services that report a version before confirming it is the latest.
+   */
+  signal::Signal<DiscoverVersion, const Data&> onNewerVersion;
+
   DECLARE_SIGNAL_EMIT(onDiscoverySuccess)
   DECLARE_SIGNAL_EMIT(onDiscoveryFailure)
+  DECLARE_SIGNAL_EMIT(onNewerVersion)
 
 public:
   /**
@@ -70,6 +79,13 @@ public:
   virtual void
   run() = 0;
 
+  /**
+   * @brief stop the discovery, e.g. when the reported version has been entirely retrieved
+   *        before it was confirmed
+   */
+  virtual void
+  cancel();
+
 protected:
   void
   expressInterest(const Interest& interest, int maxRetriesNack, int maxRetriesTimeout);
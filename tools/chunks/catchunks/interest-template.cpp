@@ -0,0 +1,50 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "interest-template.hpp"
+
+#include <ndn-cxx/util/random.hpp>
+
+namespace ndn {
+namespace chunks {
+
+InterestTemplate::InterestTemplate(const Name& prefix, const Options& options)
+  : m_prefix(prefix)
+{
+  m_interest.setInterestLifetime(options.interestLifetime);
+  m_interest.setMustBeFresh(options.mustBeFresh);
+  m_interest.setMaxSuffixComponents(1);
+}
+
+Interest
+InterestTemplate::makeInterest(uint64_t segNo) const
+{
+  Interest interest(m_interest);
+  // setName drops any wire encoding shared with the template, before setNonce could patch it
+  interest.setName(Name(m_prefix).appendSegment(segNo));
+  interest.setNonce(random::generateWord32());
+  return interest;
+}
+
+} // namespace chunks
+} // namespace ndn
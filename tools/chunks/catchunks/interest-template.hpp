@@ -0,0 +1,62 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#ifndef NDN_TOOLS_CHUNKS_CATCHUNKS_INTEREST_TEMPLATE_HPP
+#define NDN_TOOLS_CHUNKS_CATCHUNKS_INTEREST_TEMPLATE_HPP
+
+#include "options.hpp"
+#include "core/common.hpp"
+
+namespace ndn {
+namespace chunks {
+
+/**
+ * @brief Produces the segment Interests of a transfer from a template Interest
+ *
+ * All the Interests of a transfer differ only in the segment number and in the Nonce, so the
+ * InterestLifetime, MustBeFresh and MaxSuffixComponents are set only once, on a template
+ * Interest. Each Interest is a copy of the template, given the name of its segment, whose prefix
+ * components share the buffers of the prefix, and a random Nonce. Neither the prefix nor the
+ * template fields are encoded again or parsed for each segment; the Interest is encoded once,
+ * when it is expressed.
+ */
+class InterestTemplate : noncopyable
+{
+public:
+  InterestTemplate(const Name& prefix, const Options& options);
+
+  /**
+   * @return an Interest for segment @p segNo under the prefix, with a new random Nonce
+   */
+  Interest
+  makeInterest(uint64_t segNo) const;
+
+private:
+  const Name m_prefix;
+  Interest m_interest; ///< the fields shared by all the segment Interests
+};
+
+} // namespace chunks
+} // namespace ndn
+
+#endif // NDN_TOOLS_CHUNKS_CATCHUNKS_INTEREST_TEMPLATE_HPP
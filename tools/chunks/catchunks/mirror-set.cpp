@@ -0,0 +1,200 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "mirror-set.hpp"
+
+#include <cmath>
+
+namespace ndn {
+namespace chunks {
+namespace aimd {
+
+const size_t MirrorSet::NO_MIRROR = std::numeric_limits<size_t>::max();
+
+/// gain of the moving average of the loss rate of each mirror
+static const double LOSS_RATE_GAIN = 0.125;
+
+/// delivery ratio assumed for the weight of a mirror losing everything, so that it is still
+/// probed and can recover its share
+static const double MIN_DELIVERY_RATIO = 0.05;
+
+MirrorSet::Mirror::Mirror(const Name& prefix, const Options& options,
+                          const RttEstimator::Options& rttOptions)
+  : prefix(prefix)
+  , interestTemplate(prefix, options)
+  , rttEstimator(rttOptions)
+  , lossRate(0.0)
+  , credit(0.0)
+  , lastBackoff(time::steady_clock::TimePoint::min())
+  , nSent(0)
+  , nReceived(0)
+  , nLost(0)
+{
+}
+
+MirrorSet::MirrorSet(const std::vector<Name>& prefixes, const Options& options,
+                     const RttEstimator::Options& rttOptions)
+{
+  BOOST_ASSERT(!prefixes.empty());
+
+  // the options are printed once by the RTT estimator of the pipeline
+  RttEstimator::Options mirrorRttOptions(rttOptions);
+  mirrorRttOptions.isVerbose = false;
+
+  for (const auto& prefix : prefixes)
+    m_mirrors.push_back(make_unique<Mirror>(prefix, options, mirrorRttOptions));
+}
+
+size_t
+MirrorSet::select(size_t avoided)
+{
+  if (m_mirrors.size() == 1)
+    return 0;
+
+  // smooth weighted round robin: each candidate earns its weight, the richest one is chosen
+  // and pays back the total, so that the choices interleave in proportion to the weights
+  size_t selected = NO_MIRROR;
+  double totalWeight = 0.0;
+  for (size_t i = 0; i < m_mirrors.size(); ++i) {
+    if (i == avoided)
+      continue;
+
+    double weight = getWeight(i);
+    m_mirrors[i]->credit += weight;
+    totalWeight += weight;
+    if (selected == NO_MIRROR || m_mirrors[i]->credit > m_mirrors[selected]->credit)
+      selected = i;
+  }
+
+  m_mirrors[selected]->credit -= totalWeight;
+  return selected;
+}
+
+Interest
+MirrorSet::makeInterest(size_t mirrorNo, uint64_t segNo)
+{
+  Mirror& mirror = *m_mirrors.at(mirrorNo);
+  ++mirror.nSent;
+  return mirror.interestTemplate.makeInterest(segNo);
+}
+
+void
+MirrorSet::onDataReceived(size_t mirrorNo)
+{
+  Mirror& mirror = *m_mirrors.at(mirrorNo);
+  ++mirror.nReceived;
+  mirror.lossRate -= LOSS_RATE_GAIN * mirror.lossRate;
+}
+
+void
+MirrorSet::onLoss(size_t mirrorNo)
+{
+  Mirror& mirror = *m_mirrors.at(mirrorNo);
+  ++mirror.nLost;
+  mirror.lossRate += LOSS_RATE_GAIN * (1.0 - mirror.lossRate);
+}
+
+void
+MirrorSet::onTimeout(size_t mirrorNo, time::steady_clock::TimePoint timeSent,
+                     time::steady_clock::TimePoint now)
+{
+  onLoss(mirrorNo);
+
+  Mirror& mirror = *m_mirrors.at(mirrorNo);
+  if (timeSent >= mirror.lastBackoff) {
+    mirror.rttEstimator.backoffRto();
+    mirror.lastBackoff = now;
+  }
+}
+
+double
+MirrorSet::getWeight(size_t mirrorNo) const
+{
+  const Mirror& mirror = *m_mirrors.at(mirrorNo);
+
+  Milliseconds rtt = mirror.rttEstimator.getSmoothedRtt();
+  if (std::isnan(rtt.count())) // no measurement yet
+    rtt = mirror.rttEstimator.getEstimatedRto();
+
+  return std::max(1.0 - mirror.lossRate, MIN_DELIVERY_RATIO) / std::max(rtt.count(), 1.0);
+}
+
+void
+MirrorSet::printSummary(std::ostream& os) const
+{
+  for (size_t i = 0; i < m_mirrors.size(); ++i) {
+    const Mirror& mirror = *m_mirrors[i];
+    os << "Mirror " << mirror.prefix << ": " << mirror.nSent << " Interests, "
+       << mirror.nReceived << " received, " << mirror.nLost << " lost, srtt="
+       << mirror.rttEstimator.getSmoothedRtt().count() << "ms, loss rate="
+       << mirror.lossRate << "\n";
+  }
+}
+
+MirrorRouter::MirrorRouter(RttEstimator& rttEstimator)
+  : m_rttEstimator(rttEstimator)
+{
+}
+
+void
+MirrorRouter::start(const Name& prefix, const Options& options)
+{
+  if (m_mirrorPrefixes.empty()) {
+    m_interestTemplate = make_unique<InterestTemplate>(prefix, options);
+    return;
+  }
+
+  std::vector<Name> prefixes{prefix};
+  prefixes.insert(prefixes.end(), m_mirrorPrefixes.begin(), m_mirrorPrefixes.end());
+  m_mirrors = make_unique<MirrorSet>(prefixes, options, m_rttEstimator.getOptions());
+}
+
+Interest
+MirrorRouter::makeInterest(size_t mirrorNo, uint64_t segNo)
+{
+  if (m_mirrors == nullptr)
+    return m_interestTemplate->makeInterest(segNo);
+  return m_mirrors->makeInterest(mirrorNo, segNo);
+}
+
+void
+MirrorRouter::addRttMeasurement(size_t mirrorNo, uint64_t segNo, double now, Milliseconds rtt,
+                                size_t nExpectedSamples)
+{
+  if (m_mirrors == nullptr)
+    return;
+
+  size_t nMirrorSamples = std::max<size_t>(nExpectedSamples / m_mirrors->size(), 1);
+  m_mirrors->getRttEstimator(mirrorNo).addMeasurement(segNo, now, rtt, nMirrorSamples);
+}
+
+void
+MirrorRouter::printSummary(std::ostream& os) const
+{
+  if (m_mirrors != nullptr)
+    m_mirrors->printSummary(os);
+}
+
+} // namespace aimd
+} // namespace chunks
+} // namespace ndn
@@ -0,0 +1,265 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#ifndef NDN_TOOLS_CHUNKS_CATCHUNKS_MIRROR_SET_HPP
+#define NDN_TOOLS_CHUNKS_CATCHUNKS_MIRROR_SET_HPP
+
+#include "options.hpp"
+#include "aimd-rtt-estimator.hpp"
+#include "interest-template.hpp"
+
+namespace ndn {
+namespace chunks {
+namespace aimd {
+
+/**
+ * @brief Equivalent sources of a content, among which the segment Interests are distributed
+ *
+ * Each mirror is a versioned prefix serving the same segments. The Interests are spread with a
+ * smooth weighted round robin, where the weight of a mirror is its delivery ratio divided by its
+ * smoothed RTT. Both are measured separately for each mirror, the RTT with its own RttEstimator,
+ * whose RTO times the Interests sent to the mirror and is backed off by the mirror's timeouts.
+ */
+class MirrorSet : noncopyable
+{
+public:
+  static const size_t NO_MIRROR;
+
+  /**
+   * @param prefixes versioned prefixes of the mirrors, at least one
+   * @param options options of the Interests sent to every mirror
+   * @param rttOptions options of the RTT estimator of each mirror
+   */
+  MirrorSet(const std::vector<Name>& prefixes, const Options& options,
+            const RttEstimator::Options& rttOptions);
+
+  size_t
+  size() const
+  {
+    return m_mirrors.size();
+  }
+
+  /**
+   * @brief choose the mirror of the next Interest
+   *
+   * @param avoided mirror not to choose unless it is the only one, e.g. the one on which
+   *                the segment to retransmit has been lost
+   */
+  size_t
+  select(size_t avoided = NO_MIRROR);
+
+  /**
+   * @return an Interest for segment @p segNo under the prefix of mirror @p mirrorNo
+   */
+  Interest
+  makeInterest(size_t mirrorNo, uint64_t segNo);
+
+  RttEstimator&
+  getRttEstimator(size_t mirrorNo)
+  {
+    return m_mirrors.at(mirrorNo)->rttEstimator;
+  }
+
+  /**
+   * @brief record the arrival of a segment requested from mirror @p mirrorNo
+   */
+  void
+  onDataReceived(size_t mirrorNo);
+
+  /**
+   * @brief record the loss (timeout or Nack) of an Interest sent to mirror @p mirrorNo
+   */
+  void
+  onLoss(size_t mirrorNo);
+
+  /**
+   * @brief record the timeout of an Interest sent to mirror @p mirrorNo at @p timeSent
+   *
+   * The RTO of the mirror is backed off, once for all the Interests sent before the previous
+   * backoff, so that a burst of timeouts doubles it only once, while the timeout of an Interest
+   * sent since, e.g. a retransmission, doubles it again.
+   */
+  void
+  onTimeout(size_t mirrorNo, time::steady_clock::TimePoint timeSent,
+            time::steady_clock::TimePoint now);
+
+  /**
+   * @return the share of the Interests that mirror @p mirrorNo currently deserves, relative to
+   *         the other mirrors
+   */
+  double
+  getWeight(size_t mirrorNo) const;
+
+  /**
+   * @brief print the prefix, the counters and the weight of each mirror
+   */
+  void
+  printSummary(std::ostream& os) const;
+
+private:
+  struct Mirror
+  {
+    Mirror(const Name& prefix, const Options& options, const RttEstimator::Options& rttOptions);
+
+    Name prefix;
+    InterestTemplate interestTemplate;
+    RttEstimator rttEstimator;
+    double lossRate; ///< moving average of the losses over the Interests sent
+    double credit; ///< balance of the weighted round robin
+    time::steady_clock::TimePoint lastBackoff; ///< when the RTO was last backed off
+    uint64_t nSent;
+    uint64_t nReceived;
+    uint64_t nLost;
+  };
+
+PUBLIC_WITH_TESTS_ELSE_PRIVATE:
+  std::vector<unique_ptr<Mirror>> m_mirrors;
+};
+
+/**
+ * @brief Mirror bookkeeping of a window-based pipeline, which may or may not have mirrors
+ *
+ * Mirror 0 is the retrieved versioned prefix. Without mirrors, every Interest goes to it, the
+ * RTT estimator of the pipeline is used, and the recording of arrivals and losses is a no-op.
+ * With mirrors, the RTT estimator of the pipeline only serves its congestion control and
+ * statistics, over all the mirrors; the timers use the estimator of each mirror.
+ */
+class MirrorRouter : noncopyable
+{
+public:
+  /**
+   * @param rttEstimator RTT estimator of the pipeline
+   */
+  explicit
+  MirrorRouter(RttEstimator& rttEstimator);
+
+  /**
+   * @brief set the versioned prefixes serving the same segments as the retrieved one
+   * @pre start() has not been called
+   */
+  void
+  setMirrors(const std::vector<Name>& mirrors)
+  {
+    m_mirrorPrefixes = mirrors;
+  }
+
+  /**
+   * @brief prepare the Interests for @p prefix and for the mirrors, when the pipeline starts
+   */
+  void
+  start(const Name& prefix, const Options& options);
+
+  bool
+  hasMirrors() const
+  {
+    return m_mirrors != nullptr;
+  }
+
+  /**
+   * @return true if a segment can be requested from another mirror than the one that failed
+   */
+  bool
+  canRetryElsewhere() const
+  {
+    return m_mirrors != nullptr && m_mirrors->size() > 1;
+  }
+
+  /**
+   * @brief choose the mirror of the next Interest, see MirrorSet::select
+   */
+  size_t
+  select(size_t avoided = MirrorSet::NO_MIRROR)
+  {
+    return m_mirrors != nullptr ? m_mirrors->select(avoided) : 0;
+  }
+
+  /**
+   * @return an Interest for segment @p segNo under the prefix of mirror @p mirrorNo
+   */
+  Interest
+  makeInterest(size_t mirrorNo, uint64_t segNo);
+
+  /**
+   * @return the RTT estimator of mirror @p mirrorNo, or the one of the pipeline without mirrors
+   */
+  RttEstimator&
+  getRttEstimator(size_t mirrorNo)
+  {
+    return m_mirrors != nullptr ? m_mirrors->getRttEstimator(mirrorNo) : m_rttEstimator;
+  }
+
+  void
+  onDataReceived(size_t mirrorNo)
+  {
+    if (m_mirrors != nullptr)
+      m_mirrors->onDataReceived(mirrorNo);
+  }
+
+  void
+  onLoss(size_t mirrorNo)
+  {
+    if (m_mirrors != nullptr)
+      m_mirrors->onLoss(mirrorNo);
+  }
+
+  /**
+   * @brief record a timeout, see MirrorSet::onTimeout
+   *
+   * Without mirrors, the pipeline backs off its own RTO.
+   */
+  void
+  onTimeout(size_t mirrorNo, time::steady_clock::TimePoint timeSent,
+            time::steady_clock::TimePoint now)
+  {
+    if (m_mirrors != nullptr)
+      m_mirrors->onTimeout(mirrorNo, timeSent, now);
+  }
+
+  /**
+   * @brief add an RTT sample to the estimator of mirror @p mirrorNo
+   *
+   * The estimator of the pipeline is fed by the pipeline itself. Each mirror expects its share
+   * of the @p nExpectedSamples samples of the window.
+   */
+  void
+  addRttMeasurement(size_t mirrorNo, uint64_t segNo, double now, Milliseconds rtt,
+                    size_t nExpectedSamples);
+
+  /**
+   * @brief print the summary of each mirror, nothing without mirrors
+   */
+  void
+  printSummary(std::ostream& os) const;
+
+private:
+  RttEstimator& m_rttEstimator;
+  std::vector<Name> m_mirrorPrefixes;
+  unique_ptr<InterestTemplate> m_interestTemplate; ///< without mirrors
+  unique_ptr<MirrorSet> m_mirrors; ///< nullptr without mirrors
+};
+
+} // namespace aimd
+} // namespace chunks
+} // namespace ndn
+
+#endif // NDN_TOOLS_CHUNKS_CATCHUNKS_MIRROR_SET_HPP
@@ -0,0 +1,126 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "core/version.hpp"
+#include "aimd-binary-statistics-collector.hpp"
+
+#include <fstream>
+
+namespace ndn {
+namespace chunks {
+
+static int
+main(int argc, char** argv)
+{
+  std::string programName(argv[0]);
+  std::string inputPath, cwndPath, rttPath, ratePath;
+
+  namespace po = boost::program_options;
+  po::options_description visibleDesc("Options");
+  visibleDesc.add_options()
+    ("help,h",     "print this help message and exit")
+    ("cwnd",       po::value<std::string>(&cwndPath), "output file for cwnd statistics")
+    ("rtt",        po::value<std::string>(&rttPath), "output file for rtt statistics")
+    ("rate",       po::value<std::string>(&ratePath), "output file for rate statistics")
+    ("version,V",  "print program version and exit")
+    ;
+
+  po::options_description hiddenDesc;
+  hiddenDesc.add_options()
+    ("input", po::value<std::string>(&inputPath), "binary statistics log written by ndncatchunks");
+
+  po::positional_options_description p;
+  p.add("input", 1);
+
+  po::options_description optDesc;
+  optDesc.add(visibleDesc).add(hiddenDesc);
+
+  po::variables_map vm;
+  try {
+    po::store(po::command_line_parser(argc, argv).options(optDesc).positional(p).run(), vm);
+    po::notify(vm);
+  }
+  catch (const po::error& e) {
+    std::cerr << "ERROR: " << e.what() << std::endl;
+    return 2;
+  }
+
+  if (vm.count("help") > 0) {
+    std::cout << "Usage: " << programName << " [options] STATS-FILE" << std::endl;
+    std::cout << visibleDesc;
+    return 0;
+  }
+
+  if (vm.count("version") > 0) {
+    std::cout << "ndncatchunks-stats2tsv " << tools::VERSION << std::endl;
+    return 0;
+  }
+
+  if (inputPath.empty()) {
+    std::cerr << "Usage: " << programName << " [options] STATS-FILE" << std::endl;
+    std::cerr << visibleDesc;
+    return 2;
+  }
+
+  std::ifstream input(inputPath, std::ios::binary);
+  if (input.fail()) {
+    std::cerr << "ERROR: failed to open " << inputPath << std::endl;
+    return 4;
+  }
+
+  // statistics without an output file are discarded
+  std::ofstream files[3];
+  const std::string* paths[] = {&cwndPath, &rttPath, &ratePath};
+  for (size_t i = 0; i < 3; ++i) {
+    if (paths[i]->empty()) {
+      files[i].setstate(std::ios::badbit);
+      continue;
+    }
+    files[i].open(*paths[i]);
+    if (files[i].fail()) {
+      std::cerr << "ERROR: failed to open " << *paths[i] << std::endl;
+      return 4;
+    }
+  }
+
+  try {
+    uint64_t nRecords = aimd::BinaryStatisticsCollector::convertToTsv(input, files[0], files[1],
+                                                                      files[2]);
+    std::cerr << "Converted " << nRecords << " records" << std::endl;
+  }
+  catch (const aimd::BinaryStatisticsCollector::Error& e) {
+    std::cerr << "ERROR: " << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
+
+} // namespace chunks
+} // namespace ndn
+
+int
+main(int argc, char** argv)
+{
+  return ndn::chunks::main(argc, argv);
+}
@@ -30,22 +30,54 @@
 #include "core/version.hpp"
 #include "options.hpp"
 #include "consumer.hpp"
+#include "discover-version-cached.hpp"
 #include "discover-version-fixed.hpp"
 #include "discover-version-iterative.hpp"
 #include "pipeline-interests-fixed-window.hpp"
 #include "pipeline-interests-aimd.hpp"
 #include "pipeline-interests-cubic.hpp"
 #include "pipeline-interests-tcpbic.hpp"
+#include "pipeline-interests-parallel.hpp"
 #include "aimd-rtt-estimator.hpp"
 #include "aimd-statistics-collector.hpp"
+#include "aimd-binary-statistics-collector.hpp"
+#include "telemetry-reporter.hpp"
+#include "segment-tracer.hpp"
+#include "memory-usage.hpp"
+#include "output-writer.hpp"
 #include "aimd-rate-estimator.hpp"
 
 #include <ndn-cxx/security/validator-null.hpp>
+#include <boost/algorithm/string/predicate.hpp>
 #include <fstream>
+#include <unistd.h>
 
 namespace ndn {
 namespace chunks {
 
+/**
+ * @brief parse an inclusive range "FIRST-LAST" of non-negative integers
+ * @return false if @p range is malformed or FIRST is greater than LAST
+ */
+static bool
+parseRange(const std::string& range, uint64_t& first, uint64_t& last)
+{
+  size_t dash = range.find('-');
+  if (dash == 0 || dash == std::string::npos || dash + 1 == range.size() ||
+      range.find_first_not_of("0123456789") != dash ||
+      range.find_first_not_of("0123456789", dash + 1) != std::string::npos)
+    return false;
+
+  try {
+    first = std::stoull(range.substr(0, dash));
+    last = std::stoull(range.substr(dash + 1));
+  }
+  catch (const std::out_of_range&) {
+    return false;
+  }
+  return first <= last;
+}
+
 static int
 main(int argc, char** argv)
 {
@@ -55,22 +87,49 @@ main(int argc, char** argv)
   std::string pipelineType("fixed");
   size_t maxPipelineSize(1);
   int maxRetriesAfterVersionFound(1);
+  std::string versionCachePath;
+  int versionCacheTtl(60);
   std::string uri;
 
   // congestion control parameters, CWA refers to conservative window adaptation,
   // i.e. only reduce window size at most once per RTT
   bool disableCwa(false), resetCwndToInit(false);
   double aiStep(1.0), mdCoef(0.5), alpha(0.125), beta(0.25),
-         minRto(200.0), maxRto(4000.0), rateInterval(0.1);
-  int initCwnd(1), initSsthresh(std::numeric_limits<int>::max()), k(4);
+         minRto(200.0), maxRto(4000.0), minRttWindow(10000.0), rateInterval(0.1);
+  int initCwnd(1), initSsthresh(std::numeric_limits<int>::max()), k(4), rateFilterRtts(10);
+  cubic::PipelineInterestsCubicOptions cubicDefaults;
+  double cubicBeta(cubicDefaults.cubicBeta), cubicScale(cubicDefaults.cubicScale);
+  tcpbic::PipelineInterestsTcpBicOptions bicDefaults;
+  double bicBeta(bicDefaults.bicBeta);
+  int bicMaxIncrement(bicDefaults.bicMaxIncrement), bicLowWindow(bicDefaults.bicLowWindow);
   std::string cwndPath, rttPath, ratePath;
+  std::string statsPath;
+  double statsInterval(0.0);
+  int telemetryFd(-1);
+  std::string telemetrySocketPath;
+  double telemetryInterval(1.0);
+  std::string tracePath;
+  size_t traceMaxEvents(1000000);
+  Consumer::MemoryLimits memoryLimits;
+  uint64_t reorderBufferCap(0);
+  OutputWriter::Options outputOptions;
+  bool printDigest(false);
+  std::string byteRange, segmentRange;
+  uint64_t rangeFirst(0), rangeLast(0);
+  std::string expectedDigest;
+  size_t followWindow(PipelineInterestsAimd::Options().followWindow);
+  std::vector<std::string> mirrorUris;
+  size_t nSubflows(1);
+  bool isCoupled(false);
 
   namespace po = boost::program_options;
   po::options_description basicDesc("Basic Options");
   basicDesc.add_options()
     ("help,h",      "print this help message and exit")
     ("discover-version,d",  po::value<std::string>(&discoverType)->default_value(discoverType),
-                            "version discovery algorithm to use; valid values are: 'fixed', 'iterative'")
+                            "version discovery algorithm to use; valid values are: 'fixed', 'iterative', "
+                            "'speculative' (iterative, retrieving the first version found while "
+                            "confirming it)")
     ("pipeline-type,t",  po::value<std::string>(&pipelineType)->default_value(pipelineType),
                          "type of Interest pipeline to use; valid values are: 'fixed', 'aimd', 'cubic', 'tcpbic'")
     ("fresh,f",     po::bool_switch(&options.mustBeFresh), "only return fresh content")
@@ -79,6 +138,35 @@ main(int argc, char** argv)
     ("retries,r",   po::value<int>(&options.maxRetriesOnTimeoutOrNack)->default_value(options.maxRetriesOnTimeoutOrNack),
                     "maximum number of retries in case of Nack or timeout (-1 = no limit)")
     ("verbose,v",   po::bool_switch(&options.isVerbose), "turn on verbose output")
+    ("follow",      po::bool_switch(&options.isFollowing),
+                    "follow a growing object: keep requesting the segments not produced yet "
+                    "until the object ends")
+    ("follow-window", po::value<size_t>(&followWindow)->default_value(followWindow),
+                      "segments requested beyond the newest one received when following "
+                      "(aimd, cubic and tcpbic pipelines)")
+    ("output-queue", po::value<size_t>(&outputOptions.queueSize)->default_value(outputOptions.queueSize),
+     "segments queued for a dedicated thread writing the output (0 = write from the network thread)")
+    ("vmsplice",    po::bool_switch(&outputOptions.allowVmsplice),
+                    "when the standard output is a pipe, pass the segments to vmsplice instead of "
+                    "copying them; only safe if the reader copies its input, not with splice or tee")
+    ("sha256",      po::bool_switch(&printDigest),
+                    "print the SHA-256 digest of the retrieved content, computed while it is written")
+    ("expect-sha256", po::value<std::string>(&expectedDigest),
+                      "fail if the SHA-256 digest of the retrieved content, in hexadecimal, differs")
+    ("mirror",      po::value<std::vector<std::string>>(&mirrorUris),
+                    "versioned name serving the same segments as the requested content; can be "
+                    "repeated, the Interests are distributed among all the names according to "
+                    "their RTT and loss (aimd, cubic and tcpbic pipelines)")
+    ("parallel",    po::value<size_t>(&nSubflows)->default_value(nSubflows),
+                    "number of pipelines fetching interleaved segments of the content in parallel, "
+                    "each one with its own window and RTT estimate (aimd, cubic and tcpbic pipelines)")
+    ("parallel-coupled", po::bool_switch(&isCoupled),
+                         "couple the window increases of the parallel pipelines, so that together "
+                         "they are no more aggressive than a single one (aimd pipeline)")
+    ("range",       po::value<std::string>(&byteRange),
+                    "retrieve only the bytes FIRST-LAST (inclusive, counted from 0) of the content")
+    ("segments",    po::value<std::string>(&segmentRange),
+                    "retrieve only the segments FIRST-LAST (inclusive) of the content")
     ("version,V",   "print program version and exit")
     ;
 
@@ -87,6 +175,11 @@ main(int argc, char** argv)
     ("retries-iterative,i", po::value<int>(&maxRetriesAfterVersionFound)->default_value(maxRetriesAfterVersionFound),
                             "number of timeouts that have to occur in order to confirm a discovered Data "
                             "version as the latest one")
+    ("version-cache", po::value<std::string>(&versionCachePath),
+                      "file caching the discovered versions; a cached version is tried first and "
+                      "the iterative discovery is used only if it cannot be retrieved")
+    ("version-cache-ttl", po::value<int>(&versionCacheTtl)->default_value(versionCacheTtl),
+                          "time in seconds a cached version is used before it is discovered again")
     ;
 
   po::options_description fixedPipeDesc("Fixed pipeline options");
@@ -105,6 +198,8 @@ main(int argc, char** argv)
                        "log file for AIMD rate statistics")
     ("aimd-debug-rate-interval", po::value<double>(&rateInterval)->default_value(rateInterval),
                        "AIMD rate Interval")
+    ("aimd-rate-filter-rtts", po::value<int>(&rateFilterRtts)->default_value(rateFilterRtts),
+                              "length of the delivery rate max filter window, in RTTs")
     ("aimd-disable-cwa", po::bool_switch(&disableCwa),
                          "disable Conservative Window Adaptation, "
                          "i.e. reduce window on each timeout (instead of at most once per RTT)")
@@ -129,6 +224,8 @@ main(int argc, char** argv)
                        "min rto value in milliseconds")
     ("aimd-rto-max",   po::value<double>(&maxRto)->default_value(maxRto),
                        "max rto value in milliseconds")
+    ("aimd-min-rtt-window", po::value<double>(&minRttWindow)->default_value(minRttWindow),
+                            "time window of the min rtt filter in milliseconds")
     ;
 
   po::options_description cubicPipeDesc("CUBIC pipeline options");
@@ -136,18 +233,66 @@ main(int argc, char** argv)
     ("cubic-debug-cwnd", po::value<std::string>(&cwndPath),
      "log file for CUBIC cwnd statistics")
     ("cubic-debug-rtt", po::value<std::string>(&rttPath),
-     "log file for CUBIC rtt statistics");
+     "log file for CUBIC rtt statistics")
+    ("cubic-beta", po::value<double>(&cubicBeta)->default_value(cubicBeta),
+     "CUBIC multiplicative decrease factor")
+    ("cubic-scale", po::value<double>(&cubicScale)->default_value(cubicScale),
+     "CUBIC scaling factor");
 
   po::options_description tcpbicDesc("TCPBIC pipeline options");
   tcpbicDesc.add_options()
     ("tcpbic-debug-cwnd", po::value<std::string>(&cwndPath),
      "log file for CUBIC cwnd statistics")
     ("tcpbic-debug-rtt", po::value<std::string>(&rttPath),
-     "log file for CUBIC rtt statistics");
+     "log file for CUBIC rtt statistics")
+    ("tcpbic-beta", po::value<double>(&bicBeta)->default_value(bicBeta),
+     "BIC multiplicative decrease factor")
+    ("tcpbic-max-increment", po::value<int>(&bicMaxIncrement)->default_value(bicMaxIncrement),
+     "largest cwnd increase per RTT in the BIC binary search")
+    ("tcpbic-low-window", po::value<int>(&bicLowWindow)->default_value(bicLowWindow),
+     "cwnd below which BIC behaves as standard TCP");
+
+  po::options_description statsDesc("Binary statistics options");
+  statsDesc.add_options()
+    ("debug-stats", po::value<std::string>(&statsPath),
+     "binary log file for the cwnd, rtt and rate statistics of the aimd, cubic and tcpbic "
+     "pipelines, written by a background thread; ndncatchunks-stats2tsv converts it to TSV")
+    ("debug-stats-interval", po::value<double>(&statsInterval)->default_value(statsInterval),
+     "minimum time between two logged samples of the same statistics, in seconds (0 = log all)");
+
+  po::options_description telemetryDesc("Telemetry options");
+  telemetryDesc.add_options()
+    ("telemetry-fd", po::value<int>(&telemetryFd),
+     "file descriptor receiving periodic telemetry of the retrieval as JSON lines")
+    ("telemetry-socket", po::value<std::string>(&telemetrySocketPath),
+     "Unix stream socket receiving periodic telemetry of the retrieval as JSON lines")
+    ("telemetry-interval", po::value<double>(&telemetryInterval)->default_value(telemetryInterval),
+     "time between two telemetry lines, in seconds");
+
+  po::options_description traceDesc("Tracing options");
+  traceDesc.add_options()
+    ("trace-segments", po::value<std::string>(&tracePath),
+     "file receiving the send, retransmission, arrival, validation and output times of each "
+     "segment; a per-stage latency summary is printed at the end")
+    ("trace-max-events", po::value<size_t>(&traceMaxEvents)->default_value(traceMaxEvents),
+     "number of events the tracer preallocates, later events are not traced");
+
+  po::options_description memoryDesc("Memory options");
+  memoryDesc.add_options()
+    ("reorder-buffer-cap", po::value<uint64_t>(&reorderBufferCap)->default_value(reorderBufferCap),
+     "payload bytes waiting to be written in order above which no new segment is requested "
+     "until the missing one arrives (0 = no cap)")
+    ("limit-reorder-segments", po::value<size_t>(&memoryLimits.maxBufferedSegments),
+     "abort if more segments are waiting to be written in order (0 = unlimited)")
+    ("limit-reorder-bytes", po::value<uint64_t>(&memoryLimits.maxBufferedBytes),
+     "abort if more payload bytes are waiting to be written in order (0 = unlimited)")
+    ("limit-rss", po::value<uint64_t>(&memoryLimits.maxRss),
+     "abort if the peak resident set size exceeds this many kilobytes (0 = unlimited)");
 
   po::options_description visibleDesc;
   visibleDesc.add(basicDesc).add(iterDiscoveryDesc).add(fixedPipeDesc)
-             .add(aimdPipeDesc).add(cubicPipeDesc).add(tcpbicDesc);
+             .add(aimdPipeDesc).add(cubicPipeDesc).add(tcpbicDesc).add(statsDesc)
+             .add(telemetryDesc).add(traceDesc).add(memoryDesc);
 
   po::options_description hiddenDesc;
   hiddenDesc.add_options()
@@ -212,19 +357,100 @@ main(int argc, char** argv)
     return 2;
   }
 
+  if (versionCacheTtl < 0) {
+    std::cerr << "ERROR: version cache TTL cannot be negative" << std::endl;
+    return 2;
+  }
+
+  if (statsInterval < 0) {
+    std::cerr << "ERROR: statistics interval cannot be negative" << std::endl;
+    return 2;
+  }
+
+  if (vm.count("telemetry-fd") > 0 && !telemetrySocketPath.empty()) {
+    std::cerr << "ERROR: telemetry fd and socket are mutually exclusive" << std::endl;
+    return 2;
+  }
+
+  if (vm.count("telemetry-fd") > 0 && telemetryFd < 0) {
+    std::cerr << "ERROR: telemetry fd cannot be negative" << std::endl;
+    return 2;
+  }
+
+  if (telemetryInterval < 0.001) {
+    std::cerr << "ERROR: telemetry interval must be at least 1 millisecond" << std::endl;
+    return 2;
+  }
+
+  std::vector<Name> mirrors;
+  for (const auto& mirrorUri : mirrorUris) {
+    Name mirror(mirrorUri);
+    if (mirror.empty() || !mirror[-1].isVersion()) {
+      std::cerr << "ERROR: a mirror name must end with a version component" << std::endl;
+      return 2;
+    }
+    mirrors.push_back(mirror);
+  }
+
+  if (!mirrors.empty() && pipelineType == "fixed") {
+    std::cerr << "ERROR: mirrors require the aimd, cubic or tcpbic pipeline" << std::endl;
+    return 2;
+  }
+
+  if (nSubflows < 1 || nSubflows > 64) {
+    std::cerr << "ERROR: number of parallel pipelines must be between 1 and 64" << std::endl;
+    return 2;
+  }
+
+  if (nSubflows > 1 && pipelineType == "fixed") {
+    std::cerr << "ERROR: parallel pipelines require the aimd, cubic or tcpbic pipeline" << std::endl;
+    return 2;
+  }
+
+  if (isCoupled && pipelineType != "aimd") {
+    std::cerr << "ERROR: coupled parallel pipelines require the aimd pipeline" << std::endl;
+    return 2;
+  }
+
+  if (followWindow < 1) {
+    std::cerr << "ERROR: follow window must be at least 1" << std::endl;
+    return 2;
+  }
+
+  if (!byteRange.empty() && !segmentRange.empty()) {
+    std::cerr << "ERROR: byte range and segment range are mutually exclusive" << std::endl;
+    return 2;
+  }
+
+  if ((!byteRange.empty() && !parseRange(byteRange, rangeFirst, rangeLast)) ||
+      (!segmentRange.empty() && !parseRange(segmentRange, rangeFirst, rangeLast))) {
+    std::cerr << "ERROR: a range must be written FIRST-LAST, with FIRST not greater than LAST"
+              << std::endl;
+    return 2;
+  }
+
   options.interestLifetime = time::milliseconds(vm["lifetime"].as<uint64_t>());
 
   try {
     Face face;
 
     unique_ptr<DiscoverVersion> discover;
+    unique_ptr<VersionCache> versionCache;
     if (discoverType == "fixed") {
       discover = make_unique<DiscoverVersionFixed>(prefix, face, options);
     }
-    else if (discoverType == "iterative") {
+    else if (discoverType == "iterative" || discoverType == "speculative") {
       DiscoverVersionIterative::Options optionsIterative(options);
       optionsIterative.maxRetriesAfterVersionFound = maxRetriesAfterVersionFound;
-      discover = make_unique<DiscoverVersionIterative>(prefix, face, optionsIterative);
+      optionsIterative.isSpeculative = discoverType == "speculative";
+      if (!versionCachePath.empty()) {
+        versionCache = make_unique<VersionCache>(versionCachePath, time::seconds(versionCacheTtl));
+        versionCache->load();
+        discover = make_unique<DiscoverVersionCached>(prefix, face, optionsIterative, *versionCache);
+      }
+      else {
+        discover = make_unique<DiscoverVersionIterative>(prefix, face, optionsIterative);
+      }
     }
     else {
       std::cerr << "ERROR: discover version type not valid" << std::endl;
@@ -235,9 +461,25 @@ main(int argc, char** argv)
     unique_ptr<aimd::StatisticsCollector> statsCollector;
     unique_ptr<aimd::RttEstimator> rttEstimator;
     unique_ptr<aimd::RateEstimator> rateEstimator;
+    // the pipelines running in parallel with the first one, with their own estimators
+    std::vector<unique_ptr<PipelineInterests>> subflows;
+    std::vector<unique_ptr<aimd::RttEstimator>> subflowRttEstimators;
+    std::vector<unique_ptr<aimd::RateEstimator>> subflowRateEstimators;
     std::ofstream statsFileCwnd;
     std::ofstream statsFileRtt;
     std::ofstream statsFileRate;
+    std::ofstream statsFileBinary;
+    unique_ptr<aimd::BinaryStatisticsCollector> binaryStatsCollector;
+    aimd::BinaryStatisticsCollector::Options optionsStats;
+    optionsStats.downsampleInterval = statsInterval;
+
+    if (!statsPath.empty()) {
+      statsFileBinary.open(statsPath, std::ios::binary);
+      if (statsFileBinary.fail()) {
+        std::cerr << "ERROR: failed to open " << statsPath << std::endl;
+        return 4;
+      }
+    }
 
     if (pipelineType == "fixed") {
       PipelineInterestsFixedWindow::Options optionsPipeline(options);
@@ -252,12 +494,20 @@ main(int argc, char** argv)
       optionsRttEst.k = k;
       optionsRttEst.minRto = aimd::Milliseconds(minRto);
       optionsRttEst.maxRto = aimd::Milliseconds(maxRto);
+      optionsRttEst.minRttWindow = aimd::Milliseconds(minRttWindow);
+
+      aimd::RateEstimator::Options optionsRateEst;
+      optionsRateEst.isVerbose = options.isVerbose;
+      optionsRateEst.rateInterval = rateInterval;
+      optionsRateEst.maxFilterRtts = rateFilterRtts;
 
       rttEstimator = make_unique<aimd::RttEstimator>(optionsRttEst);
-      rateEstimator = make_unique<aimd::RateEstimator>(rateInterval);
+      rateEstimator = make_unique<aimd::RateEstimator>(optionsRateEst);
 
       PipelineInterestsAimd::Options optionsPipeline;
       optionsPipeline.isVerbose = options.isVerbose;
+      optionsPipeline.isFollowing = options.isFollowing;
+      optionsPipeline.followWindow = followWindow;
       optionsPipeline.disableCwa = disableCwa;
       optionsPipeline.resetCwndToInit = resetCwndToInit;
       optionsPipeline.initCwnd = static_cast<double>(initCwnd);
@@ -295,7 +545,31 @@ main(int argc, char** argv)
                                                                 statsFileCwnd, statsFileRtt,
                                                                 statsFileRate);
       }
+      if (!statsPath.empty()) {
+        binaryStatsCollector = make_unique<aimd::BinaryStatisticsCollector>(*aimdPipeline,
+                                                                            *rttEstimator,
+                                                                            *rateEstimator,
+                                                                            statsFileBinary,
+                                                                            optionsStats);
+      }
 
+      aimdPipeline->setMirrors(mirrors);
+
+      std::vector<PipelineInterestsAimd*> aimdSubflows{aimdPipeline.get()};
+      for (size_t i = 1; i < nSubflows; ++i) {
+        subflowRttEstimators.push_back(make_unique<aimd::RttEstimator>(optionsRttEst));
+        subflowRateEstimators.push_back(make_unique<aimd::RateEstimator>(optionsRateEst));
+        auto subflow = make_unique<PipelineInterestsAimd>(face, *subflowRttEstimators.back(),
+                                                          *subflowRateEstimators.back(), optionsPipeline);
+        subflow->setMirrors(mirrors);
+        aimdSubflows.push_back(subflow.get());
+        subflows.push_back(std::move(subflow));
+      }
+      if (isCoupled && nSubflows > 1) {
+        std::vector<const PipelineInterestsAimd*> coupled(aimdSubflows.begin(), aimdSubflows.end());
+        for (auto subflow : aimdSubflows)
+          subflow->setCoupledSubflows(coupled);
+      }
       pipeline = std::move(aimdPipeline);
     }
     else if (pipelineType == "cubic") {
@@ -306,18 +580,28 @@ main(int argc, char** argv)
       optionsRttEst.k = k;
       optionsRttEst.minRto = aimd::Milliseconds(minRto);
       optionsRttEst.maxRto = aimd::Milliseconds(maxRto);
+      optionsRttEst.minRttWindow = aimd::Milliseconds(minRttWindow);
+
+      aimd::RateEstimator::Options optionsRateEst;
+      optionsRateEst.isVerbose = options.isVerbose;
+      optionsRateEst.rateInterval = rateInterval;
+      optionsRateEst.maxFilterRtts = rateFilterRtts;
 
       rttEstimator = make_unique<aimd::RttEstimator>(optionsRttEst);
-      rateEstimator = make_unique<aimd::RateEstimator>(rateInterval);
+      rateEstimator = make_unique<aimd::RateEstimator>(optionsRateEst);
 
       PipelineInterestsCubic::Options optionsPipeline;
       optionsPipeline.isVerbose = options.isVerbose;
+      optionsPipeline.isFollowing = options.isFollowing;
+      optionsPipeline.followWindow = followWindow;
       optionsPipeline.disableCwa = disableCwa;
       optionsPipeline.resetCwndToInit = resetCwndToInit;
       optionsPipeline.initCwnd = static_cast<double>(initCwnd);
       optionsPipeline.initSsthresh = static_cast<double>(initSsthresh);
       optionsPipeline.aiStep = aiStep;
       optionsPipeline.rateInterval = rateInterval;
+      optionsPipeline.cubicBeta = cubicBeta;
+      optionsPipeline.cubicScale = cubicScale;
 
       auto cubicPipeline = make_unique<PipelineInterestsCubic>(face, *rttEstimator, *rateEstimator, optionsPipeline);
 
@@ -347,8 +631,25 @@ main(int argc, char** argv)
                                                                 *rateEstimator,
                                                                 statsFileCwnd, statsFileRtt,
                                                                 statsFileRate);
-        pipeline = std::move(cubicPipeline);
       }
+      if (!statsPath.empty()) {
+        binaryStatsCollector = make_unique<aimd::BinaryStatisticsCollector>(*cubicPipeline,
+                                                                            *rttEstimator,
+                                                                            *rateEstimator,
+                                                                            statsFileBinary,
+                                                                            optionsStats);
+      }
+      cubicPipeline->setMirrors(mirrors);
+
+      for (size_t i = 1; i < nSubflows; ++i) {
+        subflowRttEstimators.push_back(make_unique<aimd::RttEstimator>(optionsRttEst));
+        subflowRateEstimators.push_back(make_unique<aimd::RateEstimator>(optionsRateEst));
+        auto subflow = make_unique<PipelineInterestsCubic>(face, *subflowRttEstimators.back(),
+                                                           *subflowRateEstimators.back(), optionsPipeline);
+        subflow->setMirrors(mirrors);
+        subflows.push_back(std::move(subflow));
+      }
+      pipeline = std::move(cubicPipeline);
     }
     else if (pipelineType == "tcpbic") {
       aimd::RttEstimator::Options optionsRttEst;
@@ -358,12 +659,20 @@ main(int argc, char** argv)
       optionsRttEst.k = k;
       optionsRttEst.minRto = aimd::Milliseconds(minRto);
       optionsRttEst.maxRto = aimd::Milliseconds(maxRto);
+      optionsRttEst.minRttWindow = aimd::Milliseconds(minRttWindow);
+
+      aimd::RateEstimator::Options optionsRateEst;
+      optionsRateEst.isVerbose = options.isVerbose;
+      optionsRateEst.rateInterval = rateInterval;
+      optionsRateEst.maxFilterRtts = rateFilterRtts;
 
       rttEstimator = make_unique<aimd::RttEstimator>(optionsRttEst);
-      rateEstimator = make_unique<aimd::RateEstimator>(rateInterval);
+      rateEstimator = make_unique<aimd::RateEstimator>(optionsRateEst);
 
       PipelineInterestsTcpBic::Options optionsPipeline;
       optionsPipeline.isVerbose = options.isVerbose;
+      optionsPipeline.isFollowing = options.isFollowing;
+      optionsPipeline.followWindow = followWindow;
       optionsPipeline.disableCwa = disableCwa;
       optionsPipeline.resetCwndToInit = resetCwndToInit;
       optionsPipeline.initCwnd = static_cast<double>(initCwnd);
@@ -371,6 +680,9 @@ main(int argc, char** argv)
       optionsPipeline.aiStep = aiStep;
       optionsPipeline.mdCoef = mdCoef;
       optionsPipeline.rateInterval = rateInterval;
+      optionsPipeline.bicBeta = bicBeta;
+      optionsPipeline.bicMaxIncrement = bicMaxIncrement;
+      optionsPipeline.bicLowWindow = bicLowWindow;
 
       auto tcpbicPipeline = make_unique<PipelineInterestsTcpBic>(face, *rttEstimator, *rateEstimator, optionsPipeline);
 
@@ -401,6 +713,23 @@ main(int argc, char** argv)
                                                                 statsFileCwnd, statsFileRtt,
                                                                 statsFileRate);
       }
+      if (!statsPath.empty()) {
+        binaryStatsCollector = make_unique<aimd::BinaryStatisticsCollector>(*tcpbicPipeline,
+                                                                            *rttEstimator,
+                                                                            *rateEstimator,
+                                                                            statsFileBinary,
+                                                                            optionsStats);
+      }
+      tcpbicPipeline->setMirrors(mirrors);
+
+      for (size_t i = 1; i < nSubflows; ++i) {
+        subflowRttEstimators.push_back(make_unique<aimd::RttEstimator>(optionsRttEst));
+        subflowRateEstimators.push_back(make_unique<aimd::RateEstimator>(optionsRateEst));
+        auto subflow = make_unique<PipelineInterestsTcpBic>(face, *subflowRttEstimators.back(),
+                                                            *subflowRateEstimators.back(), optionsPipeline);
+        subflow->setMirrors(mirrors);
+        subflows.push_back(std::move(subflow));
+      }
       pipeline = std::move(tcpbicPipeline);
     }
     else {
@@ -408,13 +737,100 @@ main(int argc, char** argv)
       return 2;
     }
 
+    if (!subflows.empty()) {
+      // the statistics collectors follow the first pipeline only
+      subflows.insert(subflows.begin(), std::move(pipeline));
+      pipeline = make_unique<PipelineInterestsParallel>(face, std::move(subflows));
+    }
+
+    unique_ptr<SegmentTracer> tracer;
+    std::ofstream traceFile;
+    if (!tracePath.empty()) {
+      traceFile.open(tracePath);
+      if (traceFile.fail()) {
+        std::cerr << "ERROR: failed to open " << tracePath << std::endl;
+        return 4;
+      }
+      tracer = make_unique<SegmentTracer>(traceMaxEvents, pipeline->getClock());
+      pipeline->setTracer(tracer.get());
+    }
+
+    unique_ptr<OutputWriter> outputWriter;
+    if (outputOptions.queueSize > 0)
+      outputWriter = make_unique<OutputWriter>(STDOUT_FILENO, face.getIoService(), outputOptions);
+    if (options.isVerbose && outputWriter != nullptr && outputWriter->isSplicing())
+      std::cerr << "Standard output is a pipe, passing the segments to vmsplice" << std::endl;
+
     ValidatorNull validator;
     Consumer consumer(validator, options.isVerbose);
+    consumer.setOutputWriter(outputWriter.get());
+    if (printDigest || !expectedDigest.empty())
+      consumer.enableDigest();
+    if (!byteRange.empty())
+      consumer.setByteRange(rangeFirst, rangeLast);
+    else if (!segmentRange.empty())
+      consumer.setSegmentRange(rangeFirst, rangeLast);
+    // the Consumer times its events on the same clock as the pipeline
+    consumer.setClock(pipeline->getClock());
+    consumer.setTracer(tracer.get());
+    consumer.setMemoryLimits(memoryLimits);
+    consumer.setBackpressureThreshold(reorderBufferCap);
 
     BOOST_ASSERT(discover != nullptr);
     BOOST_ASSERT(pipeline != nullptr);
     consumer.run(std::move(discover), std::move(pipeline));
+
+    unique_ptr<TelemetryReporter> telemetry;
+    if (!telemetrySocketPath.empty())
+      telemetryFd = TelemetryReporter::connectUnixSocket(telemetrySocketPath);
+    if (telemetryFd >= 0) {
+      auto interval = time::duration_cast<time::milliseconds>(time::duration<double>(telemetryInterval));
+      telemetry = make_unique<TelemetryReporter>(face, consumer, telemetryFd, interval);
+      telemetry->start();
+    }
+
     face.processEvents();
+
+    // rethrows an output error of the writer thread
+    consumer.flushOutput();
+
+    // a digest mismatch still closes the telemetry and reports the trace and statistics
+    int exitCode = 0;
+    if (printDigest || !expectedDigest.empty()) {
+      std::string digest = consumer.getDigest();
+      if (printDigest)
+        std::cerr << "SHA-256: " << digest << std::endl;
+      if (!expectedDigest.empty() && !boost::iequals(digest, expectedDigest)) {
+        std::cerr << "ERROR: SHA-256 digest mismatch, expected " << expectedDigest
+                  << " but retrieved " << digest << std::endl;
+        exitCode = 5;
+      }
+    }
+
+    if (!telemetrySocketPath.empty())
+      ::close(telemetryFd);
+
+    if (tracer != nullptr) {
+      tracer->dump(traceFile);
+      tracer->printSummary(std::cerr);
+    }
+
+    if (options.isVerbose) {
+      PipelineStatus status = consumer.getPipeline()->getStatus();
+      std::cerr << "Peak reorder buffer: " << consumer.getMaxBufferedSegments() << " segments, "
+                << consumer.getMaxBufferedBytes() << " bytes\n"
+                << "Peak pipeline state: " << status.maxSegmentInfoSize << " segment entries, "
+                << status.maxRetxQueueSize << " queued retransmissions\n"
+                << "Peak RSS: " << getPeakRss() << " kB" << std::endl;
+    }
+
+    if (binaryStatsCollector != nullptr && binaryStatsCollector->getNDroppedRecords() > 0) {
+      std::cerr << "WARNING: " << binaryStatsCollector->getNDroppedRecords()
+                << " statistics records were dropped, consider --debug-stats-interval" << std::endl;
+    }
+
+    if (exitCode != 0)
+      return exitCode;
   }
 
   catch (const Consumer::ApplicationNackError& e) {
@@ -36,6 +36,7 @@ Options::Options()
   , maxRetriesOnTimeoutOrNack(3)
   , mustBeFresh(false)
   , isVerbose(false)
+  , isFollowing(false)
 {
 }
 
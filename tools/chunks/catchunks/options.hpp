@@ -42,6 +42,7 @@ public:
   int maxRetriesOnTimeoutOrNack;
   bool mustBeFresh;
   bool isVerbose;
+  bool isFollowing; ///< keep requesting the segments of a growing object until its end is known
 };
 
 } // namespace chunks
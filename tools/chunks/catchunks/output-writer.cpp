@@ -0,0 +1,397 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "output-writer.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ndn {
+namespace chunks {
+
+static const int MAX_IOVECS = 1024; ///< segments gathered into one writev or vmsplice call
+
+OutputWriter::OutputWriter(std::ostream* os, int fd, boost::asio::io_service& io,
+                           const Options& options)
+  : m_options(options)
+  , m_os(os)
+  , m_fd(fd)
+  , m_isPipe(false)
+  , m_io(io)
+  , m_head(0)
+  , m_tail(0)
+  , m_isFull(false)
+  , m_offset(0)
+  , m_nSpliced(0)
+  , m_nWrittenBytes(0)
+  , m_clock(nullptr)
+  , m_hasError(false)
+  , m_isStopping(false)
+  , m_isWriterWaiting(false)
+  , m_isFlushing(false)
+{
+  size_t size = 1;
+  while (size < m_options.queueSize)
+    size <<= 1;
+  m_queue.resize(size);
+  m_mask = size - 1;
+
+#ifdef __linux__
+  struct stat st;
+  m_isPipe = m_options.allowVmsplice && m_fd >= 0 && ::fstat(m_fd, &st) == 0 &&
+             S_ISFIFO(st.st_mode);
+#endif
+
+  m_writer = std::thread(&OutputWriter::run, this);
+}
+
+OutputWriter::OutputWriter(std::ostream& os, boost::asio::io_service& io, const Options& options)
+  : OutputWriter(&os, -1, io, options)
+{
+}
+
+OutputWriter::OutputWriter(int fd, boost::asio::io_service& io, const Options& options)
+  : OutputWriter(nullptr, fd, io, options)
+{
+}
+
+OutputWriter::~OutputWriter()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_isStopping.store(true, std::memory_order_release);
+    m_hasSegments.notify_one();
+  }
+  if (m_writer.joinable())
+    m_writer.join();
+}
+
+bool
+OutputWriter::push(shared_ptr<const Data>& data)
+{
+  size_t head = m_head.load(std::memory_order_relaxed);
+  if (head - m_tail.load(std::memory_order_acquire) == m_queue.size()) {
+    if (m_work == nullptr)
+      m_work = make_unique<boost::asio::io_service::work>(m_io);
+    m_isFull.store(true, std::memory_order_seq_cst);
+    // the writer thread may have emptied the queue and be waiting without having seen m_isFull
+    wakeWriter();
+    return false;
+  }
+
+  m_queue[head & m_mask] = std::move(data);
+  m_head.store(head + 1, std::memory_order_seq_cst);
+  wakeWriter();
+  return true;
+}
+
+void
+OutputWriter::wakeWriter()
+{
+  // the writer thread sets m_isWriterWaiting before it checks the queue: either it sees the
+  // segment, or it is seen waiting here, and notified once it has released the mutex in wait
+  if (m_isWriterWaiting.load(std::memory_order_seq_cst)) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_hasSegments.notify_one();
+  }
+}
+
+void
+OutputWriter::waitForSegments()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_isWriterWaiting.store(true, std::memory_order_seq_cst);
+  m_hasSegments.wait(lock, [this] {
+    return m_head.load(std::memory_order_seq_cst) != m_tail.load(std::memory_order_relaxed) ||
+           m_isFull.load(std::memory_order_seq_cst) ||
+           m_isStopping.load(std::memory_order_acquire);
+  });
+  m_isWriterWaiting.store(false, std::memory_order_relaxed);
+}
+
+void
+OutputWriter::flush()
+{
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_isFlushing.store(true, std::memory_order_seq_cst);
+    m_isDrained.wait(lock, [this] {
+      return m_tail.load(std::memory_order_seq_cst) == m_head.load(std::memory_order_relaxed);
+    });
+    m_isFlushing.store(false, std::memory_order_relaxed);
+  }
+
+  if (m_hasError.load(std::memory_order_acquire))
+    throw Error(m_error);
+
+  // the writer thread does not touch the stream while the queue is empty
+  if (m_os != nullptr && !m_os->flush())
+    throw Error("Failed to write the output");
+}
+
+size_t
+OutputWriter::writeSegments()
+{
+  if (m_os == nullptr)
+    return writeSegmentsToFd();
+
+  size_t tail = m_tail.load(std::memory_order_relaxed);
+  size_t head = m_head.load(std::memory_order_acquire);
+
+  for (size_t i = tail; i != head; ++i) {
+    if (m_hasError.load(std::memory_order_relaxed)) {
+      fail(m_error);
+      break;
+    }
+
+    shared_ptr<const Data> data = std::move(m_queue[i & m_mask]);
+    const Block& content = data->getContent();
+    m_os->write(reinterpret_cast<const char*>(content.value()), content.value_size());
+    if (!*m_os) {
+      fail("Failed to write the output");
+      break;
+    }
+    m_nWrittenBytes.fetch_add(content.value_size(), std::memory_order_relaxed);
+    data.reset();
+    recordWriteTime(1);
+    // release each slot as soon as it is written, so that a full queue drains early
+    m_tail.store(i + 1, std::memory_order_release);
+  }
+  return head - tail;
+}
+
+size_t
+OutputWriter::writeSegmentsToFd()
+{
+  size_t tail = m_tail.load(std::memory_order_relaxed);
+  size_t head = m_head.load(std::memory_order_acquire);
+  size_t nSegments = head - tail;
+
+  while (tail != head) {
+    if (m_hasError.load(std::memory_order_relaxed)) {
+      fail(m_error);
+      break;
+    }
+
+    iovec iovecs[MAX_IOVECS];
+    int nIovecs = 0;
+    size_t nBytes = 0;
+    for (size_t i = tail; i != head && nIovecs < MAX_IOVECS; ++i) {
+      const Block& content = m_queue[i & m_mask]->getContent();
+      size_t offset = i == tail ? m_offset : 0;
+      if (content.value_size() == offset)
+        continue;
+      iovecs[nIovecs].iov_base = const_cast<uint8_t*>(content.value()) + offset;
+      iovecs[nIovecs].iov_len = content.value_size() - offset;
+      nBytes += iovecs[nIovecs].iov_len;
+      ++nIovecs;
+    }
+
+    ssize_t nWritten = nBytes > 0 ? writeIovecs(iovecs, nIovecs) : 0;
+    bool wasSpliced = m_isPipe;
+    if (nWritten < 0) {
+      fail("Failed to write the output: " + std::string(std::strerror(errno)));
+      break;
+    }
+    m_nWrittenBytes.fetch_add(nWritten, std::memory_order_relaxed);
+
+    // release the slots of the segments written entirely, keeping the spliced ones
+    size_t nLeft = static_cast<size_t>(nWritten);
+    size_t nCompleted = 0;
+    uint64_t position = m_nSpliced; // where the part of the segment at tail starts in the pipe
+    while (tail != head) {
+      shared_ptr<const Data>& data = m_queue[tail & m_mask];
+      size_t nRemaining = data->getContent().value_size() - m_offset;
+      if (nLeft < nRemaining) {
+        m_offset += nLeft;
+        break;
+      }
+      nLeft -= nRemaining;
+      position += nRemaining;
+      m_offset = 0;
+
+      if (wasSpliced)
+        m_inPipe.emplace_back(std::move(data), position);
+      else
+        data.reset();
+      ++nCompleted;
+      m_tail.store(++tail, std::memory_order_release);
+    }
+    recordWriteTime(nCompleted);
+
+    if (wasSpliced)
+      m_nSpliced += nWritten;
+  }
+
+  if (!m_inPipe.empty())
+    releaseConsumedSegments();
+  return nSegments;
+}
+
+ssize_t
+OutputWriter::writeIovecs(const iovec* iovecs, int nIovecs)
+{
+  while (true) {
+    ssize_t nWritten;
+#ifdef __linux__
+    if (m_isPipe)
+      nWritten = ::vmsplice(m_fd, iovecs, nIovecs, 0);
+    else
+#endif
+      nWritten = ::writev(m_fd, iovecs, nIovecs);
+    if (nWritten >= 0)
+      return nWritten;
+
+    if (errno == EINTR)
+      continue;
+
+    if (errno == EAGAIN || errno == EWOULDBLOCK) {
+      pollfd pfd{m_fd, POLLOUT, 0};
+      ::poll(&pfd, 1, -1);
+      continue;
+    }
+
+#ifdef __linux__
+    if (m_isPipe && (errno == EINVAL || errno == ENOSYS)) {
+      // vmsplice is not available for this pipe, copy the segments instead
+      m_isPipe = false;
+      continue;
+    }
+#endif
+    return -1;
+  }
+}
+
+void
+OutputWriter::releaseConsumedSegments()
+{
+  int nUnread = 0;
+  if (::ioctl(m_fd, FIONREAD, &nUnread) < 0) {
+    m_inPipe.clear();
+    return;
+  }
+
+  // data written to the pipe by others only delays the release
+  uint64_t nConsumed = m_nSpliced > static_cast<uint64_t>(nUnread) ? m_nSpliced - nUnread : 0;
+  while (!m_inPipe.empty() && m_inPipe.front().second <= nConsumed)
+    m_inPipe.pop_front();
+}
+
+void
+OutputWriter::recordWriteTime(size_t nSegments)
+{
+  if (m_clock == nullptr || nSegments == 0)
+    return;
+
+  auto now = m_clock->now();
+  std::lock_guard<std::mutex> lock(m_writeTimesMutex);
+  m_writeTimes.insert(m_writeTimes.end(), nSegments, now);
+}
+
+void
+OutputWriter::takeWriteTimes(std::vector<time::steady_clock::TimePoint>& times)
+{
+  times.clear();
+  std::lock_guard<std::mutex> lock(m_writeTimesMutex);
+  times.swap(m_writeTimes);
+}
+
+void
+OutputWriter::fail(const std::string& reason)
+{
+  if (!m_hasError.load(std::memory_order_relaxed)) {
+    m_error = reason;
+    m_hasError.store(true, std::memory_order_release);
+    // the segments fetched from now on could not be written either
+    m_io.post([this] {
+      if (m_onFailure)
+        m_onFailure(m_error);
+    });
+  }
+
+  size_t tail = m_tail.load(std::memory_order_relaxed);
+  size_t head = m_head.load(std::memory_order_acquire);
+  for (; tail != head; ++tail)
+    m_queue[tail & m_mask].reset();
+  m_offset = 0;
+  m_tail.store(head, std::memory_order_release);
+}
+
+void
+OutputWriter::run()
+{
+  while (!m_isStopping.load(std::memory_order_acquire)) {
+    size_t nWritten = writeSegments();
+
+    // flush() sets m_isFlushing before it checks m_tail: either it sees the queue empty,
+    // or it is seen waiting here
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (nWritten > 0 && m_isFlushing.load(std::memory_order_relaxed)) {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_isDrained.notify_one();
+    }
+
+    // also checked when nothing was written, as the Face thread may have found the queue
+    // full just before the previous call made room
+    if (m_isFull.load(std::memory_order_acquire) &&
+        m_head.load(std::memory_order_relaxed) - m_tail.load(std::memory_order_relaxed) < m_queue.size()) {
+      m_isFull.store(false, std::memory_order_relaxed);
+      m_io.post([this] {
+        m_work.reset();
+        if (m_onSpaceAvailable)
+          m_onSpaceAvailable();
+      });
+    }
+
+    if (m_head.load(std::memory_order_relaxed) == m_tail.load(std::memory_order_relaxed))
+      waitForSegments();
+  }
+
+  // the Face thread is done, write what is left
+  writeSegments();
+  if (m_os != nullptr)
+    m_os->flush();
+
+  // the pipe refers to the memory of the spliced segments until they are read; poll returns
+  // as soon as the reader closes the pipe, otherwise the unread bytes are checked again
+  auto interval = time::duration_cast<time::milliseconds>(m_options.drainCheckInterval);
+  int timeout = std::max<int>(interval.count(), 1);
+  while (!m_inPipe.empty()) {
+    releaseConsumedSegments();
+    if (m_inPipe.empty())
+      break;
+    pollfd pfd{m_fd, 0, 0};
+    if (::poll(&pfd, 1, timeout) > 0 && (pfd.revents & POLLERR) != 0)
+      break; // no reader is left
+  }
+}
+
+} // namespace chunks
+} // namespace ndn
@@ -0,0 +1,292 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#ifndef NDN_TOOLS_CHUNKS_CATCHUNKS_OUTPUT_WRITER_HPP
+#define NDN_TOOLS_CHUNKS_CATCHUNKS_OUTPUT_WRITER_HPP
+
+#include "pipeline-clock.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include <sys/uio.h>
+
+namespace ndn {
+namespace chunks {
+
+/**
+ * @brief Writes the content of the retrieved segments from a dedicated thread
+ *
+ * The Face thread hands each in-order segment over through a bounded single-producer
+ * single-consumer queue, so that a slow pipe or disk never stalls the event loop and the
+ * retransmission timers of the pipeline. The Data are moved into the queue; their content
+ * is not copied before it reaches the output.
+ *
+ * When the queue is full, push() fails and the Face thread keeps the segment. Once the writer
+ * thread has made room, the space callback is invoked on the io_service of the Face thread,
+ * which is kept running until then. Likewise, the failure callback is invoked on that io_service
+ * as soon as writing the output fails, so that the retrieval stops without waiting for flush().
+ *
+ * The queue itself is lock-free. The writer thread blocks on a condition variable while the
+ * queue is empty, and push() takes the mutex to wake it up only when it is waiting; flush()
+ * blocks likewise until the writer thread has emptied the queue.
+ */
+class OutputWriter : noncopyable
+{
+public:
+  class Error : public std::runtime_error
+  {
+  public:
+    explicit
+    Error(const std::string& what)
+      : std::runtime_error(what)
+    {
+    }
+  };
+
+  class Options
+  {
+  public:
+    Options()
+      : queueSize(4096)
+      , drainCheckInterval(time::milliseconds(1))
+      , allowVmsplice(false)
+    {
+    }
+
+  public:
+    size_t queueSize; ///< capacity of the queue, rounded up to a power of two (unit: segment)
+    /**
+     * @brief interval between the checks, at destruction, of whether the reader of the pipe
+     *        has consumed the spliced segments
+     *
+     * Nothing signals that a pipe has been emptied, only that its reader has closed it.
+     */
+    time::nanoseconds drainCheckInterval;
+    /**
+     * @brief pass the segments to vmsplice when the file descriptor is a pipe (Linux only)
+     *
+     * The pipe keeps referring to the memory of a segment after its bytes have been read:
+     * a reader that moves them with splice or tee, instead of copying them with read, may
+     * still use that memory once the segment has been released. Enable only when the reader
+     * of the pipe is known to copy its input.
+     */
+    bool allowVmsplice;
+  };
+
+  /**
+   * @param os the output stream, accessed only by the writer thread until flush() or destruction
+   * @param io the io_service of the Face thread
+   */
+  OutputWriter(std::ostream& os, boost::asio::io_service& io, const Options& options = Options());
+
+  /**
+   * @brief write directly to the file descriptor @p fd, which is not closed by the writer
+   *
+   * The contents of consecutive segments are gathered into a single writev call. On Linux,
+   * if @p fd is a pipe and Options::allowVmsplice is set, they are passed to vmsplice instead:
+   * the pipe then refers to the memory of the Data rather than to a copy, so each segment is
+   * kept until the reader of the pipe has consumed it.
+   */
+  OutputWriter(int fd, boost::asio::io_service& io, const Options& options = Options());
+
+  /**
+   * @brief stop the writer thread after it wrote the queued segments, then flush the output
+   *
+   * With vmsplice, also waits until the reader of the pipe has consumed the segments, or has
+   * closed the pipe.
+   */
+  ~OutputWriter();
+
+  /**
+   * @brief queue the content of @p data for writing, called by the Face thread only
+   *
+   * @return true if @p data was moved into the queue; false if the queue is full, in which
+   *         case @p data is left untouched and the space callback will be invoked
+   */
+  bool
+  push(shared_ptr<const Data>& data);
+
+  /**
+   * @return payload bytes written to the output so far, can be called from any thread
+   */
+  uint64_t
+  getNWrittenBytes() const
+  {
+    return m_nWrittenBytes.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief record the time at which each segment has been entirely written, read from @p clock
+   *
+   * @pre no segment has been pushed yet
+   * @note @p clock is read by the writer thread, and must outlive the writer
+   */
+  void
+  enableWriteTimes(const PipelineClock& clock)
+  {
+    m_clock = &clock;
+  }
+
+  /**
+   * @brief move the write times recorded since the last call into @p times
+   *
+   * The times are in the order of the push() calls, one per segment written since the last
+   * call; the segments written by one system call share the same time.
+   */
+  void
+  takeWriteTimes(std::vector<time::steady_clock::TimePoint>& times);
+
+  /**
+   * @brief set the function invoked on the Face thread after a failed push, once there is room
+   */
+  void
+  setSpaceCallback(const function<void()>& callback)
+  {
+    m_onSpaceAvailable = callback;
+  }
+
+  /**
+   * @brief set the function invoked on the Face thread with the reason, once writing has failed
+   */
+  void
+  setFailureCallback(const function<void(const std::string&)>& callback)
+  {
+    m_onFailure = callback;
+  }
+
+  /**
+   * @brief block until the queued segments have been written, then flush the output stream
+   *
+   * Called by the Face thread only.
+   * @throw Error writing the output failed; the segments queued since were dropped
+   */
+  void
+  flush();
+
+  /**
+   * @return true if the segments are passed to vmsplice
+   */
+  bool
+  isSplicing() const
+  {
+    return m_isPipe;
+  }
+
+private:
+  OutputWriter(std::ostream* os, int fd, boost::asio::io_service& io, const Options& options);
+
+  size_t
+  writeSegments();
+
+  /**
+   * @brief wake up the writer thread if it waits for segments, called by the Face thread only
+   */
+  void
+  wakeWriter();
+
+  /**
+   * @brief block the writer thread until a segment is queued, a push fails, or it is stopped
+   */
+  void
+  waitForSegments();
+
+  size_t
+  writeSegmentsToFd();
+
+  /**
+   * @brief write @p nIovecs buffers to m_fd, retrying on EINTR and EAGAIN
+   * @return the number of bytes written, or -1 on error
+   */
+  ssize_t
+  writeIovecs(const iovec* iovecs, int nIovecs);
+
+  /**
+   * @brief drop the spliced segments that the reader of the pipe has consumed
+   */
+  void
+  releaseConsumedSegments();
+
+  /**
+   * @brief drop the queued segments after an error, so that the Face thread is not blocked
+   *
+   * The first error is posted to the failure callback.
+   */
+  void
+  fail(const std::string& reason);
+
+  /**
+   * @brief record that @p nSegments more segments have been entirely written
+   */
+  void
+  recordWriteTime(size_t nSegments);
+
+  void
+  run();
+
+private:
+  const Options m_options;
+  std::ostream* m_os; ///< nullptr when writing to m_fd
+  int m_fd;
+  std::atomic<bool> m_isPipe; ///< true if the segments are passed to vmsplice
+  boost::asio::io_service& m_io;
+  function<void()> m_onSpaceAvailable;
+  function<void(const std::string&)> m_onFailure;
+  unique_ptr<boost::asio::io_service::work> m_work; ///< keeps m_io running while a push has failed
+
+  std::vector<shared_ptr<const Data>> m_queue;
+  size_t m_mask;
+  std::atomic<size_t> m_head; ///< next slot filled by the Face thread
+  std::atomic<size_t> m_tail; ///< next slot written by the writer thread
+  std::atomic<bool> m_isFull; ///< a push has failed and the Face thread waits for room
+
+  // state of the writer thread
+  size_t m_offset; ///< bytes of the segment at m_tail already written to m_fd
+  uint64_t m_nSpliced; ///< bytes passed to vmsplice
+  /// spliced segments that may still be in the pipe, with the value of m_nSpliced at their end
+  std::deque<std::pair<shared_ptr<const Data>, uint64_t>> m_inPipe;
+  std::string m_error; ///< set before m_hasError
+  std::atomic<uint64_t> m_nWrittenBytes;
+
+  const PipelineClock* m_clock; ///< nullptr unless the write times are recorded
+  std::mutex m_writeTimesMutex;
+  std::vector<time::steady_clock::TimePoint> m_writeTimes; ///< guarded by m_writeTimesMutex
+
+  std::atomic<bool> m_hasError;
+  std::atomic<bool> m_isStopping;
+
+  std::mutex m_mutex; ///< guards the waits on the condition variables
+  std::condition_variable m_hasSegments; ///< notified by the Face thread to the writer thread
+  std::condition_variable m_isDrained; ///< notified by the writer thread to flush()
+  std::atomic<bool> m_isWriterWaiting; ///< set under m_mutex before the writer thread waits
+  std::atomic<bool> m_isFlushing; ///< set under m_mutex before flush() waits
+  std::thread m_writer;
+};
+
+} // namespace chunks
+} // namespace ndn
+
+#endif // NDN_TOOLS_CHUNKS_CATCHUNKS_OUTPUT_WRITER_HPP
@@ -0,0 +1,71 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#ifndef NDN_TOOLS_CHUNKS_CATCHUNKS_PIPELINE_CLOCK_HPP
+#define NDN_TOOLS_CHUNKS_CATCHUNKS_PIPELINE_CLOCK_HPP
+
+#include "core/common.hpp"
+
+namespace ndn {
+namespace chunks {
+
+/**
+ * @brief Source of the time used by the Interest pipelines
+ *
+ * The pipelines read the clock once per event (arrival of a Data, Nack or timeout, expiration of
+ * one of their timers) and use that timestamp for every computation of the event.
+ *
+ * The default clock reads time::steady_clock, which simulations and tests can replace with
+ * time::setCustomClocks. A subclass can provide another monotonic source, e.g. a cheaper one.
+ * The timers of the pipelines are still run by the Face's io_service on time::steady_clock, so
+ * the time returned by a custom clock must advance at the same pace.
+ */
+class PipelineClock
+{
+public:
+  typedef time::steady_clock::TimePoint TimePoint;
+
+  virtual
+  ~PipelineClock() = default;
+
+  virtual TimePoint
+  now() const
+  {
+    return time::steady_clock::now();
+  }
+
+  /**
+   * @return the clock used by the pipelines unless another one is set
+   */
+  static PipelineClock&
+  getDefault()
+  {
+    static PipelineClock clock;
+    return clock;
+  }
+};
+
+} // namespace chunks
+} // namespace ndn
+
+#endif // NDN_TOOLS_CHUNKS_CATCHUNKS_PIPELINE_CLOCK_HPP
@@ -34,10 +34,11 @@ namespace aimd {
 PipelineInterestsAimd::PipelineInterestsAimd(Face& face, RttEstimator& rttEstimator,
 		RateEstimator& rateEstimator, const Options& options)
 		: PipelineInterests(face), m_options(options), m_rttEstimator(rttEstimator), m_rateEstimator(
-				rateEstimator), m_scheduler(m_face.getIoService()), m_nextSegmentNo(0), m_receivedSize(0), m_highData(
+				rateEstimator), m_scheduler(m_face.getIoService()), m_mirrors(rttEstimator), m_nextSegmentNo(0), m_receivedSize(0), m_highData(
 				0), m_highInterest(0), m_recPoint(0), m_nInFlight(0), m_nReceived(0), m_nLossEvents(0), m_nRetransmitted(
 				0), m_cwnd(m_options.initCwnd), m_ssthresh(m_options.initSsthresh), m_hasFailure(false), m_failedSegNo(
-				0), m_nPackets(0), m_nBits(0)
+				0), m_nPackets(0), m_nBits(0),
+				m_maxSegmentInfoSize(0), m_maxRetxCountSize(0), m_maxRetxQueueSize(0)
 {
 	if (m_options.isVerbose) {
 		std::cerr << m_options;
@@ -52,10 +53,20 @@ PipelineInterestsAimd::~PipelineInterestsAimd()
 void PipelineInterestsAimd::doRun()
 {
 	// record the start time of running pipeline
-	m_startTime = time::steady_clock::now();
+	m_startTime = getCurrentTime();
+	m_eventTime = m_startTime;
+	m_eventAge = 0;
 
-	// count the excluded segment
-	m_nReceived++;
+	// count the excluded segment, unless it is outside the requested range
+	if (isInRange(m_excludedSegmentNo) && (!m_hasFinalBlockId || m_excludedSegmentNo <= m_lastSegmentNo))
+		m_nReceived++;
+	m_nextSegmentNo = m_firstSegmentNo;
+
+	// in follow mode, the segment found by the version discovery is the newest one known
+	if (m_options.isFollowing)
+		m_highData = std::max(m_excludedSegmentNo, m_firstSegmentNo);
+
+	m_mirrors.start(m_prefix, m_options);
 
 	// schedule the event to check retransmission timer
 	m_scheduler.scheduleEvent(m_options.rtoCheckInterval, [this] {checkRto();});
@@ -77,15 +88,59 @@ void PipelineInterestsAimd::doCancel()
 	m_scheduler.cancelAllEvents();
 }
 
+void PipelineInterestsAimd::doReleaseBackpressure()
+{
+	stampEvent();
+	schedulePackets();
+}
+
+PipelineStatus PipelineInterestsAimd::getStatus() const
+{
+	PipelineStatus status;
+	status.cwnd = m_cwnd;
+	status.nInFlight = m_nInFlight;
+	status.sRtt = m_rttEstimator.getSmoothedRtt().count();
+	status.rto = m_rttEstimator.getEstimatedRto().count();
+	status.nRetransmitted = m_nRetransmitted;
+	status.nReceived = m_nReceived;
+	status.nReceivedBytes = m_receivedSize;
+	status.maxSegmentInfoSize = m_maxSegmentInfoSize;
+	status.maxRetxQueueSize = m_maxRetxQueueSize;
+	return status;
+}
+
+void PipelineInterestsAimd::setMirrors(const std::vector<Name>& mirrors)
+{
+	m_mirrors.setMirrors(mirrors);
+}
+
+void PipelineInterestsAimd::setCoupledSubflows(const std::vector<const PipelineInterestsAimd*>& subflows)
+{
+	m_coupledSubflows = subflows;
+}
+
+
+void PipelineInterestsAimd::stampEvent()
+{
+	m_eventTime = getCurrentTime();
+	m_eventAge = time::duration_cast<time::duration<double>>(m_eventTime - m_startTime).count();
+}
+
+void PipelineInterestsAimd::updateHighWaterMarks()
+{
+	m_maxSegmentInfoSize = std::max(m_maxSegmentInfoSize, m_segmentInfo.size());
+	m_maxRetxCountSize = std::max(m_maxRetxCountSize, m_retxCount.size());
+	m_maxRetxQueueSize = std::max(m_maxRetxQueueSize, m_retxQueue.size());
+}
+
 void PipelineInterestsAimd::checkRate()
 {
 	if (isStopping())
 		return;
 
-	time::steady_clock::duration cur = time::steady_clock::now() - m_startTime;
-	double now = (double) cur.count() / 1000000000;
+	stampEvent();
 
-	m_rateEstimator.addMeasurement(now, m_nPackets, m_nBits);
+	m_rateEstimator.addMeasurement(m_eventAge, m_nPackets, m_nBits);
 
 	m_nPackets = 0;
 	m_nBits = 0;
@@ -99,18 +154,23 @@ void PipelineInterestsAimd::checkRto()
 	if (isStopping())
 		return;
 
+	stampEvent();
+
 	int timeoutCount = 0;
 
 	for (auto& entry : m_segmentInfo) {
 		SegmentInfo& segInfo = entry.second;
 		if (segInfo.state != SegmentState::InRetxQueue && // do not check segments currently in the retx queue
-				segInfo.state != SegmentState::RetxReceived) { // or already-received retransmitted segments
-			Milliseconds timeElapsed = time::steady_clock::now() - segInfo.timeSent;
+				segInfo.state != SegmentState::RetxReceived && // or already-received retransmitted segments
+				!isBeyondNewestSegment(entry.first)) { // or segments that may not be produced yet
+			Milliseconds timeElapsed = m_eventTime - segInfo.timeSent;
 			if (timeElapsed.count() > segInfo.rto.count()) { // timer expired?
 				uint64_t timedoutSeg = entry.first;
 				m_retxQueue.push(timedoutSeg); // put on retx queue
+				updateHighWaterMarks();
 				segInfo.state = SegmentState::InRetxQueue; // update status
 				timeoutCount++;
+				m_mirrors.onTimeout(segInfo.mirrorNo, segInfo.timeSent, m_eventTime);
 			}
 		}
 	}
@@ -128,7 +188,7 @@ void PipelineInterestsAimd::sendInterest(uint64_t segNo, bool isRetransmission)
 	if (isStopping())
 		return;
 
-	if (m_hasFinalBlockId && segNo > m_lastSegmentNo && !isRetransmission)
+	if (isLastSegmentKnown() && segNo > m_lastSegmentNo && !isRetransmission)
 		return;
 
 	if (!isRetransmission && m_hasFailure)
@@ -161,10 +221,10 @@ void PipelineInterestsAimd::sendInterest(uint64_t segNo, bool isRetransmission)
 		m_face.removePendingInterest(m_segmentInfo[segNo].interestId);
 	}
 
-	Interest interest(Name(m_prefix).appendSegment(segNo));
-	interest.setInterestLifetime(m_options.interestLifetime);
-	interest.setMustBeFresh(m_options.mustBeFresh);
-	interest.setMaxSuffixComponents(1);
+	// with mirrors, a segment is retransmitted on another mirror than the one that failed
+	size_t mirrorNo = m_mirrors.select(isRetransmission ? m_segmentInfo[segNo].mirrorNo : MirrorSet::NO_MIRROR);
+	Interest interest = m_mirrors.makeInterest(mirrorNo, segNo);
+	Milliseconds rto = m_mirrors.getRttEstimator(mirrorNo).getEstimatedRto();
 
 	auto interestId = m_face.expressInterest(interest,
 			bind(&PipelineInterestsAimd::handleData, this, _1, _2),
@@ -172,38 +232,78 @@ void PipelineInterestsAimd::sendInterest(uint64_t segNo, bool isRetransmission)
 			bind(&PipelineInterestsAimd::handleLifetimeExpiration, this, _1));
 
 	m_nInFlight++;
+	traceSegment(segNo, isRetransmission ? SegmentTracer::INTEREST_RETRANSMITTED : SegmentTracer::INTEREST_SENT,
+			m_eventTime);
+
+	DeliveryState deliveryState = m_rateEstimator.onInterestSent(m_eventAge);
 
 	if (isRetransmission) {
 		SegmentInfo& segInfo = m_segmentInfo[segNo];
 		segInfo.state = SegmentState::Retransmitted;
-		segInfo.rto = m_rttEstimator.getEstimatedRto();
-		segInfo.timeSent = time::steady_clock::now();
+		segInfo.rto = rto;
+		segInfo.mirrorNo = mirrorNo;
+		segInfo.timeSent = m_eventTime;
+		segInfo.deliveryState = deliveryState;
 		m_nRetransmitted++;
 	}
 	else {
 		m_highInterest = segNo;
-		Milliseconds rto = m_rttEstimator.getEstimatedRto();
-		SegmentInfo segInfo { interestId, SegmentState::FirstTimeSent, rto, time::steady_clock::now() };
+		SegmentInfo segInfo { interestId, SegmentState::FirstTimeSent, rto, m_eventTime,
+				deliveryState, mirrorNo };
 
 		m_segmentInfo.emplace(segNo, segInfo);
 	}
+
+	updateHighWaterMarks();
+}
+
+void PipelineInterestsAimd::refreshInterest(uint64_t segNo)
+{
+	if (m_options.isVerbose)
+		std::cerr << "Refreshing the Interest for segment #" << segNo << std::endl;
+
+	SegmentInfo& segInfo = m_segmentInfo[segNo];
+	Interest interest = m_mirrors.makeInterest(segInfo.mirrorNo, segNo);
+	segInfo.interestId = m_face.expressInterest(interest,
+			bind(&PipelineInterestsAimd::handleData, this, _1, _2),
+			bind(&PipelineInterestsAimd::handleNack, this, _1, _2),
+			bind(&PipelineInterestsAimd::handleLifetimeExpiration, this, _1));
+	segInfo.timeSent = m_eventTime;
 }
 
 void PipelineInterestsAimd::schedulePackets()
 {
 	int availableWindowSize = static_cast<int>(m_cwnd) - m_nInFlight;
+
+	if (hasBackpressure() && availableWindowSize > 0) {
+		// the consumer cannot write out its buffer before the missing segment arrives,
+		// so it is retransmitted ahead of the other segments in the retx queue
+		auto it = m_segmentInfo.find(getMissingSegmentNo());
+		if (it != m_segmentInfo.end() && it->second.state == SegmentState::InRetxQueue) {
+			sendInterest(it->first, true);
+			availableWindowSize--;
+		}
+	}
+
 	while (availableWindowSize > 0) {
 		if (!m_retxQueue.empty()) { // do retransmission first
 			uint64_t retxSegNo = m_retxQueue.front();
 			m_retxQueue.pop();
 
 			auto it = m_segmentInfo.find(retxSegNo);
-			if (it == m_segmentInfo.end()) {
+			if (it == m_segmentInfo.end() || it->second.state != SegmentState::InRetxQueue) {
 				continue;
 			}
-			// the segment is still in the map, it means that it needs to be retransmitted
+			// the segment is still waiting in the map, it means that it needs to be retransmitted
 			sendInterest(retxSegNo, true);
 		}
+		else if (hasBackpressure() && getMissingSegmentNo() < m_nextSegmentNo) {
+			break; // no new segment until the missing one arrives and the consumer catches up
+		}
+		else if (m_options.isFollowing && !m_hasFinalBlockId &&
+				m_nextSegmentNo > m_highData + m_options.followWindow) {
+			break; // only a few Interests wait for the segments not produced yet
+		}
 		else { // send next segment
 			sendInterest(getNextSegmentNo(), false);
 		}
@@ -216,15 +316,15 @@ void PipelineInterestsAimd::handleData(const Interest& interest, const Data& dat
 	if (isStopping())
 		return;
 
+	stampEvent();
+
 	m_nPackets += 1;
 	m_nBits += data.getContent().size() * 8;
 
 	// Data name will not have extra components because MaxSuffixComponents is set to 1
 	BOOST_ASSERT(data.getName().equals(interest.getName()));
 
-	if (!m_hasFinalBlockId && !data.getFinalBlockId().empty()) {
-		m_lastSegmentNo = data.getFinalBlockId().toSegment();
-		m_hasFinalBlockId = true;
+	if (receiveFinalBlockId(data)) {
 		cancelInFlightSegmentsGreaterThan(m_lastSegmentNo);
 		if (m_hasFailure && m_lastSegmentNo >= m_failedSegNo) {
 			// previously failed segment is part of the content
@@ -236,7 +336,8 @@ void PipelineInterestsAimd::handleData(const Interest& interest, const Data& dat
 	}
 
 	uint64_t recvSegNo = data.getName()[-1].toSegment();
-	if (m_highData < recvSegNo) {
+	bool isNewest = m_highData < recvSegNo;
+	if (isNewest) {
 		m_highData = recvSegNo;
 	}
 
@@ -246,7 +347,7 @@ void PipelineInterestsAimd::handleData(const Interest& interest, const Data& dat
 		return; // ignore already-received segment
 	}
 
-	Milliseconds rtt = time::steady_clock::now() - segInfo.timeSent;
+	Milliseconds rtt = m_eventTime - segInfo.timeSent;
 
 	if (m_options.isVerbose) {
 		std::cerr << "Received segment #" << recvSegNo << ", rtt=" << rtt.count() << "ms" << ", rto="
@@ -261,6 +362,10 @@ void PipelineInterestsAimd::handleData(const Interest& interest, const Data& dat
 
 	m_receivedSize += data.getContent().value_size();
 	m_nReceived++;
+	m_mirrors.onDataReceived(segInfo.mirrorNo);
+	traceSegment(recvSegNo, SegmentTracer::DATA_RECEIVED, m_eventTime);
+
+	m_rateEstimator.addDeliverySample(m_eventAge, segInfo.deliveryState, m_rttEstimator.getSmoothedRtt());
 
 	increaseWindow();
 	onData(interest, data);
@@ -268,9 +373,11 @@ void PipelineInterestsAimd::handleData(const Interest& interest, const Data& dat
 	if (segInfo.state == SegmentState::FirstTimeSent || segInfo.state == SegmentState::InRetxQueue) { // do not sample RTT for retransmitted segments
 		size_t nExpectedSamples = std::max(static_cast<int>(std::ceil(m_nInFlight / 2.0)), 1);
 
-		time::steady_clock::duration cur = time::steady_clock::now() - m_startTime;
-		double now = (double) cur.count() / 1000000000;
-		m_rttEstimator.addMeasurement(recvSegNo, now, rtt, nExpectedSamples);
+		// in follow mode, the newest segment may have waited at the producer until it was produced
+		if (!m_options.isFollowing || !isNewest) {
+			m_rttEstimator.addMeasurement(recvSegNo, m_eventAge, rtt, nExpectedSamples);
+			m_mirrors.addRttMeasurement(segInfo.mirrorNo, recvSegNo, m_eventAge, rtt, nExpectedSamples);
+		}
 		m_segmentInfo.erase(recvSegNo); // remove the entry associated with the received segment
 	}
 	else { // retransmission
@@ -278,7 +385,7 @@ void PipelineInterestsAimd::handleData(const Interest& interest, const Data& dat
 	}
 
 	BOOST_ASSERT(m_nReceived > 0);
-	if (m_hasFinalBlockId && m_nReceived - 1 >= m_lastSegmentNo) { // all segments have been received
+	if (isLastSegmentKnown() && m_nReceived >= getNSegmentsInRange()) { // all segments have been received
 		cancel();
 		if (m_options.isVerbose) {
 			printSummary();
@@ -294,6 +401,8 @@ void PipelineInterestsAimd::handleNack(const Interest& interest, const lp::Nack&
 	if (isStopping())
 		return;
 
+	stampEvent();
+
 	if (m_options.isVerbose)
 		std::cerr << "Received Nack with reason " << nack.getReason() << " for Interest " << interest
 				<< std::endl;
@@ -306,11 +415,24 @@ void PipelineInterestsAimd::handleNack(const Interest& interest, const lp::Nack&
 	}
 	case lp::NackReason::CONGESTION: { // treated the same as timeout for now
 		m_retxQueue.push(segNo); // put on retx queue
+		updateHighWaterMarks();
 		m_segmentInfo[segNo].state = SegmentState::InRetxQueue; // update state
+		m_mirrors.onTimeout(m_segmentInfo[segNo].mirrorNo, m_segmentInfo[segNo].timeSent, m_eventTime);
 		handleTimeout(1);
 		break;
 	}
 	default: {
+		if (m_mirrors.canRetryElsewhere()) {
+			// another mirror may still serve the segment: retry it there, it is not a congestion
+			m_mirrors.onLoss(m_segmentInfo[segNo].mirrorNo);
+			m_retxQueue.push(segNo);
+			updateHighWaterMarks();
+			m_segmentInfo[segNo].state = SegmentState::InRetxQueue;
+			if (m_nInFlight > 0)
+				m_nInFlight--;
+			schedulePackets();
+			break;
+		}
 		handleFail(segNo,
 				"Could not retrieve data for " + interest.getName().toUri() + ", reason: "
 						+ boost::lexical_cast<std::string>(nack.getReason()));
@@ -324,9 +446,16 @@ void PipelineInterestsAimd::handleLifetimeExpiration(const Interest& interest)
 	if (isStopping())
 		return;
 
+	stampEvent();
+
 	uint64_t segNo = interest.getName()[-1].toSegment();
+	if (isBeyondNewestSegment(segNo))
+		return refreshInterest(segNo);
+
 	m_retxQueue.push(segNo); // put on retx queue
+	updateHighWaterMarks();
 	m_segmentInfo[segNo].state = SegmentState::InRetxQueue; // update state
+	m_mirrors.onTimeout(m_segmentInfo[segNo].mirrorNo, m_segmentInfo[segNo].timeSent, m_eventTime);
 	handleTimeout(1);
 }
 
@@ -340,7 +469,9 @@ void PipelineInterestsAimd::handleTimeout(int timeoutCount)
 		m_recPoint = m_highInterest;
 
 		decreaseWindow();
-		m_rttEstimator.backoffRto();
+		// with mirrors, the RTO of each mirror is backed off by its own timeouts instead
+		if (!m_mirrors.hasMirrors())
+			m_rttEstimator.backoffRto();
 		m_nLossEvents++;
 
 		if (m_options.isVerbose) {
@@ -388,10 +519,34 @@ void PipelineInterestsAimd::increaseWindow()
 	if (m_cwnd < m_ssthresh) {
 		m_cwnd += m_options.aiStep; // additive increase
 	}
-	else {
+	else if (m_coupledSubflows.empty()) {
 		m_cwnd += m_options.aiStep / std::floor(m_cwnd); // congestion avoidance
 	}
-	afterCwndChange(time::steady_clock::now() - m_startTime, m_cwnd);
+	else {
+		m_cwnd += m_options.aiStep * getCoupledIncrease(); // coupled congestion avoidance
+	}
+	afterCwndChange(m_eventTime - m_startTime, m_cwnd);
+}
+
+double PipelineInterestsAimd::getCoupledIncrease() const
+{
+	// alpha = cwnd_total * max(cwnd_i / rtt_i^2) / (sum(cwnd_i / rtt_i))^2
+	double totalCwnd = 0.0;
+	double maxRatio = 0.0;
+	double sumRatio = 0.0;
+	for (const PipelineInterestsAimd* subflow : m_coupledSubflows) {
+		double rtt = subflow->m_rttEstimator.getSmoothedRtt().count();
+		if (std::isnan(rtt)) // no RTT sample yet
+			rtt = subflow->m_rttEstimator.getEstimatedRto().count();
+		rtt = std::max(rtt, 1.0);
+
+		totalCwnd += subflow->m_cwnd;
+		maxRatio = std::max(maxRatio, subflow->m_cwnd / (rtt * rtt));
+		sumRatio += subflow->m_cwnd / rtt;
+	}
+	double alpha = totalCwnd * maxRatio / (sumRatio * sumRatio);
+
+	return std::min(alpha / totalCwnd, 1.0 / std::floor(m_cwnd));
 }
 
 void PipelineInterestsAimd::decreaseWindow()
@@ -399,15 +554,18 @@ void PipelineInterestsAimd::decreaseWindow()
 	// please refer to RFC 5681, Section 3.1 for the rationale behind it
 	m_ssthresh = std::max(2.0, m_cwnd * m_options.mdCoef); // multiplicative decrease
 	m_cwnd = m_options.resetCwndToInit ? m_options.initCwnd : m_ssthresh;
-	afterCwndChange(time::steady_clock::now() - m_startTime, m_cwnd);
+	afterCwndChange(m_eventTime - m_startTime, m_cwnd);
 }
 
 uint64_t PipelineInterestsAimd::getNextSegmentNo()
 {
 	// get around the excluded segment
 	if (m_nextSegmentNo == m_excludedSegmentNo)
-		m_nextSegmentNo++;
-	return m_nextSegmentNo++;
+		m_nextSegmentNo += m_segmentStride;
+
+	uint64_t segNo = m_nextSegmentNo;
+	m_nextSegmentNo += m_segmentStride;
+	return segNo;
 }
 
 void PipelineInterestsAimd::cancelInFlightSegmentsGreaterThan(uint64_t segmentNo)
@@ -428,7 +586,7 @@ void PipelineInterestsAimd::cancelInFlightSegmentsGreaterThan(uint64_t segmentNo
 
 void PipelineInterestsAimd::printSummary() const
 {
-	Milliseconds timePassed = time::steady_clock::now() - m_startTime;
+	Milliseconds timePassed = m_eventTime - m_startTime;
 	double throughput = (8 * m_receivedSize * 1000) / timePassed.count();
 
 	int pow = 0;
@@ -460,7 +618,13 @@ void PipelineInterestsAimd::printSummary() const
 			<< "Total # of packet loss burst: " << m_nLossEvents << "\n" << "Packet loss rate: "
 			<< static_cast<double>(m_nLossEvents) / static_cast<double>(m_nReceived) << "\n"
 			<< "Total # of retransmitted segments: " << m_nRetransmitted << "\n" << "Goodput: "
-			<< throughput << " " << throughputUnit << "\n";
+			<< throughput << " " << throughputUnit << "\n" << "RTT min/p50/p90/p99: "
+			<< m_rttEstimator.getMinRtt().count() << "/" << m_rttEstimator.getRttP50().count() << "/"
+			<< m_rttEstimator.getRttP90().count() << "/" << m_rttEstimator.getRttP99().count() << " ms\n"
+			<< "Peak segment state entries: " << m_maxSegmentInfoSize << " (retx counters: "
+			<< m_maxRetxCountSize << "), peak retx queue depth: " << m_maxRetxQueueSize << "\n";
+
+	m_mirrors.printSummary(std::cerr);
 }
 
 std::ostream&
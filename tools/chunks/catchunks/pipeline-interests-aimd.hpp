@@ -29,6 +29,7 @@
 #include "options.hpp"
 #include "aimd-rtt-estimator.hpp"
 #include "aimd-rate-estimator.hpp"
+#include "mirror-set.hpp"
 #include "pipeline-interests.hpp"
 
 #include <queue>
@@ -47,7 +48,8 @@ struct PipelineInterestsAimdOptions : public Options
   time::milliseconds rtoCheckInterval = time::milliseconds(10); ///<  time interval for checking retransmission timer
   bool disableCwa = false; ///< disable Conservative Window Adaptation
   bool resetCwndToInit = false; ///< reduce cwnd to initCwnd when loss event occurs
-  double rateInterval = 0.1; 
+  double rateInterval = 0.1;
+  size_t followWindow = 8; ///< segments requested beyond the newest received one when following
 };
 
 /**
@@ -74,6 +76,8 @@ struct SegmentInfo
   SegmentState state;
   Milliseconds rto;
   time::steady_clock::TimePoint timeSent;
+  DeliveryState deliveryState; ///< delivery progress when the Interest was last sent
+  size_t mirrorNo; ///< mirror the Interest was last sent to, 0 without mirrors
 };
 
 /**
@@ -114,6 +118,40 @@ public:
    */
   signal::Signal<PipelineInterestsAimd, Milliseconds, double> afterCwndChange;
 
+  /**
+   * @return number of loss events, i.e. of reactions to a loss, since the pipeline started
+   */
+  uint64_t
+  getNLossEvents() const
+  {
+    return m_nLossEvents;
+  }
+
+  PipelineStatus
+  getStatus() const final;
+
+  /**
+   * @brief distribute the Interests among the retrieved versioned prefix and @p mirrors
+   *
+   * The mirrors are versioned prefixes serving the same segments as the retrieved one.
+   *
+   * @pre the pipeline is not running
+   */
+  void
+  setMirrors(const std::vector<Name>& mirrors);
+
+  /**
+   * @brief couple the window increase of this pipeline with the one of @p subflows
+   *
+   * The pipelines fetch stripes of the same content in parallel. In congestion avoidance,
+   * their windows grow with the Linked Increases Algorithm of RFC 6356, so that together
+   * they are no more aggressive than a single pipeline on the best of their paths.
+   *
+   * @param subflows all the coupled pipelines, including this one; they must outlive it
+   */
+  void
+  setCoupledSubflows(const std::vector<const PipelineInterestsAimd*>& subflows);
+
 private:
   /**
    * @brief fetch all the segments between 0 and lastSegment of the specified prefix
@@ -131,6 +169,26 @@ private:
   virtual void
   doCancel() final;
 
+  /**
+   * @brief fill the window again with new segments
+   */
+  void
+  doReleaseBackpressure() final;
+
+  /**
+   * @brief read the clock once for the event being processed
+   *
+   * Sets m_eventTime and m_eventAge, which every computation of the event then uses.
+   */
+  void
+  stampEvent();
+
+  /**
+   * @brief update the high-water marks of the per-segment containers
+   */
+  void
+  updateHighWaterMarks();
+
   /**
    * @brief check RTO for all sent-but-not-acked segments.
    */
@@ -147,6 +205,23 @@ private:
   void
   sendInterest(uint64_t segNo, bool isRetransmission);
 
+  /**
+   * @brief express again the expired Interest for a segment that may not be produced yet
+   *
+   * This is neither a loss nor a retransmission: the window and the retry count are unchanged.
+   */
+  void
+  refreshInterest(uint64_t segNo);
+
+  /**
+   * @return whether, in follow mode, segment @p segNo may not have been produced yet
+   */
+  bool
+  isBeyondNewestSegment(uint64_t segNo) const
+  {
+    return m_options.isFollowing && !m_hasFinalBlockId && segNo > m_highData;
+  }
+
   void
   schedulePackets();
 
@@ -171,6 +246,13 @@ private:
   void
   increaseWindow();
 
+  /**
+   * @return window increase per received segment in congestion avoidance, as a fraction of
+   *         aiStep, when the pipeline is coupled with other sub-flows (RFC 6356, Section 3)
+   */
+  double
+  getCoupledIncrease() const;
+
   /**
    * @brief decrease congestion window size based on AIMD scheme
    */
@@ -178,7 +260,7 @@ private:
   decreaseWindow();
 
   /** \return next segment number to retrieve
-   *  \post m_nextSegmentNo == return-value + 1
+   *  \post m_nextSegmentNo == return-value + m_segmentStride
    */
   uint64_t
   getNextSegmentNo();
@@ -194,6 +276,8 @@ PUBLIC_WITH_TESTS_ELSE_PRIVATE:
   RttEstimator& m_rttEstimator;
   RateEstimator& m_rateEstimator;
   Scheduler m_scheduler;
+  MirrorRouter m_mirrors;
+  std::vector<const PipelineInterestsAimd*> m_coupledSubflows; ///< empty unless coupled
   uint64_t m_nextSegmentNo;
   size_t m_receivedSize;
 
@@ -208,6 +292,8 @@ PUBLIC_WITH_TESTS_ELSE_PRIVATE:
   uint64_t m_nRetransmitted; ///< # of segments retransmitted
 
   time::steady_clock::TimePoint m_startTime; ///<  start time of pipelining
+  time::steady_clock::TimePoint m_eventTime; ///< time of the event being processed
+  double m_eventAge; ///< time from m_startTime to m_eventTime (unit: second)
 
   double m_cwnd; ///< current congestion window size (in segments)
   double m_ssthresh; ///< current slow start threshold
@@ -227,6 +313,10 @@ PUBLIC_WITH_TESTS_ELSE_PRIVATE:
   //for Rate measurement
   uint64_t m_nPackets;
   uint64_t m_nBits;
+
+  size_t m_maxSegmentInfoSize; ///< high-water mark of m_segmentInfo
+  size_t m_maxRetxCountSize; ///< high-water mark of m_retxCount
+  size_t m_maxRetxQueueSize; ///< high-water mark of m_retxQueue
 };
 
 std::ostream&
@@ -35,10 +35,16 @@ namespace chunks {
 PipelineInterestsFixedWindow::PipelineInterestsFixedWindow(Face& face, const Options& options)
   : PipelineInterests(face)
   , m_options(options)
+  , m_scheduler(m_face.getIoService())
   , m_nextSegmentNo(0)
+  , m_highData(0)
+  , m_nReceived(0)
+  , m_nReceivedBytes(0)
+  , m_nRetransmitted(0)
   , m_hasFailure(false)
 {
   m_segmentFetchers.resize(m_options.maxPipelineSize);
+  m_nRefreshes.resize(m_options.maxPipelineSize);
 }
 
 PipelineInterestsFixedWindow::~PipelineInterestsFixedWindow()
@@ -46,9 +52,34 @@ PipelineInterestsFixedWindow::~PipelineInterestsFixedWindow()
   cancel();
 }
 
+PipelineStatus
+PipelineInterestsFixedWindow::getStatus() const
+{
+  PipelineStatus status = PipelineInterests::getStatus();
+  status.cwnd = m_options.maxPipelineSize;
+  status.nRetransmitted = m_nRetransmitted;
+  status.nReceived = m_nReceived;
+  status.nReceivedBytes = m_nReceivedBytes;
+  status.maxSegmentInfoSize = m_segmentFetchers.size();
+
+  for (size_t pipeNo = 0; pipeNo < m_segmentFetchers.size(); ++pipeNo) {
+    const auto& fetcher = m_segmentFetchers[pipeNo];
+    if (fetcher.first != nullptr && fetcher.first->isRunning()) {
+      ++status.nInFlight;
+      status.nRetransmitted += getNRetransmissions(pipeNo);
+    }
+  }
+  return status;
+}
+
 void
 PipelineInterestsFixedWindow::doRun()
 {
+  m_interestTemplate = make_unique<InterestTemplate>(m_prefix, m_options);
+  m_nextSegmentNo = m_firstSegmentNo;
+  if (m_options.isFollowing)
+    m_highData = std::max(m_excludedSegmentNo, m_firstSegmentNo);
+
   // if the FinalBlockId is unknown, this could potentially request non-existent segments
   for (size_t nRequestedSegments = 0;
        nRequestedSegments < m_options.maxPipelineSize;
@@ -71,31 +102,43 @@ PipelineInterestsFixedWindow::fetchNextSegment(std::size_t pipeNo)
   }
 
   if (m_nextSegmentNo == m_excludedSegmentNo)
-    m_nextSegmentNo++;
+    m_nextSegmentNo += m_segmentStride;
 
-  if (m_hasFinalBlockId && m_nextSegmentNo > m_lastSegmentNo)
+  if (isLastSegmentKnown() && m_nextSegmentNo > m_lastSegmentNo)
    return false;
 
+  // no new segment until the missing one arrives and the consumer catches up
+  if (hasBackpressure() && getMissingSegmentNo() < m_nextSegmentNo) {
+    m_idlePipes.push_back(pipeNo);
+    return false;
+  }
+
   // send interest for next segment
   if (m_options.isVerbose)
     std::cerr << "Requesting segment #" << m_nextSegmentNo << std::endl;
 
-  Interest interest(Name(m_prefix).appendSegment(m_nextSegmentNo));
-  interest.setInterestLifetime(m_options.interestLifetime);
-  interest.setMustBeFresh(m_options.mustBeFresh);
-  interest.setMaxSuffixComponents(1);
+  Interest interest = m_interestTemplate->makeInterest(m_nextSegmentNo);
 
-  auto fetcher = DataFetcher::fetch(m_face, interest,
-                                    m_options.maxRetriesOnTimeoutOrNack,
-                                    m_options.maxRetriesOnTimeoutOrNack,
-                                    bind(&PipelineInterestsFixedWindow::handleData, this, _1, _2, pipeNo),
-                                    bind(&PipelineInterestsFixedWindow::handleFail, this, _2, pipeNo),
-                                    bind(&PipelineInterestsFixedWindow::handleFail, this, _2, pipeNo),
-                                    m_options.isVerbose);
+  auto& fetcher = m_segmentFetchers[pipeNo];
+  if (fetcher.first == nullptr) {
+    fetcher.first = DataFetcher::create(m_face, m_scheduler,
+                                        m_options.maxRetriesOnTimeoutOrNack,
+                                        m_options.maxRetriesOnTimeoutOrNack,
+                                        bind(&PipelineInterestsFixedWindow::handleData, this, _1, _2, pipeNo),
+                                        bind(&PipelineInterestsFixedWindow::handleFail, this, _2, pipeNo),
+                                        bind(&PipelineInterestsFixedWindow::handleFail, this, _2, pipeNo),
+                                        m_options.isVerbose);
+    fetcher.first->setRetryCallback(bind(&PipelineInterestsFixedWindow::handleRetry, this, pipeNo));
+  }
 
-  BOOST_ASSERT(!m_segmentFetchers[pipeNo].first || !m_segmentFetchers[pipeNo].first->isRunning());
-  m_segmentFetchers[pipeNo] = make_pair(fetcher, m_nextSegmentNo);
-  m_nextSegmentNo++;
+  BOOST_ASSERT(!fetcher.first->isRunning());
+  fetcher.second = m_nextSegmentNo;
+  m_nRefreshes[pipeNo] = 0;
+  if (m_options.isFollowing)
+    fetcher.first->setMaxTimeoutRetries(getMaxTimeoutRetries(pipeNo));
+  fetcher.first->restart(interest);
+  traceSegment(m_nextSegmentNo, SegmentTracer::INTEREST_SENT);
+  m_nextSegmentNo += m_segmentStride;
 
   return true;
 }
@@ -103,12 +146,23 @@ PipelineInterestsFixedWindow::fetchNextSegment(std::size_t pipeNo)
 void
 PipelineInterestsFixedWindow::doCancel()
 {
+  // the fetchers are kept until the pipeline is destroyed, because doCancel can be
+  // invoked from within the callback of one of them
   for (auto& fetcher : m_segmentFetchers) {
     if (fetcher.first)
       fetcher.first->cancel();
   }
 
-  m_segmentFetchers.clear();
+  m_scheduler.cancelAllEvents();
+}
+
+void
+PipelineInterestsFixedWindow::doReleaseBackpressure()
+{
+  std::vector<size_t> idlePipes;
+  idlePipes.swap(m_idlePipes);
+  for (size_t pipeNo : idlePipes)
+    fetchNextSegment(pipeNo);
 }
 
 void
@@ -122,11 +176,21 @@ PipelineInterestsFixedWindow::handleData(const Interest& interest, const Data& d
   if (m_options.isVerbose)
     std::cerr << "Received segment #" << data.getName()[-1].toSegment() << std::endl;
 
+  uint64_t recvSegNo = data.getName()[-1].toSegment();
+  ++m_nReceived;
+  m_nReceivedBytes += data.getContent().value_size();
+  traceSegment(recvSegNo, SegmentTracer::DATA_RECEIVED);
+  m_nRetransmitted += getNRetransmissions(pipeNo);
+
+  if (isBeyondNewestSegment(recvSegNo))
+    advanceNewestSegment(recvSegNo);
+
   onData(interest, data);
 
-  if (!m_hasFinalBlockId && !data.getFinalBlockId().empty()) {
-    m_lastSegmentNo = data.getFinalBlockId().toSegment();
-    m_hasFinalBlockId = true;
+  if (receiveFinalBlockId(data)) {
+    // in follow mode, the segments up to the last one have been produced
+    if (m_options.isFollowing && m_lastSegmentNo > m_highData)
+      advanceNewestSegment(m_lastSegmentNo);
 
     for (auto& fetcher : m_segmentFetchers) {
       if (fetcher.first == nullptr)
@@ -146,6 +210,15 @@ PipelineInterestsFixedWindow::handleData(const Interest& interest, const Data& d
   fetchNextSegment(pipeNo);
 }
 
+void
+PipelineInterestsFixedWindow::handleRetry(size_t pipeNo)
+{
+  // in follow mode, an Interest expressed again for a segment not produced yet is a refresh
+  uint64_t segNo = m_segmentFetchers[pipeNo].second;
+  if (!isBeyondNewestSegment(segNo))
+    traceSegment(segNo, SegmentTracer::INTEREST_RETRANSMITTED);
+}
+
 void PipelineInterestsFixedWindow::handleFail(const std::string& reason, std::size_t pipeNo)
 {
   if (isStopping())
@@ -179,5 +252,40 @@ void PipelineInterestsFixedWindow::handleFail(const std::string& reason, std::si
   }
 }
 
+void
+PipelineInterestsFixedWindow::advanceNewestSegment(uint64_t segNo)
+{
+  for (size_t pipeNo = 0; pipeNo < m_segmentFetchers.size(); ++pipeNo) {
+    const auto& fetcher = m_segmentFetchers[pipeNo];
+    if (fetcher.first != nullptr && fetcher.first->isRunning() &&
+        fetcher.second > m_highData && fetcher.second <= segNo) {
+      m_nRefreshes[pipeNo] = fetcher.first->getNTimeouts();
+      // from now on, the expirations count against the retry limit
+      fetcher.first->setMaxTimeoutRetries(m_options.maxRetriesOnTimeoutOrNack + m_nRefreshes[pipeNo]);
+    }
+  }
+  m_highData = segNo;
+}
+
+int
+PipelineInterestsFixedWindow::getMaxTimeoutRetries(size_t pipeNo) const
+{
+  // an Interest for a segment not produced yet is expressed again on expiry without limit
+  if (isBeyondNewestSegment(m_segmentFetchers[pipeNo].second))
+    return DataFetcher::MAX_RETRIES_INFINITE;
+
+  return m_options.maxRetriesOnTimeoutOrNack + m_nRefreshes[pipeNo];
+}
+
+int
+PipelineInterestsFixedWindow::getNRetransmissions(size_t pipeNo) const
+{
+  const auto& fetcher = m_segmentFetchers[pipeNo];
+  if (isBeyondNewestSegment(fetcher.second))
+    return fetcher.first->getNRetries() - fetcher.first->getNTimeouts();
+
+  return fetcher.first->getNRetries() - m_nRefreshes[pipeNo];
+}
+
 } // namespace chunks
 } // namespace ndn
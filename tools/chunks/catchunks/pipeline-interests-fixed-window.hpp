@@ -27,6 +27,7 @@
  */
 
 #include "options.hpp"
+#include "interest-template.hpp"
 #include "pipeline-interests.hpp"
 
 namespace ndn {
@@ -75,6 +76,12 @@ public:
 
   ~PipelineInterestsFixedWindow() final;
 
+  /**
+   * @note the window is the pipeline size and there is no RTT estimate
+   */
+  PipelineStatus
+  getStatus() const final;
+
 private:
   /**
    * @brief fetch all the segments between 0 and m_lastSegmentNo
@@ -89,6 +96,14 @@ private:
   void
   doCancel() final;
 
+  /**
+   * @brief restart the fetchers that were left idle while the backpressure was applied
+   *
+   * Each fetcher retransmits its own segment, so there is nothing to prioritize here.
+   */
+  void
+  doReleaseBackpressure() final;
+
   /**
    * @brief fetch the next segment that has not been requested yet
    *
@@ -103,10 +118,65 @@ private:
   void
   handleFail(const std::string& reason, size_t pipeNo);
 
+  /**
+   * @brief trace the retransmission of the segment fetched by pipeline slot @p pipeNo
+   */
+  void
+  handleRetry(size_t pipeNo);
+
+  /**
+   * @return whether, in follow mode, segment @p segNo may not have been produced yet
+   */
+  bool
+  isBeyondNewestSegment(uint64_t segNo) const
+  {
+    return m_options.isFollowing && !m_hasFinalBlockId && segNo > m_highData;
+  }
+
+  /**
+   * @brief mark segments up to @p segNo as produced
+   *
+   * The expirations counted so far by the fetchers of the segments that become produced were
+   * refreshes of Interests sent too early, and are set aside in m_nRefreshes. The following
+   * expirations count against the retry limit of those fetchers.
+   */
+  void
+  advanceNewestSegment(uint64_t segNo);
+
+  /**
+   * @return the timeout retry limit of the fetcher in pipeline slot @p pipeNo, which applies
+   *         to its retransmissions only, not to the refreshes
+   */
+  int
+  getMaxTimeoutRetries(size_t pipeNo) const;
+
+  /**
+   * @return the retransmissions of the segment fetched by pipeline slot @p pipeNo,
+   *         excluding the refreshes of an Interest for a segment not produced yet
+   */
+  int
+  getNRetransmissions(size_t pipeNo) const;
+
 private:
   const Options m_options;
+  Scheduler m_scheduler; ///< shared by all the segment fetchers of this pipeline
+  unique_ptr<InterestTemplate> m_interestTemplate;
+
+PUBLIC_WITH_TESTS_ELSE_PRIVATE:
+  /**
+   * one reusable fetcher per pipeline slot, paired with the segment number it is fetching;
+   * each fetcher is created on first use and restarted for every following segment
+   */
   std::vector<std::pair<shared_ptr<DataFetcher>, uint64_t>> m_segmentFetchers;
+
+private:
+  std::vector<size_t> m_idlePipes; ///< pipeline slots left idle by the backpressure
+  std::vector<int> m_nRefreshes; ///< per pipeline slot, refreshes before its segment was produced
   uint64_t m_nextSegmentNo;
+  uint64_t m_highData; ///< in follow mode, the highest segment number received so far
+  uint64_t m_nReceived; ///< # of segments received
+  uint64_t m_nReceivedBytes; ///< payload bytes received
+  uint64_t m_nRetransmitted; ///< retransmissions of the segments already received
   /**
    * true if one or more segment fetchers encountered an error; if m_hasFinalBlockId
    * is false, this is usually not a fatal error for the pipeline
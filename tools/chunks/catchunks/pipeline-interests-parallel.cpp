@@ -0,0 +1,146 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "pipeline-interests-parallel.hpp"
+
+#include <cmath>
+
+namespace ndn {
+namespace chunks {
+
+PipelineInterestsParallel::PipelineInterestsParallel(Face& face,
+                                                     std::vector<unique_ptr<PipelineInterests>> subflows)
+  : PipelineInterests(face)
+  , m_subflows(std::move(subflows))
+{
+  BOOST_ASSERT(!m_subflows.empty());
+}
+
+PipelineInterestsParallel::~PipelineInterestsParallel()
+{
+  cancel();
+}
+
+PipelineStatus
+PipelineInterestsParallel::getStatus() const
+{
+  PipelineStatus status;
+  for (const auto& subflow : m_subflows) {
+    PipelineStatus subStatus = subflow->getStatus();
+    status.cwnd += subStatus.cwnd;
+    status.nInFlight += subStatus.nInFlight;
+    // std::fmax ignores the NaN of a sub-flow without RTT estimate
+    status.sRtt = std::fmax(status.sRtt, subStatus.sRtt);
+    status.rto = std::fmax(status.rto, subStatus.rto);
+    status.nRetransmitted += subStatus.nRetransmitted;
+    status.nReceived += subStatus.nReceived;
+    status.nReceivedBytes += subStatus.nReceivedBytes;
+    status.maxSegmentInfoSize += subStatus.maxSegmentInfoSize;
+    status.maxRetxQueueSize += subStatus.maxRetxQueueSize;
+  }
+  return status;
+}
+
+void
+PipelineInterestsParallel::doRun()
+{
+  // the sub-flows start from the segment found by the version discovery
+  Data data(Name(m_prefix).appendSegment(m_excludedSegmentNo));
+  if (m_hasFinalBlockId)
+    data.setFinalBlockId(name::Component::fromSegment(m_lastSegmentNo));
+
+  auto runSubflow = [this, &data] (PipelineInterests& subflow) {
+    subflow.setClock(getClock());
+    subflow.setTracer(getTracer());
+    subflow.run(data,
+                bind(&PipelineInterestsParallel::handleData, this, _1, _2),
+                bind(&PipelineInterestsParallel::handleFail, this, _1));
+  };
+
+  if (!isLastSegmentKnown()) {
+    // the segments cannot be striped before the last one is known
+    m_subflows.front()->setSegmentRange(m_firstSegmentNo, std::numeric_limits<uint64_t>::max());
+    runSubflow(*m_subflows.front());
+    return;
+  }
+
+  uint64_t stride = m_subflows.size();
+  for (uint64_t k = 0; k < stride; ++k) {
+    uint64_t first = m_firstSegmentNo + k;
+    if (first > m_lastSegmentNo)
+      break;
+
+    // a stripe holding only the segment already fetched by the version discovery is empty
+    uint64_t nSegments = (m_lastSegmentNo - first) / stride + 1;
+    bool hasExcluded = m_excludedSegmentNo >= first && m_excludedSegmentNo <= m_lastSegmentNo &&
+                       (m_excludedSegmentNo - first) % stride == 0;
+    if (nSegments == 1 && hasExcluded)
+      continue;
+
+    m_subflows[k]->setSegmentRange(first, m_lastSegmentNo);
+    m_subflows[k]->setSegmentStride(stride);
+    runSubflow(*m_subflows[k]);
+  }
+}
+
+void
+PipelineInterestsParallel::doCancel()
+{
+  for (auto& subflow : m_subflows) {
+    subflow->cancel();
+  }
+}
+
+void
+PipelineInterestsParallel::doApplyBackpressure()
+{
+  for (auto& subflow : m_subflows) {
+    subflow->applyBackpressure(getMissingSegmentNo());
+  }
+}
+
+void
+PipelineInterestsParallel::doReleaseBackpressure()
+{
+  for (auto& subflow : m_subflows) {
+    subflow->releaseBackpressure();
+  }
+}
+
+void
+PipelineInterestsParallel::handleData(const Interest& interest, const Data& data)
+{
+  if (isStopping())
+    return;
+
+  onData(interest, data);
+}
+
+void
+PipelineInterestsParallel::handleFail(const std::string& reason)
+{
+  onFailure(reason);
+}
+
+} // namespace chunks
+} // namespace ndn
@@ -0,0 +1,92 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#ifndef NDN_TOOLS_CHUNKS_CATCHUNKS_PIPELINE_INTERESTS_PARALLEL_HPP
+#define NDN_TOOLS_CHUNKS_CATCHUNKS_PIPELINE_INTERESTS_PARALLEL_HPP
+
+#include "pipeline-interests.hpp"
+
+namespace ndn {
+namespace chunks {
+
+/**
+ * @brief Service for retrieving Data via several Interest pipelines working in parallel
+ *
+ * The segments of the content are striped among the sub-flows: with N sub-flows, the k-th one
+ * fetches every N-th segment starting from the k-th segment of the range. Each sub-flow keeps
+ * its own window and RTT estimate, so that a single retrieval can fill a path whose
+ * bandwidth-delay product is larger than what one window grows to. The segments received by
+ * all the sub-flows are delivered to the same callback.
+ *
+ * The segments are striped only if the FinalBlockId is known when the pipeline starts,
+ * otherwise the first sub-flow fetches all the segments.
+ */
+class PipelineInterestsParallel : public PipelineInterests
+{
+public:
+  /**
+   * @brief create a PipelineInterestsParallel service
+   *
+   * @param subflows pipelines that are not running yet, at least one
+   */
+  PipelineInterestsParallel(Face& face, std::vector<unique_ptr<PipelineInterests>> subflows);
+
+  ~PipelineInterestsParallel() final;
+
+  /**
+   * @note windows, Interests in flight and counters are summed over the sub-flows, while
+   *       the RTT estimates are the largest ones among them
+   */
+  PipelineStatus
+  getStatus() const final;
+
+private:
+  /**
+   * @brief start the sub-flows, each one on its own stripe of segments
+   */
+  void
+  doRun() final;
+
+  void
+  doCancel() final;
+
+  void
+  doApplyBackpressure() final;
+
+  void
+  doReleaseBackpressure() final;
+
+  void
+  handleData(const Interest& interest, const Data& data);
+
+  void
+  handleFail(const std::string& reason);
+
+PUBLIC_WITH_TESTS_ELSE_PRIVATE:
+  std::vector<unique_ptr<PipelineInterests>> m_subflows;
+};
+
+} // namespace chunks
+} // namespace ndn
+
+#endif // NDN_TOOLS_CHUNKS_CATCHUNKS_PIPELINE_INTERESTS_PARALLEL_HPP
@@ -29,6 +29,7 @@
 #include "options.hpp"
 #include "aimd-rtt-estimator.hpp"
 #include "aimd-rate-estimator.hpp"
+#include "mirror-set.hpp"
 #include "pipeline-interests.hpp"
 
 #include <queue>
@@ -36,6 +37,9 @@
 using ndn::chunks::aimd::Milliseconds;
 using ndn::chunks::aimd::RttEstimator;
 using ndn::chunks::aimd::RateEstimator;
+using ndn::chunks::aimd::DeliveryState;
+using ndn::chunks::aimd::MirrorSet;
+using ndn::chunks::aimd::MirrorRouter;
 
 namespace ndn {
 namespace chunks {
@@ -52,6 +56,12 @@ struct PipelineInterestsTcpBicOptions : public Options
   bool disableCwa = false; ///< disable Conservative Window Adaptation
   bool resetCwndToInit = false; ///< reduce cwnd to initCwnd when loss event occurs
   double rateInterval = 0.1;
+  size_t followWindow = 8; ///< segments requested beyond the newest received one when following
+
+  /* BIC specific options */
+  int bicMaxIncrement = 16; ///< largest cwnd increase per RTT in the binary search (unit: segment)
+  int bicLowWindow = 14; ///< below this cwnd the window is adjusted as in standard TCP
+  double bicBeta = 0.8; ///< multiplicative decrease factor of BIC after a packet loss event
 };
 
 /**
@@ -78,6 +88,8 @@ struct SegmentInfo
   SegmentState state;
   Milliseconds rto;
   time::steady_clock::TimePoint timeSent;
+  DeliveryState deliveryState; ///< delivery progress when the Interest was last sent
+  size_t mirrorNo; ///< mirror the Interest was last sent to, 0 without mirrors
 };
 
 /**
@@ -95,9 +107,7 @@ class PipelineInterestsTcpBic : public PipelineInterests
 {
 public:
   typedef PipelineInterestsTcpBicOptions Options;
-  const int MAX_INCREMENT = 16;
   const int MAX_INT = std::numeric_limits<int>::max();
-  const int LOW_WINDOW = 14;
 
 
 public:
@@ -122,6 +132,28 @@ public:
    */
   signal::Signal<PipelineInterestsTcpBic, Milliseconds, double> afterCwndChange;
 
+  /**
+   * @return number of loss events, i.e. of reactions to a loss, since the pipeline started
+   */
+  uint64_t
+  getNLossEvents() const
+  {
+    return m_nLossEvents;
+  }
+
+  PipelineStatus
+  getStatus() const final;
+
+  /**
+   * @brief distribute the Interests among the retrieved versioned prefix and @p mirrors
+   *
+   * The mirrors are versioned prefixes serving the same segments as the retrieved one.
+   *
+   * @pre the pipeline is not running
+   */
+  void
+  setMirrors(const std::vector<Name>& mirrors);
+
 private:
   /**
    * @brief fetch all the segments between 0 and lastSegment of the specified prefix
@@ -139,6 +171,26 @@ private:
   virtual void
   doCancel() final;
 
+  /**
+   * @brief fill the window again with new segments
+   */
+  void
+  doReleaseBackpressure() final;
+
+  /**
+   * @brief read the clock once for the event being processed
+   *
+   * Sets m_eventTime and m_eventAge, which every computation of the event then uses.
+   */
+  void
+  stampEvent();
+
+  /**
+   * @brief update the high-water marks of the per-segment containers
+   */
+  void
+  updateHighWaterMarks();
+
   /**
    * @brief check RTO for all sent-but-not-acked segments.
    */
@@ -155,6 +207,23 @@ private:
   void
   sendInterest(uint64_t segNo, bool isRetransmission);
 
+  /**
+   * @brief express again the expired Interest for a segment that may not be produced yet
+   *
+   * This is neither a loss nor a retransmission: the window and the retry count are unchanged.
+   */
+  void
+  refreshInterest(uint64_t segNo);
+
+  /**
+   * @return whether, in follow mode, segment @p segNo may not have been produced yet
+   */
+  bool
+  isBeyondNewestSegment(uint64_t segNo) const
+  {
+    return m_options.isFollowing && !m_hasFinalBlockId && segNo > m_highData;
+  }
+
   void
   schedulePackets();
 
@@ -186,7 +255,7 @@ private:
   decreaseWindow();
 
   /** \return next segment number to retrieve
-   *  \post m_nextSegmentNo == return-value + 1
+   *  \post m_nextSegmentNo == return-value + m_segmentStride
    */
   uint64_t
   getNextSegmentNo();
@@ -202,6 +271,7 @@ PUBLIC_WITH_TESTS_ELSE_PRIVATE:
   RttEstimator& m_rttEstimator;
   RateEstimator& m_rateEstimator;
   Scheduler m_scheduler;
+  MirrorRouter m_mirrors;
   uint64_t m_nextSegmentNo;
   size_t m_receivedSize;
 
@@ -216,6 +286,8 @@ PUBLIC_WITH_TESTS_ELSE_PRIVATE:
   uint64_t m_nRetransmitted; ///< # of segments retransmitted
 
   time::steady_clock::TimePoint m_startTime; ///<  start time of pipelining
+  time::steady_clock::TimePoint m_eventTime; ///< time of the event being processed
+  double m_eventAge; ///< time from m_startTime to m_eventTime (unit: second)
 
   double m_cwnd; ///< current congestion window size (in segments)
   double m_ssthresh; ///< current slow start threshold
@@ -246,6 +318,10 @@ PUBLIC_WITH_TESTS_ELSE_PRIVATE:
   //for Rate measurement
   uint64_t m_nPackets;
   uint64_t m_nBits;
+
+  size_t m_maxSegmentInfoSize; ///< high-water mark of m_segmentInfo
+  size_t m_maxRetxCountSize; ///< high-water mark of m_retxCount
+  size_t m_maxRetxQueueSize; ///< high-water mark of m_retxQueue
 };
 
 std::ostream&
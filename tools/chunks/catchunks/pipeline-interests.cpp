@@ -29,15 +29,37 @@
 
 #include "pipeline-interests.hpp"
 
+#include <limits>
+
 namespace ndn {
 namespace chunks {
 
+PipelineStatus::PipelineStatus()
+  : cwnd(0)
+  , nInFlight(0)
+  , sRtt(std::numeric_limits<double>::quiet_NaN())
+  , rto(std::numeric_limits<double>::quiet_NaN())
+  , nRetransmitted(0)
+  , nReceived(0)
+  , nReceivedBytes(0)
+  , maxSegmentInfoSize(0)
+  , maxRetxQueueSize(0)
+{
+}
+
 PipelineInterests::PipelineInterests(Face& face)
   : m_face(face)
+  , m_firstSegmentNo(0)
   , m_lastSegmentNo(0)
   , m_excludedSegmentNo(0)
+  , m_segmentStride(1)
   , m_hasFinalBlockId(false)
+  , m_clock(&PipelineClock::getDefault())
+  , m_tracer(nullptr)
   , m_isStopping(false)
+  , m_hasBackpressure(false)
+  , m_missingSegmentNo(0)
+  , m_rangeLastSegmentNo(std::numeric_limits<uint64_t>::max())
 {
 }
 
@@ -52,14 +74,26 @@ PipelineInterests::run(const Data& data, DataCallback onData, FailureCallback on
   m_prefix = data.getName().getPrefix(-1);
   m_excludedSegmentNo = data.getName()[-1].toSegment();
 
-  if (!data.getFinalBlockId().empty()) {
-    m_lastSegmentNo = data.getFinalBlockId().toSegment();
-    m_hasFinalBlockId = true;
-  }
+  // the end of the range is not the end of the content, which a later segment may still reveal
+  m_lastSegmentNo = m_rangeLastSegmentNo;
+  receiveFinalBlockId(data);
 
   doRun();
 }
 
+bool
+PipelineInterests::receiveFinalBlockId(const Data& data)
+{
+  if (m_hasFinalBlockId || data.getFinalBlockId().empty())
+    return false;
+
+  uint64_t finalSegNo = data.getFinalBlockId().toSegment();
+  if (!isLastSegmentKnown() || finalSegNo < m_lastSegmentNo)
+    m_lastSegmentNo = finalSegNo;
+  m_hasFinalBlockId = true;
+  return true;
+}
+
 void
 PipelineInterests::cancel()
 {
@@ -70,6 +104,57 @@ PipelineInterests::cancel()
   doCancel();
 }
 
+void
+PipelineInterests::setSegmentRange(uint64_t first, uint64_t last)
+{
+  BOOST_ASSERT(first <= last);
+  m_firstSegmentNo = first;
+  m_rangeLastSegmentNo = last;
+}
+
+void
+PipelineInterests::setSegmentStride(uint64_t stride)
+{
+  BOOST_ASSERT(stride > 0);
+  m_segmentStride = stride;
+}
+
+void
+PipelineInterests::applyBackpressure(uint64_t missingSegNo)
+{
+  m_hasBackpressure = true;
+  m_missingSegmentNo = missingSegNo;
+  if (!m_isStopping)
+    doApplyBackpressure();
+}
+
+void
+PipelineInterests::releaseBackpressure()
+{
+  if (!m_hasBackpressure)
+    return;
+
+  m_hasBackpressure = false;
+  if (!m_isStopping)
+    doReleaseBackpressure();
+}
+
+void
+PipelineInterests::doApplyBackpressure()
+{
+}
+
+void
+PipelineInterests::doReleaseBackpressure()
+{
+}
+
+PipelineStatus
+PipelineInterests::getStatus() const
+{
+  return PipelineStatus();
+}
+
 void
 PipelineInterests::onFailure(const std::string& reason)
 {
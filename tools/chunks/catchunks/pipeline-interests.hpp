@@ -31,10 +31,35 @@
 #define NDN_TOOLS_CHUNKS_CATCHUNKS_PIPELINE_INTERESTS_HPP
 
 #include "core/common.hpp"
+#include "pipeline-clock.hpp"
+#include "segment-tracer.hpp"
+
+#include <limits>
 
 namespace ndn {
 namespace chunks {
 
+/**
+ * @brief Snapshot of the state of an Interest pipeline, used for monitoring
+ */
+struct PipelineStatus
+{
+  /**
+   * @brief create the status of a pipeline that has no window, RTT estimate or counters
+   */
+  PipelineStatus();
+
+  double cwnd; ///< congestion window, or window size of a fixed pipeline (unit: segment)
+  uint64_t nInFlight; ///< # of Interests waiting for Data
+  double sRtt; ///< smoothed RTT (unit: ms), NaN if the pipeline does not estimate it
+  double rto; ///< retransmission timeout (unit: ms), NaN if the pipeline does not estimate it
+  uint64_t nRetransmitted; ///< # of Interests retransmitted
+  uint64_t nReceived; ///< # of segments received
+  uint64_t nReceivedBytes; ///< payload bytes received
+  size_t maxSegmentInfoSize; ///< high-water mark of the per-segment state entries
+  size_t maxRetxQueueSize; ///< high-water mark of the retransmission queue
+};
+
 /**
  * @brief Service for retrieving Data via an Interest pipeline
  *
@@ -79,13 +104,174 @@ public:
   void
   cancel();
 
-protected:
+  /**
+   * @brief use @p clock for the timing of the pipeline instead of the default clock
+   *
+   * @pre the pipeline is not running
+   * @note @p clock must outlive the pipeline
+   */
+  void
+  setClock(const PipelineClock& clock)
+  {
+    m_clock = &clock;
+  }
+
+  const PipelineClock&
+  getClock() const
+  {
+    return *m_clock;
+  }
+
+  /**
+   * @return the current state of the pipeline
+   *
+   * The default implementation returns PipelineStatus().
+   */
+  virtual PipelineStatus
+  getStatus() const;
+
+  /**
+   * @brief record the Interests and Data of each segment in @p tracer, nullptr to stop tracing
+   * @note @p tracer must outlive the pipeline
+   */
+  void
+  setTracer(SegmentTracer* tracer)
+  {
+    m_tracer = tracer;
+  }
+
+  /**
+   * @brief stop requesting segments that have not been requested yet
+   *
+   * The consumer calls this method when its reorder buffer is full. The pipeline keeps fetching
+   * and retransmitting the segments it has already requested, starting with @p missingSegNo,
+   * the first segment the consumer is waiting for, until releaseBackpressure is called.
+   */
+  void
+  applyBackpressure(uint64_t missingSegNo);
+
+  /**
+   * @brief resume requesting new segments after applyBackpressure
+   */
+  void
+  releaseBackpressure();
+
+  bool
+  hasBackpressure() const
+  {
+    return m_hasBackpressure;
+  }
+
+  /**
+   * @brief fetch only the segments from @p first to @p last (inclusive)
+   *
+   * No segment after @p last is requested. If the FinalBlockId of the content, which may arrive
+   * with any segment, is smaller, the retrieval ends at the FinalBlockId instead.
+   * @pre the pipeline is not running
+   */
+  void
+  setSegmentRange(uint64_t first, uint64_t last);
+
+  /**
+   * @brief fetch only every @p stride-th segment, starting from the first segment of the range
+   *
+   * This lets several pipelines share the segments of a content, each one fetching a stripe.
+   * @pre the pipeline is not running
+   */
+  void
+  setSegmentStride(uint64_t stride);
+
+PUBLIC_WITH_TESTS_ELSE_PROTECTED:
   bool
   isStopping() const
   {
     return m_isStopping;
   }
 
+protected:
+  /**
+   * @return the current time of the clock of the pipeline
+   */
+  PipelineClock::TimePoint
+  getCurrentTime() const
+  {
+    return m_clock->now();
+  }
+
+  /**
+   * @return true if @p segNo is in the requested range of segments
+   */
+  bool
+  isInRange(uint64_t segNo) const
+  {
+    return segNo >= m_firstSegmentNo && segNo <= m_rangeLastSegmentNo &&
+           (segNo - m_firstSegmentNo) % m_segmentStride == 0;
+  }
+
+  /**
+   * @return whether the last segment to fetch is known, from the FinalBlockId of the content or
+   *         from the end of the requested range
+   */
+  bool
+  isLastSegmentKnown() const
+  {
+    return m_hasFinalBlockId || m_rangeLastSegmentNo != std::numeric_limits<uint64_t>::max();
+  }
+
+  /**
+   * @brief learn the FinalBlockId of the content from @p data, unless it is already known
+   *
+   * m_lastSegmentNo is lowered to the FinalBlockId if the end of the requested range is beyond it.
+   *
+   * @return true if the FinalBlockId has just become known
+   */
+  bool
+  receiveFinalBlockId(const Data& data);
+
+  /**
+   * @return number of segments to fetch, including the excluded segment if it is in range
+   * @pre isLastSegmentKnown() is true
+   */
+  uint64_t
+  getNSegmentsInRange() const
+  {
+    if (m_lastSegmentNo < m_firstSegmentNo)
+      return 0;
+    return (m_lastSegmentNo - m_firstSegmentNo) / m_segmentStride + 1;
+  }
+
+  /**
+   * @return the segment the consumer is waiting for, valid only if hasBackpressure() is true
+   */
+  uint64_t
+  getMissingSegmentNo() const
+  {
+    return m_missingSegmentNo;
+  }
+
+  SegmentTracer*
+  getTracer() const
+  {
+    return m_tracer;
+  }
+
+  void
+  traceSegment(uint64_t segNo, SegmentTracer::Stage stage, PipelineClock::TimePoint time)
+  {
+    if (m_tracer != nullptr)
+      m_tracer->record(segNo, stage, time);
+  }
+
+  /**
+   * @brief trace an event at the current time, the clock is read only while tracing
+   */
+  void
+  traceSegment(uint64_t segNo, SegmentTracer::Stage stage)
+  {
+    if (m_tracer != nullptr)
+      m_tracer->record(segNo, stage, getCurrentTime());
+  }
+
   void
   onData(const Interest& interest, const Data& data) const
   {
@@ -105,8 +291,10 @@ private:
    * When overriding this function, at a minimum, the subclass should implement the retrieving
    * of all the segments. Segment m_excludedSegmentNo can be skipped. Subclass must guarantee
    * that onData is called at least once for every segment that is fetched successfully.
+   * The first segment to fetch is m_firstSegmentNo, and only every m_segmentStride-th
+   * segment from it must be fetched.
    *
-   * @note m_lastSegmentNo contains a valid value only if m_hasFinalBlockId is true.
+   * @note m_lastSegmentNo contains a valid value only if isLastSegmentKnown() is true.
    */
   virtual void
   doRun() = 0;
@@ -114,19 +302,43 @@ private:
   virtual void
   doCancel() = 0;
 
+  /**
+   * @brief perform subclass-specific operations to stop requesting new segments
+   *
+   * The default implementation does nothing: subclasses are expected to check hasBackpressure()
+   * before requesting a new segment.
+   */
+  virtual void
+  doApplyBackpressure();
+
+  /**
+   * @brief perform subclass-specific operations to resume requesting new segments
+   *
+   * The default implementation does nothing.
+   */
+  virtual void
+  doReleaseBackpressure();
+
 protected:
   Face& m_face;
   Name m_prefix;
-  uint64_t m_lastSegmentNo;
+  uint64_t m_firstSegmentNo; ///< first segment to fetch, 0 unless a range is set
+  uint64_t m_lastSegmentNo; ///< last segment to fetch, valid only if isLastSegmentKnown()
   uint64_t m_excludedSegmentNo;
+  uint64_t m_segmentStride; ///< distance between the segments to fetch, 1 unless a stride is set
 
 PUBLIC_WITH_TESTS_ELSE_PROTECTED:
-  bool m_hasFinalBlockId; ///< true if the last segment number is known
+  bool m_hasFinalBlockId; ///< true if the FinalBlockId of the content is known
 
 private:
   DataCallback m_onData;
   FailureCallback m_onFailure;
+  const PipelineClock* m_clock;
+  SegmentTracer* m_tracer;
   bool m_isStopping;
+  bool m_hasBackpressure;
+  uint64_t m_missingSegmentNo;
+  uint64_t m_rangeLastSegmentNo; ///< last segment of the requested range
 };
 
 } // namespace chunks
@@ -0,0 +1,164 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "segment-tracer.hpp"
+
+#include <algorithm>
+#include <iomanip>
+
+namespace ndn {
+namespace chunks {
+
+/// time of an event that was not recorded
+static const time::nanoseconds NOT_RECORDED = time::nanoseconds::min();
+
+SegmentTracer::Lifecycle::Lifecycle()
+  : firstSent(NOT_RECORDED)
+  , received(NOT_RECORDED)
+  , validated(NOT_RECORDED)
+  , written(NOT_RECORDED)
+{
+}
+
+SegmentTracer::SegmentTracer(size_t maxEvents, const PipelineClock& clock)
+  : m_startTime(clock.now())
+  , m_nDropped(0)
+{
+  m_events.reserve(maxEvents);
+}
+
+std::map<uint64_t, SegmentTracer::Lifecycle>
+SegmentTracer::makeLifecycles() const
+{
+  std::map<uint64_t, Lifecycle> lifecycles;
+  for (const auto& event : m_events) {
+    Lifecycle& lifecycle = lifecycles[event.segNo];
+    switch (event.stage) {
+      case INTEREST_SENT:
+        if (lifecycle.firstSent == NOT_RECORDED)
+          lifecycle.firstSent = event.time;
+        break;
+      case INTEREST_RETRANSMITTED:
+        lifecycle.retransmitted.push_back(event.time);
+        break;
+      case DATA_RECEIVED:
+        lifecycle.received = event.time;
+        break;
+      case DATA_VALIDATED:
+        lifecycle.validated = event.time;
+        break;
+      case DATA_WRITTEN:
+        lifecycle.written = event.time;
+        break;
+    }
+  }
+  return lifecycles;
+}
+
+static void
+printTime(std::ostream& os, time::nanoseconds time)
+{
+  if (time == NOT_RECORDED)
+    os << '-';
+  else
+    os << time::duration_cast<time::microseconds>(time).count();
+}
+
+void
+SegmentTracer::dump(std::ostream& os) const
+{
+  os << "segment\tsent\treceived\tvalidated\twritten\tnretx\tretx\n";
+  for (const auto& entry : makeLifecycles()) {
+    const Lifecycle& lifecycle = entry.second;
+    os << entry.first << '\t';
+    printTime(os, lifecycle.firstSent);
+    os << '\t';
+    printTime(os, lifecycle.received);
+    os << '\t';
+    printTime(os, lifecycle.validated);
+    os << '\t';
+    printTime(os, lifecycle.written);
+    os << '\t' << lifecycle.retransmitted.size() << '\t';
+    if (lifecycle.retransmitted.empty())
+      os << '-';
+    for (size_t i = 0; i < lifecycle.retransmitted.size(); ++i) {
+      if (i > 0)
+        os << ',';
+      printTime(os, lifecycle.retransmitted[i]);
+    }
+    os << '\n';
+  }
+}
+
+/**
+ * @brief print the number of samples and the p50 and p99 of @p latencies, in milliseconds
+ */
+static void
+printPercentiles(std::ostream& os, const std::string& stage, std::vector<time::nanoseconds>& latencies)
+{
+  os << "  " << std::left << std::setw(16) << stage << std::right << std::setw(10) << latencies.size();
+  if (latencies.empty()) {
+    os << std::setw(12) << '-' << std::setw(12) << '-' << '\n';
+    return;
+  }
+
+  std::sort(latencies.begin(), latencies.end());
+  auto percentile = [&latencies] (double p) {
+    size_t index = static_cast<size_t>(p * (latencies.size() - 1) + 0.5);
+    return time::duration_cast<time::duration<double, time::milliseconds::period>>(latencies[index]);
+  };
+  os << std::fixed << std::setprecision(3)
+     << std::setw(12) << percentile(0.50).count()
+     << std::setw(12) << percentile(0.99).count() << '\n';
+  os.unsetf(std::ios::floatfield);
+}
+
+void
+SegmentTracer::printSummary(std::ostream& os) const
+{
+  std::vector<time::nanoseconds> network, validation, output, total;
+  for (const auto& entry : makeLifecycles()) {
+    const Lifecycle& lifecycle = entry.second;
+    if (lifecycle.firstSent != NOT_RECORDED && lifecycle.received != NOT_RECORDED)
+      network.push_back(lifecycle.received - lifecycle.firstSent);
+    if (lifecycle.received != NOT_RECORDED && lifecycle.validated != NOT_RECORDED)
+      validation.push_back(lifecycle.validated - lifecycle.received);
+    if (lifecycle.validated != NOT_RECORDED && lifecycle.written != NOT_RECORDED)
+      output.push_back(lifecycle.written - lifecycle.validated);
+    if (lifecycle.firstSent != NOT_RECORDED && lifecycle.written != NOT_RECORDED)
+      total.push_back(lifecycle.written - lifecycle.firstSent);
+  }
+
+  os << "Segment latency per stage (ms):\n"
+     << "  " << std::left << std::setw(16) << "stage" << std::right << std::setw(10) << "segments"
+     << std::setw(12) << "p50" << std::setw(12) << "p99" << '\n';
+  printPercentiles(os, "network", network);
+  printPercentiles(os, "validation", validation);
+  printPercentiles(os, "reorder+output", output);
+  printPercentiles(os, "total", total);
+  if (m_nDropped > 0)
+    os << "  " << m_nDropped << " events were not traced, the trace buffer was full\n";
+}
+
+} // namespace chunks
+} // namespace ndn
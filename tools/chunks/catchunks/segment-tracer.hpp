@@ -0,0 +1,141 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#ifndef NDN_TOOLS_CHUNKS_CATCHUNKS_SEGMENT_TRACER_HPP
+#define NDN_TOOLS_CHUNKS_CATCHUNKS_SEGMENT_TRACER_HPP
+
+#include "pipeline-clock.hpp"
+
+namespace ndn {
+namespace chunks {
+
+/**
+ * @brief Records the lifecycle of each segment of a retrieval
+ *
+ * The pipeline records when the Interest of a segment is sent and retransmitted, and when its
+ * Data arrives; the Consumer records when the Data is validated and written to the output.
+ * Events are appended to a buffer allocated upfront, so tracing does not allocate during the
+ * retrieval; the events that do not fit are counted and dropped.
+ *
+ * At the end, dump() writes one line per segment and printSummary() breaks the latency of the
+ * segments down per stage:
+ *  - network: from the first Interest to the arrival of the Data, retransmissions included;
+ *  - validation: from the arrival to the end of the validation;
+ *  - reorder+output: from the validation to the write to the output, which includes the wait
+ *    for the preceding segments.
+ *
+ * In follow mode, the Interests expressed again for segments not produced yet are not traced as
+ * retransmissions. All the events are timed with the PipelineClock of the retrieval, which is also the one the
+ * tracer is created with.
+ */
+class SegmentTracer : noncopyable
+{
+public:
+  enum Stage : uint8_t {
+    INTEREST_SENT,
+    INTEREST_RETRANSMITTED,
+    DATA_RECEIVED,
+    DATA_VALIDATED,
+    DATA_WRITTEN
+  };
+
+  /**
+   * @param maxEvents number of events that are preallocated
+   * @param clock clock of the retrieval, the event times are relative to its time at creation
+   */
+  explicit
+  SegmentTracer(size_t maxEvents, const PipelineClock& clock = PipelineClock::getDefault());
+
+  void
+  record(uint64_t segNo, Stage stage, time::steady_clock::TimePoint time)
+  {
+    if (m_events.size() == m_events.capacity()) {
+      ++m_nDropped;
+      return;
+    }
+    m_events.push_back({segNo, time - m_startTime, stage});
+  }
+
+  size_t
+  getNEvents() const
+  {
+    return m_events.size();
+  }
+
+  uint64_t
+  getNDroppedEvents() const
+  {
+    return m_nDropped;
+  }
+
+  /**
+   * @brief write one line per traced segment
+   *
+   * The columns are the segment number, the times of the first Interest, Data arrival,
+   * validation and output, and the number of retransmissions followed by their times. Times
+   * are in microseconds since the tracer was created, - if the event was not recorded.
+   */
+  void
+  dump(std::ostream& os) const;
+
+  /**
+   * @brief print the 50th and 99th percentile of the latency of each stage
+   */
+  void
+  printSummary(std::ostream& os) const;
+
+private:
+  struct Event
+  {
+    uint64_t segNo;
+    time::nanoseconds time;
+    Stage stage;
+  };
+
+  struct Lifecycle
+  {
+    Lifecycle();
+
+    time::nanoseconds firstSent;
+    time::nanoseconds received;
+    time::nanoseconds validated;
+    time::nanoseconds written;
+    std::vector<time::nanoseconds> retransmitted;
+  };
+
+  /**
+   * @brief gather the events of each segment
+   */
+  std::map<uint64_t, Lifecycle>
+  makeLifecycles() const;
+
+private:
+  const time::steady_clock::TimePoint m_startTime;
+  std::vector<Event> m_events;
+  uint64_t m_nDropped;
+};
+
+} // namespace chunks
+} // namespace ndn
+
+#endif // NDN_TOOLS_CHUNKS_CATCHUNKS_SEGMENT_TRACER_HPP
@@ -0,0 +1,129 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "streaming-quantile.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ndn {
+namespace chunks {
+
+StreamingQuantile::StreamingQuantile(double p)
+  : m_p(p)
+  , m_count(0)
+  , m_heights()
+  , m_positions{{0, 1, 2, 3, 4}}
+  , m_desired{{0, 2 * p, 4 * p, 2 + 2 * p, 4}}
+  , m_increments{{0, p / 2, p, (1 + p) / 2, 1}}
+{
+  BOOST_ASSERT(p >= 0 && p <= 1);
+}
+
+void
+StreamingQuantile::add(double x)
+{
+  if (m_count < m_heights.size()) { // collecting the initial samples
+    m_heights[m_count++] = x;
+    if (m_count == m_heights.size()) {
+      std::sort(m_heights.begin(), m_heights.end());
+    }
+    return;
+  }
+  m_count++;
+
+  // find the cell containing the sample, extending the extreme markers if needed
+  int k;
+  if (x < m_heights[0]) {
+    m_heights[0] = x;
+    k = 0;
+  }
+  else if (x >= m_heights[4]) {
+    m_heights[4] = x;
+    k = 3;
+  }
+  else {
+    k = 0;
+    while (x >= m_heights[k + 1])
+      ++k;
+  }
+
+  for (int i = k + 1; i < 5; ++i) {
+    m_positions[i]++;
+  }
+  for (int i = 0; i < 5; ++i) {
+    m_desired[i] += m_increments[i];
+  }
+
+  // adjust the middle markers if they are off their desired positions
+  for (int i = 1; i < 4; ++i) {
+    double delta = m_desired[i] - m_positions[i];
+    if ((delta >= 1 && m_positions[i + 1] - m_positions[i] > 1) ||
+        (delta <= -1 && m_positions[i - 1] - m_positions[i] < -1)) {
+      int d = delta > 0 ? 1 : -1;
+      double height = parabolic(i, d);
+      if (m_heights[i - 1] < height && height < m_heights[i + 1]) {
+        m_heights[i] = height;
+      }
+      else {
+        m_heights[i] = linear(i, d);
+      }
+      m_positions[i] += d;
+    }
+  }
+}
+
+double
+StreamingQuantile::get() const
+{
+  if (m_count == 0) {
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+
+  if (m_count < m_heights.size()) { // not enough samples for the markers, use the exact value
+    std::array<double, 5> sorted = m_heights;
+    std::sort(sorted.begin(), sorted.begin() + m_count);
+    return sorted[static_cast<size_t>(std::round(m_p * (m_count - 1)))];
+  }
+
+  return m_heights[2];
+}
+
+double
+StreamingQuantile::parabolic(int i, int d) const
+{
+  const auto& q = m_heights;
+  const auto& n = m_positions;
+  return q[i] + d / (n[i + 1] - n[i - 1]) *
+                ((n[i] - n[i - 1] + d) * (q[i + 1] - q[i]) / (n[i + 1] - n[i]) +
+                 (n[i + 1] - n[i] - d) * (q[i] - q[i - 1]) / (n[i] - n[i - 1]));
+}
+
+double
+StreamingQuantile::linear(int i, int d) const
+{
+  return m_heights[i] + d * (m_heights[i + d] - m_heights[i]) / (m_positions[i + d] - m_positions[i]);
+}
+
+} // namespace chunks
+} // namespace ndn
@@ -0,0 +1,91 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#ifndef NDN_TOOLS_CHUNKS_CATCHUNKS_STREAMING_QUANTILE_HPP
+#define NDN_TOOLS_CHUNKS_CATCHUNKS_STREAMING_QUANTILE_HPP
+
+#include "core/common.hpp"
+
+#include <array>
+
+namespace ndn {
+namespace chunks {
+
+/**
+ * @brief Streaming estimate of a quantile of a series of samples
+ *
+ * Implements the P-square algorithm (R. Jain and I. Chlamtac, "The P2 algorithm for dynamic
+ * calculation of quantiles and histograms without storing observations", CACM 1985).
+ * Five markers are adjusted with piecewise-parabolic interpolation as samples arrive, so the
+ * estimator uses constant memory and constant time per sample.
+ */
+class StreamingQuantile
+{
+public:
+  /**
+   * @param p the quantile to estimate, between 0 and 1
+   */
+  explicit
+  StreamingQuantile(double p);
+
+  /**
+   * @brief add a sample
+   */
+  void
+  add(double x);
+
+  /**
+   * @return the estimated quantile, NaN if no sample has been added yet
+   */
+  double
+  get() const;
+
+  /**
+   * @return number of samples added so far
+   */
+  uint64_t
+  size() const
+  {
+    return m_count;
+  }
+
+private:
+  double
+  parabolic(int i, int d) const;
+
+  double
+  linear(int i, int d) const;
+
+private:
+  const double m_p;
+  uint64_t m_count;
+  std::array<double, 5> m_heights; ///< marker heights
+  std::array<double, 5> m_positions; ///< actual marker positions
+  std::array<double, 5> m_desired; ///< desired marker positions
+  std::array<double, 5> m_increments; ///< increments of the desired positions
+};
+
+} // namespace chunks
+} // namespace ndn
+
+#endif // NDN_TOOLS_CHUNKS_CATCHUNKS_STREAMING_QUANTILE_HPP
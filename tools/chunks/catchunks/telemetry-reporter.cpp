@@ -0,0 +1,249 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "telemetry-reporter.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+
+#include <fcntl.h>
+#include <limits.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace ndn {
+namespace chunks {
+
+/**
+ * @brief write @p value as a JSON number, or null if it is not finite
+ */
+static void
+writeNumber(std::ostream& os, double value)
+{
+  if (std::isfinite(value))
+    os << value;
+  else
+    os << "null";
+}
+
+TelemetryReporter::TelemetryReporter(Face& face, Consumer& consumer, int fd,
+                                     time::milliseconds interval)
+  : m_scheduler(face.getIoService())
+  , m_consumer(consumer)
+  , m_fd(fd)
+  , m_interval(interval)
+  , m_isSocket(false)
+  , m_isReporting(false)
+  , m_lastWrittenBytes(0)
+  , m_nDropped(0)
+{
+  struct stat st;
+  if (::fstat(m_fd, &st) == 0)
+    m_isSocket = S_ISSOCK(st.st_mode);
+
+  m_completeConnection = consumer.afterComplete.connect(bind(&TelemetryReporter::reportCompletion,
+                                                             this));
+}
+
+void
+TelemetryReporter::start()
+{
+  m_startTime = m_lastReportTime = time::steady_clock::now();
+  m_lastWrittenBytes = m_consumer.getNWrittenBytes();
+  m_isReporting = true;
+  m_scheduler.scheduleEvent(m_interval, bind(&TelemetryReporter::report, this));
+}
+
+std::string
+TelemetryReporter::makeReport(time::steady_clock::TimePoint now)
+{
+  double elapsed = time::duration_cast<time::duration<double>>(now - m_startTime).count();
+  double interval = time::duration_cast<time::duration<double>>(now - m_lastReportTime).count();
+  uint64_t nWrittenBytes = m_consumer.getNWrittenBytes();
+  double goodput = interval > 0 ? (nWrittenBytes - m_lastWrittenBytes) * 8 / interval / 1e6 : 0;
+  m_lastReportTime = now;
+  m_lastWrittenBytes = nWrittenBytes;
+
+  const PipelineInterests* pipeline = m_consumer.getPipeline();
+  PipelineStatus status = pipeline != nullptr ? pipeline->getStatus() : PipelineStatus();
+
+  std::ostringstream os;
+  os << "{\"elapsed_s\":";
+  writeNumber(os, elapsed);
+  os << ",\"goodput_mbps\":";
+  writeNumber(os, goodput);
+  os << ",\"cwnd\":";
+  writeNumber(os, status.cwnd);
+  os << ",\"in_flight\":" << status.nInFlight
+     << ",\"srtt_ms\":";
+  writeNumber(os, status.sRtt);
+  os << ",\"rto_ms\":";
+  writeNumber(os, status.rto);
+  os << ",\"retransmissions\":" << status.nRetransmitted
+     << ",\"received_segments\":" << status.nReceived
+     << ",\"reorder_buffer_segments\":" << m_consumer.getNBufferedSegments()
+     << ",\"reorder_buffer_bytes\":" << m_consumer.getNBufferedBytes()
+     << ",\"written_bytes\":" << nWrittenBytes
+     << ",\"complete_percent\":";
+  writeNumber(os, m_consumer.getProgress() * 100);
+  os << ",\"done\":" << (m_consumer.isComplete() ? "true" : "false")
+     << "}\n";
+  return os.str();
+}
+
+void
+TelemetryReporter::report()
+{
+  bool isComplete = m_consumer.isComplete();
+  m_isReporting = writeReport(makeReport(time::steady_clock::now())) && !isComplete;
+  if (m_isReporting)
+    m_scheduler.scheduleEvent(m_interval, bind(&TelemetryReporter::report, this));
+}
+
+void
+TelemetryReporter::reportCompletion()
+{
+  if (!m_isReporting)
+    return;
+
+  // the Face must not be kept busy until the next interval
+  m_scheduler.cancelAllEvents();
+  m_isReporting = false;
+  writeReport(makeReport(time::steady_clock::now()));
+}
+
+bool
+TelemetryReporter::writeReport(const std::string& line)
+{
+  // the rest of a line that was cut short goes first, so that lines are never interleaved
+  if (!m_pending.empty()) {
+    ssize_t nWritten = writeSome(m_pending);
+    if (nWritten < 0)
+      return false;
+    m_pending.erase(0, nWritten);
+    if (!m_pending.empty()) {
+      ++m_nDropped;
+      return true;
+    }
+  }
+
+  ssize_t nWritten = writeSome(line);
+  if (nWritten < 0)
+    return false;
+  if (nWritten == 0)
+    ++m_nDropped;
+  else if (static_cast<size_t>(nWritten) < line.size())
+    m_pending = line.substr(nWritten);
+  return true;
+}
+
+ssize_t
+TelemetryReporter::writeSome(const std::string& buffer)
+{
+  ssize_t nWritten;
+  if (m_isSocket) {
+    // MSG_NOSIGNAL: a monitor that went away must not kill the retrieval with SIGPIPE
+    do {
+      nWritten = ::send(m_fd, buffer.data(), buffer.size(), MSG_NOSIGNAL | MSG_DONTWAIT);
+    } while (nWritten < 0 && errno == EINTR);
+  }
+  else {
+    // the descriptor may be shared with other processes, e.g. the standard error of a shell, so
+    // it is not switched to non-blocking mode; instead, nothing is written unless it is writable,
+    // and then at most PIPE_BUF bytes, which a writable pipe accepts without blocking
+    pollfd pfd = {m_fd, POLLOUT, 0};
+    int nReady;
+    do {
+      nReady = ::poll(&pfd, 1, 0);
+    } while (nReady < 0 && errno == EINTR);
+    if (nReady == 0)
+      return 0;
+
+    // a pipe has no MSG_NOSIGNAL: block SIGPIPE in this thread and discard the one raised by
+    // the write, without changing how the rest of the process reacts to SIGPIPE
+    sigset_t sigpipe, pending, oldMask;
+    sigemptyset(&sigpipe);
+    sigaddset(&sigpipe, SIGPIPE);
+    sigpending(&pending);
+    bool wasPending = sigismember(&pending, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &sigpipe, &oldMask);
+
+    do {
+      nWritten = ::write(m_fd, buffer.data(), std::min<size_t>(buffer.size(), PIPE_BUF));
+    } while (nWritten < 0 && errno == EINTR);
+
+    if (nWritten < 0 && errno == EPIPE && !wasPending) {
+      timespec noWait = {0, 0};
+      while (sigtimedwait(&sigpipe, nullptr, &noWait) < 0 && errno == EINTR)
+        ;
+      errno = EPIPE;
+    }
+    int savedErrno = errno;
+    pthread_sigmask(SIG_SETMASK, &oldMask, nullptr);
+    errno = savedErrno;
+  }
+
+  if (nWritten >= 0)
+    return nWritten;
+  if (errno == EAGAIN || errno == EWOULDBLOCK)
+    return 0;
+
+  std::cerr << "WARNING: telemetry stopped: " << std::strerror(errno) << std::endl;
+  return -1;
+}
+
+int
+TelemetryReporter::connectUnixSocket(const std::string& path)
+{
+  sockaddr_un addr;
+  if (path.size() >= sizeof(addr.sun_path))
+    throw Error("Unix socket path is too long: " + path);
+
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+
+  int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0)
+    throw Error("Cannot create Unix socket: " + std::string(std::strerror(errno)));
+
+  if (::connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) < 0 ||
+      ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK) < 0) {
+    std::string reason(std::strerror(errno));
+    ::close(fd);
+    throw Error("Cannot connect to " + path + ": " + reason);
+  }
+
+  return fd;
+}
+
+} // namespace chunks
+} // namespace ndn
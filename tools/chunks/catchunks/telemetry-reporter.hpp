@@ -0,0 +1,143 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#ifndef NDN_TOOLS_CHUNKS_CATCHUNKS_TELEMETRY_REPORTER_HPP
+#define NDN_TOOLS_CHUNKS_CATCHUNKS_TELEMETRY_REPORTER_HPP
+
+#include "consumer.hpp"
+
+namespace ndn {
+namespace chunks {
+
+/**
+ * @brief Periodically reports the progress of a retrieval as JSON lines
+ *
+ * Every interval, a line such as
+ *
+ *     {"elapsed_s":10.0,"goodput_mbps":81.9,"cwnd":32.5,"in_flight":31,"srtt_ms":12.1,...}
+ *
+ * is written to a file descriptor, e.g. a pipe or a Unix socket read by a monitoring agent.
+ * The goodput is computed from the bytes written to the output during the last interval.
+ * Values that are not known yet, such as the RTT of a fixed pipeline, are null.
+ *
+ * The line that announces the completion of the retrieval is written as soon as the Consumer
+ * completes, and ends the reporting, so that no report remains scheduled on the Face.
+ *
+ * A report is never waited for: it is written only if the file descriptor is writable, without
+ * changing the flags of the descriptor, which the reporter does not own. A report that cannot be
+ * written at all is dropped, and the rest of a partially written report is sent before the next
+ * one, which is dropped if that rest still does not fit. Any other write error, including a
+ * closed reader, stops reporting without raising SIGPIPE.
+ */
+class TelemetryReporter : noncopyable
+{
+public:
+  class Error : public std::runtime_error
+  {
+  public:
+    explicit
+    Error(const std::string& what)
+      : std::runtime_error(what)
+    {
+    }
+  };
+
+  /**
+   * @param fd file descriptor the reports are written to, which is neither modified nor closed
+   *           by the reporter
+   * @param interval time between two reports
+   */
+  TelemetryReporter(Face& face, Consumer& consumer, int fd, time::milliseconds interval);
+
+  /**
+   * @brief schedule the reports, the first one is written after one interval
+   */
+  void
+  start();
+
+  /**
+   * @return number of reports dropped because the file descriptor was not writable
+   */
+  uint64_t
+  getNDroppedReports() const
+  {
+    return m_nDropped;
+  }
+
+  /**
+   * @brief connect to the Unix stream socket listening at @p path
+   * @return the connected socket, in non-blocking mode
+   * @throw Error the connection failed
+   */
+  static int
+  connectUnixSocket(const std::string& path);
+
+PUBLIC_WITH_TESTS_ELSE_PRIVATE:
+  /**
+   * @return one report, terminated by a newline
+   */
+  std::string
+  makeReport(time::steady_clock::TimePoint now);
+
+  /**
+   * @return false if reporting must stop
+   */
+  bool
+  writeReport(const std::string& line);
+
+private:
+  void
+  report();
+
+  /**
+   * @brief write the last report as soon as the retrieval is complete
+   */
+  void
+  reportCompletion();
+
+  /**
+   * @return number of bytes written, 0 if the file descriptor is not writable, -1 on error
+   */
+  ssize_t
+  writeSome(const std::string& buffer);
+
+private:
+  Scheduler m_scheduler;
+  const Consumer& m_consumer;
+  const int m_fd;
+  const time::milliseconds m_interval;
+  bool m_isSocket;
+  bool m_isReporting; ///< started, and neither complete nor stopped by a write error
+  signal::ScopedConnection m_completeConnection;
+
+  time::steady_clock::TimePoint m_startTime;
+  time::steady_clock::TimePoint m_lastReportTime;
+  uint64_t m_lastWrittenBytes;
+  uint64_t m_nDropped;
+  std::string m_pending; ///< unsent rest of the last report
+};
+
+} // namespace chunks
+} // namespace ndn
+
+#endif // NDN_TOOLS_CHUNKS_CATCHUNKS_TELEMETRY_REPORTER_HPP
@@ -0,0 +1,188 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "version-cache.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ndn {
+namespace chunks {
+
+VersionCache::VersionCache(const std::string& path, time::seconds ttl)
+  : m_path(path)
+  , m_ttl(ttl)
+{
+}
+
+void
+VersionCache::load()
+{
+  m_entries.clear();
+  readFile(m_entries);
+}
+
+bool
+VersionCache::save() const
+{
+  // serializes the savers, so that none of them overwrites the entries added by another one
+  // between its read of the file and its rename
+  int lockFd = ::open((m_path + ".lock").c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  if (lockFd < 0)
+    return false;
+  while (::flock(lockFd, LOCK_EX) < 0) {
+    if (errno != EINTR) {
+      ::close(lockFd);
+      return false;
+    }
+  }
+
+  // merge with the entries saved by other processes since this cache was loaded
+  std::map<Name, Entry> entries;
+  readFile(entries);
+  for (const auto& item : m_entries) {
+    auto it = entries.find(item.first);
+    if (it == entries.end() || it->second.timestamp < item.second.timestamp)
+      entries[item.first] = item.second;
+  }
+
+  std::ostringstream os;
+  for (const auto& item : entries) {
+    if (isExpired(item.second.timestamp))
+      continue;
+
+    os << item.first.toUri() << ' '
+       << item.second.version << ' '
+       << time::toUnixTimestamp(item.second.timestamp).count() << '\n';
+  }
+
+  bool isSaved = writeFile(os.str());
+  ::close(lockFd); // releases the lock
+  return isSaved;
+}
+
+void
+VersionCache::readFile(std::map<Name, Entry>& entries) const
+{
+  std::ifstream is(m_path);
+  std::string line;
+  while (std::getline(is, line)) {
+    std::istringstream iss(line);
+    std::string uri;
+    uint64_t version;
+    uint64_t timestamp;
+    if (!(iss >> uri >> version >> timestamp))
+      continue;
+
+    Name prefix;
+    try {
+      prefix = Name(uri);
+    }
+    catch (const std::exception&) {
+      continue;
+    }
+
+    Entry entry{version, time::fromUnixTimestamp(time::milliseconds(timestamp))};
+    if (!isExpired(entry.timestamp))
+      entries[prefix] = entry;
+  }
+}
+
+bool
+VersionCache::writeFile(const std::string& content) const
+{
+  // a unique file in the same directory, so that the rename is atomic
+  std::string tmpPath = m_path + ".XXXXXX";
+  int fd = ::mkstemp(&tmpPath[0]);
+  if (fd < 0)
+    return false;
+
+  // mkstemp creates the file with mode 0600: keep the mode of the cache, or apply the umask
+  // to 0644 as open would do for a new cache
+  struct stat st;
+  mode_t mode;
+  if (::stat(m_path.c_str(), &st) == 0) {
+    mode = st.st_mode & 07777;
+  }
+  else {
+    mode_t mask = ::umask(0);
+    ::umask(mask);
+    mode = 0644 & ~mask;
+  }
+  if (::fchmod(fd, mode) < 0) {
+    ::close(fd);
+    ::unlink(tmpPath.c_str());
+    return false;
+  }
+
+  size_t nWritten = 0;
+  while (nWritten < content.size()) {
+    ssize_t n = ::write(fd, content.data() + nWritten, content.size() - nWritten);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n < 0)
+      break;
+    nWritten += n;
+  }
+
+  if (::close(fd) < 0 || nWritten < content.size() ||
+      std::rename(tmpPath.c_str(), m_path.c_str()) != 0) {
+    ::unlink(tmpPath.c_str());
+    return false;
+  }
+  return true;
+}
+
+bool
+VersionCache::find(const Name& prefix, uint64_t& version) const
+{
+  auto it = m_entries.find(prefix);
+  if (it == m_entries.end() || isExpired(it->second.timestamp))
+    return false;
+
+  version = it->second.version;
+  return true;
+}
+
+void
+VersionCache::insert(const Name& prefix, uint64_t version)
+{
+  m_entries[prefix] = Entry{version, time::system_clock::now()};
+}
+
+bool
+VersionCache::isExpired(const time::system_clock::TimePoint& timestamp) const
+{
+  return time::system_clock::now() - timestamp >= m_ttl;
+}
+
+} // namespace chunks
+} // namespace ndn
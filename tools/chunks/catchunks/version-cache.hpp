@@ -0,0 +1,118 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#ifndef NDN_TOOLS_CHUNKS_CATCHUNKS_VERSION_CACHE_HPP
+#define NDN_TOOLS_CHUNKS_CATCHUNKS_VERSION_CACHE_HPP
+
+#include "core/common.hpp"
+
+namespace ndn {
+namespace chunks {
+
+/**
+ * @brief On-disk cache of discovered Data versions
+ *
+ * Maps a prefix to the last version discovered under it. An entry is used until its TTL
+ * expires, afterwards the version has to be discovered again.
+ *
+ * The cache is stored as a text file with one entry per line:
+ * `<prefix URI> <version> <discovery time in milliseconds since the Unix epoch>`.
+ * Malformed lines are ignored.
+ */
+class VersionCache : noncopyable
+{
+public:
+  /**
+   * @brief create a cache stored at @p path, whose entries are valid for @p ttl
+   */
+  VersionCache(const std::string& path, time::seconds ttl);
+
+  /**
+   * @brief read the entries from the cache file
+   *
+   * A missing or unreadable file is treated as an empty cache.
+   */
+  void
+  load();
+
+  /**
+   * @brief write the entries that did not expire to the cache file
+   *
+   * The entries are merged with those in the file, keeping the most recent discovery of each
+   * prefix, so that the versions saved by other processes are not lost. Concurrent savers are
+   * serialized by an flock on `<path>.lock`. The file is replaced atomically, so that concurrent
+   * readers see either the old or the new content.
+   *
+   * @return false if the file could not be written
+   */
+  bool
+  save() const;
+
+  /**
+   * @brief look up the version cached for @p prefix
+   *
+   * @param[out] version the cached version, if found
+   * @return true if an entry exists and did not expire
+   */
+  bool
+  find(const Name& prefix, uint64_t& version) const;
+
+  /**
+   * @brief record @p version as the latest one discovered under @p prefix
+   */
+  void
+  insert(const Name& prefix, uint64_t version);
+
+private:
+  struct Entry
+  {
+    uint64_t version;
+    time::system_clock::TimePoint timestamp;
+  };
+
+  /**
+   * @brief add the entries of the cache file that did not expire to @p entries
+   */
+  void
+  readFile(std::map<Name, Entry>& entries) const;
+
+  /**
+   * @brief replace the cache file with @p content, through a unique temporary file
+   */
+  bool
+  writeFile(const std::string& content) const;
+
+  bool
+  isExpired(const time::system_clock::TimePoint& timestamp) const;
+
+private:
+
+  const std::string m_path;
+  const time::seconds m_ttl;
+  std::map<Name, Entry> m_entries;
+};
+
+} // namespace chunks
+} // namespace ndn
+
+#endif // NDN_TOOLS_CHUNKS_CATCHUNKS_VERSION_CACHE_HPP
@@ -0,0 +1,160 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2016,  Regents of the University of California,
+ *                      Colorado State University,
+ *                      University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#ifndef NDN_TOOLS_CHUNKS_CATCHUNKS_WINDOWED_FILTER_HPP
+#define NDN_TOOLS_CHUNKS_CATCHUNKS_WINDOWED_FILTER_HPP
+
+#include "core/common.hpp"
+
+#include <array>
+#include <functional>
+
+namespace ndn {
+namespace chunks {
+
+/**
+ * @brief Windowed minimum or maximum of a series of timestamped samples
+ *
+ * Implements the running min/max filter by Kathleen Nichols (also used by BBR in Linux): the
+ * best, second best and third best samples of successive sub-windows are retained, so the
+ * filter uses constant memory and constant time per update. The returned value is the best
+ * sample observed during approximately the last @c window time units.
+ *
+ * @tparam T type of the samples
+ * @tparam Compare binary predicate returning true if its first argument is at least as good
+ *                 as the second one, e.g. std::greater_equal<T> for a max filter
+ */
+template<typename T, typename Compare>
+class WindowedFilter
+{
+public:
+  WindowedFilter()
+    : m_isEmpty(true)
+  {
+  }
+
+  /**
+   * @brief add a sample and return the current filtered value
+   *
+   * @param now time of the sample, must not decrease between successive calls
+   * @param value the sample
+   * @param window length of the time window, in the same unit as @p now
+   */
+  T
+  update(double now, const T& value, double window)
+  {
+    Sample sample{now, value};
+
+    if (m_isEmpty || m_isBetter(value, m_samples[0].value) || now - m_samples[2].time > window) {
+      // new best sample, or nothing left in the window
+      reset(sample);
+      return value;
+    }
+
+    if (m_isBetter(value, m_samples[1].value)) {
+      m_samples[2] = m_samples[1] = sample;
+    }
+    else if (m_isBetter(value, m_samples[2].value)) {
+      m_samples[2] = sample;
+    }
+
+    double dt = now - m_samples[0].time;
+    if (dt > window) {
+      // the best sample expired, promote the second and third best ones
+      m_samples[0] = m_samples[1];
+      m_samples[1] = m_samples[2];
+      m_samples[2] = sample;
+      if (now - m_samples[0].time > window) {
+        m_samples[0] = m_samples[1];
+        m_samples[1] = m_samples[2];
+        m_samples[2] = sample;
+      }
+    }
+    else if (m_samples[1].time == m_samples[0].time && dt > window / 4) {
+      // a quarter of the window passed without a second best sample, take one
+      m_samples[2] = m_samples[1] = sample;
+    }
+    else if (m_samples[2].time == m_samples[1].time && dt > window / 2) {
+      // half of the window passed without a third best sample, take one
+      m_samples[2] = sample;
+    }
+
+    return m_samples[0].value;
+  }
+
+  bool
+  empty() const
+  {
+    return m_isEmpty;
+  }
+
+  /**
+   * @return the current filtered value
+   * @pre the filter is not empty
+   */
+  const T&
+  get() const
+  {
+    BOOST_ASSERT(!m_isEmpty);
+    return m_samples[0].value;
+  }
+
+  /**
+   * @brief forget all the samples
+   */
+  void
+  clear()
+  {
+    m_isEmpty = true;
+  }
+
+private:
+  struct Sample
+  {
+    double time;
+    T value;
+  };
+
+  void
+  reset(const Sample& sample)
+  {
+    m_samples.fill(sample);
+    m_isEmpty = false;
+  }
+
+private:
+  std::array<Sample, 3> m_samples;
+  bool m_isEmpty;
+  Compare m_isBetter;
+};
+
+template<typename T>
+using WindowedMaxFilter = WindowedFilter<T, std::greater_equal<T>>;
+
+template<typename T>
+using WindowedMinFilter = WindowedFilter<T, std::less_equal<T>>;
+
+} // namespace chunks
+} // namespace ndn
+
+#endif // NDN_TOOLS_CHUNKS_CATCHUNKS_WINDOWED_FILTER_HPP
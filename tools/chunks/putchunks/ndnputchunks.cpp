@@ -28,6 +28,9 @@
 #include "core/version.hpp"
 #include "producer.hpp"
 
+#include <sys/stat.h>
+#include <unistd.h>
+
 namespace po = boost::program_options;
 
 namespace ndn {
@@ -50,6 +53,8 @@ main(int argc, char** argv)
   size_t maxChunkSize = MAX_NDN_PACKET_SIZE >> 1;
   std::string signingStr;	
   bool isVerbose = false;
+  bool isStreaming = false;
+  size_t streamWindow = 0;
   std::string prefix;
 
   po::options_description visibleDesc("Options");
@@ -62,6 +67,10 @@ main(int argc, char** argv)
                         "maximum chunk size, in bytes")
     ("signing-info,S",  po::value<std::string>(&signingStr)->default_value(signingStr),
                         "set signing information")
+    ("stream,t",        po::bool_switch(&isStreaming),
+                        "publish the input while it is being read, for live sources")
+    ("stream-window",   po::value<size_t>(&streamWindow)->default_value(streamWindow),
+                        "with --stream, keep only the last N chunks in memory (0 keeps all of them)")
     ("verbose,v",       po::bool_switch(&isVerbose), "turn on verbose output")
     ("version,V",       "print program version and exit")
     ;
@@ -119,12 +128,27 @@ main(int argc, char** argv)
     return 2;
   }
 
+  struct stat inputStat;
+  if (isStreaming && ::fstat(STDIN_FILENO, &inputStat) == 0 && S_ISREG(inputStat.st_mode)) {
+    // a regular file cannot be read asynchronously, and is available at once anyway
+    if (isVerbose)
+      std::cerr << "The input is a regular file, streaming mode disabled" << std::endl;
+    isStreaming = false;
+  }
+
   try {
     Face face;
     KeyChain keyChain;
-    Producer producer(prefix, face, keyChain, signingInfo, time::milliseconds(freshnessPeriod),
-                      maxChunkSize, isVerbose, printVersion, std::cin);
-    producer.run();
+    unique_ptr<Producer> producer;
+    if (isStreaming)
+      producer = make_unique<Producer>(prefix, face, keyChain, signingInfo,
+                                       time::milliseconds(freshnessPeriod), maxChunkSize,
+                                       isVerbose, printVersion, STDIN_FILENO, streamWindow);
+    else
+      producer = make_unique<Producer>(prefix, face, keyChain, signingInfo,
+                                       time::milliseconds(freshnessPeriod), maxChunkSize,
+                                       isVerbose, printVersion, std::cin);
+    producer->run();
   }
   catch (const std::exception& e) {
     std::cerr << "ERROR: " << e.what() << std::endl;
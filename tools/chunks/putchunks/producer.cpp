@@ -27,9 +27,19 @@
 
 #include "producer.hpp"
 
+#include <boost/asio/read.hpp>
+
 namespace ndn {
 namespace chunks {
 
+/**
+ * @brief how far beyond the produced segments Interests are held in streaming mode
+ *
+ * A consumer does not request segments further ahead than its window, so Interests beyond this
+ * distance are dropped rather than held.
+ */
+static const uint64_t MAX_HELD_SEGMENTS_AHEAD = 4096;
+
 Producer::Producer(const Name& prefix,
                    Face& face,
                    KeyChain& keyChain,
@@ -45,6 +55,44 @@ Producer::Producer(const Name& prefix,
   , m_freshnessPeriod(freshnessPeriod)
   , m_maxSegmentSize(maxSegmentSize)
   , m_isVerbose(isVerbose)
+  , m_isStreamEnded(true)
+  , m_firstStoredSegmentNo(0)
+  , m_streamWindow(0)
+{
+  setPrefix(prefix);
+  populateStore(is);
+  publish(needToPrintVersion);
+}
+
+Producer::Producer(const Name& prefix,
+                   Face& face,
+                   KeyChain& keyChain,
+                   const security::SigningInfo& signingInfo,
+                   time::milliseconds freshnessPeriod,
+                   size_t maxSegmentSize,
+                   bool isVerbose,
+                   bool needToPrintVersion,
+                   int inputFd,
+                   size_t streamWindow)
+  : m_face(face)
+  , m_keyChain(keyChain)
+  , m_signingInfo(signingInfo)
+  , m_freshnessPeriod(freshnessPeriod)
+  , m_maxSegmentSize(maxSegmentSize)
+  , m_isVerbose(isVerbose)
+  , m_isStreamEnded(false)
+  , m_firstStoredSegmentNo(0)
+  , m_streamWindow(streamWindow)
+  , m_input(make_unique<boost::asio::posix::stream_descriptor>(m_face.getIoService(), inputFd))
+  , m_buffer(maxSegmentSize)
+{
+  setPrefix(prefix);
+  publish(needToPrintVersion);
+  readInput();
+}
+
+void
+Producer::setPrefix(const Name& prefix)
 {
   if (prefix.size() > 0 && prefix[-1].isVersion()) {
     m_prefix = prefix.getPrefix(-1);
@@ -54,9 +102,11 @@ Producer::Producer(const Name& prefix,
     m_prefix = prefix;
     m_versionedPrefix = Name(m_prefix).appendVersion();
   }
+}
 
-  populateStore(is);
-
+void
+Producer::publish(bool needToPrintVersion)
+{
   if (needToPrintVersion)
     std::cout << m_versionedPrefix[-1] << std::endl;
 
@@ -78,27 +128,33 @@ Producer::run()
 void
 Producer::onInterest(const Interest& interest)
 {
-  BOOST_ASSERT(m_store.size() > 0);
+  BOOST_ASSERT(m_store.size() > 0 || !m_isStreamEnded);
 
   if (m_isVerbose)
     std::cerr << "Interest: " << interest << std::endl;
 
   const Name& name = interest.getName();
   shared_ptr<Data> data;
+  uint64_t segmentNo = 0;
+  uint64_t nextSegmentNo = m_firstStoredSegmentNo + m_store.size();
 
   // is this a discovery Interest or a sequence retrieval?
   if (name.size() == m_versionedPrefix.size() + 1 && m_versionedPrefix.isPrefixOf(name) &&
       name[-1].isSegment()) {
-    const auto segmentNo = static_cast<size_t>(interest.getName()[-1].toSegment());
-    // specific segment retrieval
-    if (segmentNo < m_store.size()) {
-      data = m_store[segmentNo];
+    segmentNo = interest.getName()[-1].toSegment();
+    // specific segment retrieval, the segments evicted from the stream window are not answered
+    if (segmentNo >= m_firstStoredSegmentNo && segmentNo < nextSegmentNo) {
+      data = m_store[segmentNo - m_firstStoredSegmentNo];
     }
   }
-  else if (interest.matchesData(*m_store[0])) {
-    // Interest has version and is looking for the first segment or has no version
-    data = m_store[0];
+  else if (!m_store.empty()) {
+    if (interest.matchesData(*m_store[0])) {
+      // Interest has version and is looking for the first segment or has no version;
+      // with a stream window, this is the oldest segment still stored
+      data = m_store[0];
+    }
   }
+  // else: discovery Interest received before the first segment is produced
 
   if (data != nullptr) {
     if (m_isVerbose)
@@ -106,6 +162,28 @@ Producer::onInterest(const Interest& interest)
 
     m_face.put(*data);
   }
+  else if (!m_isStreamEnded && segmentNo >= nextSegmentNo &&
+           segmentNo - nextSegmentNo < MAX_HELD_SEGMENTS_AHEAD) {
+    holdInterest(interest, segmentNo);
+  }
+}
+
+void
+Producer::holdInterest(const Interest& interest, uint64_t segmentNo)
+{
+  auto now = time::steady_clock::now();
+
+  // drop the expired Interests for the same segment, i.e. the earlier retransmissions
+  auto range = m_pendingInterests.equal_range(segmentNo);
+  for (auto it = range.first; it != range.second;) {
+    if (it->second.expiry <= now)
+      it = m_pendingInterests.erase(it);
+    else
+      ++it;
+  }
+
+  m_pendingInterests.emplace(segmentNo, PendingInterest{interest,
+                                                        now + interest.getInterestLifetime()});
 }
 
 void
@@ -118,6 +196,7 @@ Producer::populateStore(std::istream& is)
     std::cerr << "Loading input ..." << std::endl;
 
   std::vector<uint8_t> buffer(m_maxSegmentSize);
+  util::Sha256 digest;
   
   while (is.good()) {
     is.read(reinterpret_cast<char*>(buffer.data()), buffer.size());
@@ -126,6 +205,7 @@ Producer::populateStore(std::istream& is)
       auto data = make_shared<Data>(Name(m_versionedPrefix).appendSegment(m_store.size()));
       data->setFreshnessPeriod(m_freshnessPeriod);
       data->setContent(&buffer[0], nCharsRead);
+      digest.update(&buffer[0], nCharsRead);
 
       m_store.push_back(data);
     }
@@ -145,6 +225,7 @@ Producer::populateStore(std::istream& is)
 
 //  if (m_isVerbose)
     std::cerr << "Created " << m_store.size() << " chunks for prefix " << m_prefix << std::endl;
+    std::cerr << "SHA-256: " << digest.toString() << std::endl;
 
     
     time::steady_clock::time_point end = time::steady_clock::now();
@@ -154,6 +235,83 @@ Producer::populateStore(std::istream& is)
     
 }
 
+void
+Producer::readInput()
+{
+  boost::asio::async_read(*m_input, boost::asio::buffer(m_buffer),
+                          bind(&Producer::onInputRead, this, _1, _2));
+}
+
+void
+Producer::onInputRead(const boost::system::error_code& error, size_t nBytesRead)
+{
+  if (error == boost::asio::error::operation_aborted)
+    return;
+
+  if (error && error != boost::asio::error::eof) {
+    // publishing what was read as the last segment would make a truncated content look complete
+    m_pendingInterests.clear();
+    m_input->close();
+    throw Error("Failed to read the input (" + error.message() + ")");
+  }
+
+  // the read completes without error only when a whole segment has been filled,
+  // so the segment carrying the remaining bytes (maybe none) is the last one
+  appendSegment(m_buffer.data(), nBytesRead, static_cast<bool>(error));
+
+  if (!error)
+    readInput();
+}
+
+void
+Producer::appendSegment(const uint8_t* buffer, size_t size, bool isFinal)
+{
+  BOOST_ASSERT(!m_isStreamEnded);
+
+  uint64_t segmentNo = m_firstStoredSegmentNo + m_store.size();
+  auto data = make_shared<Data>(Name(m_versionedPrefix).appendSegment(segmentNo));
+  data->setFreshnessPeriod(m_freshnessPeriod);
+  data->setContent(buffer, size);
+  if (isFinal)
+    data->setFinalBlockId(name::Component::fromSegment(segmentNo));
+  m_keyChain.sign(*data, m_signingInfo);
+  m_digest.update(buffer, size);
+  m_store.push_back(data);
+  if (m_streamWindow > 0 && m_store.size() > m_streamWindow) {
+    m_store.pop_front();
+    ++m_firstStoredSegmentNo;
+  }
+
+  auto now = time::steady_clock::now();
+  auto range = m_pendingInterests.equal_range(segmentNo);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->second.expiry > now && it->second.interest.matchesData(*data)) {
+      if (m_isVerbose)
+        std::cerr << "Data: " << *data << std::endl;
+
+      m_face.put(*data);
+    }
+  }
+  m_pendingInterests.erase(range.first, range.second);
+
+  // drop the expired Interests for the later segments, which a consumer may never retransmit
+  for (auto it = m_pendingInterests.begin(); it != m_pendingInterests.end();) {
+    if (it->second.expiry <= now)
+      it = m_pendingInterests.erase(it);
+    else
+      ++it;
+  }
+
+  if (isFinal) {
+    // the Interests beyond the end of the stream are never satisfied
+    m_pendingInterests.clear();
+    m_isStreamEnded = true;
+
+    std::cerr << "Created " << segmentNo + 1 << " chunks for prefix " << m_prefix << std::endl;
+    std::cerr << "SHA-256: " << m_digest.toString() << std::endl;
+  }
+}
+
 void
 Producer::onRegisterFailed(const Name& prefix, const std::string& reason)
 {
@@ -30,6 +30,13 @@
 
 #include "core/common.hpp"
 
+#include <ndn-cxx/util/sha256.hpp>
+
+#include <boost/asio/posix/stream_descriptor.hpp>
+
+#include <deque>
+#include <map>
+
 namespace ndn {
 namespace chunks {
 
@@ -39,9 +46,29 @@ namespace chunks {
  * Packetizes and publishes data from an input stream under /prefix/<version>/<segment number>.
  * The current time is used as the version number. The store has always at least one element (also
  * with empty input stream).
+ *
+ * In streaming mode, the input is published while it is being read: each segment is signed and
+ * served as soon as its block of input is available, and the Interests for segments that do not
+ * exist yet are held until they are produced or expire, as long as they are not too far ahead of
+ * the input. The expired Interests are dropped whenever a segment is produced. The FinalBlockId
+ * is set only on the last segment, which is empty if the input ended on a segment boundary. An
+ * error reading the input stops the Producer before any segment carries a FinalBlockId. Unless a
+ * stream window is given, every segment is kept in memory; with a window of N segments, only the
+ * last N are kept and the Interests for the older ones are not answered.
  */
 class Producer : noncopyable
 {
+public:
+  class Error : public std::runtime_error
+  {
+  public:
+    explicit
+    Error(const std::string& what)
+      : std::runtime_error(what)
+    {
+    }
+  };
+
 public:
   /**
    * @brief Create the Producer
@@ -54,22 +81,50 @@ public:
            size_t maxSegmentSize, bool isVerbose = false, bool needToPrintVersion = false,
            std::istream& is = std::cin);
 
+  /**
+   * @brief Create the Producer in streaming mode
+   *
+   * @param inputFd descriptor of a pipe, socket or terminal to read the content from, the
+   *                Producer takes ownership of it
+   * @param streamWindow number of the most recent segments kept in memory, 0 to keep all of them
+   */
+  Producer(const Name& prefix, Face& face, KeyChain& keyChain,
+           const security::SigningInfo& signingInfo, time::milliseconds freshnessPeriod,
+           size_t maxSegmentSize, bool isVerbose, bool needToPrintVersion, int inputFd,
+           size_t streamWindow = 0);
+
   /**
    * @brief Run the Producer
+   * @throw Error in streaming mode, the input could not be read
    */
   void
   run();
 
 private:
+  void
+  setPrefix(const Name& prefix);
+
+  /**
+   * @brief Register the prefix to start serving the store
+   */
+  void
+  publish(bool needToPrintVersion);
+
   void
   onInterest(const Interest& interest);
 
+  /**
+   * @brief Keep @p interest until segment @p segmentNo is produced or the Interest expires
+   */
+  void
+  holdInterest(const Interest& interest, uint64_t segmentNo);
+
   /**
    * @brief Split the input stream in data packets and save them to the store
    *
    * Create data packets reading all the characters from the input stream until EOF, or an
    * error occurs. Each data packet has a maximum payload size of m_maxSegmentSize value and is
-   * stored inside the vector m_store. An empty data packet is created and stored if the input
+   * stored inside m_store. An empty data packet is created and stored if the input
    * stream is empty.
    *
    * @return Number of data packets contained in the store after the operation
@@ -77,11 +132,36 @@ private:
   void
   populateStore(std::istream& is);
 
+  void
+  readInput();
+
+  void
+  onInputRead(const boost::system::error_code& error, size_t nBytesRead);
+
+  /**
+   * @brief Sign and store the next segment, then answer the Interests held for it
+   *
+   * The oldest segment is evicted from the store if the stream window is exceeded.
+   *
+   * @param isFinal whether the segment is the last one of the stream
+   */
+  void
+  appendSegment(const uint8_t* buffer, size_t size, bool isFinal);
+
   void
   onRegisterFailed(const Name& prefix, const std::string& reason);
 
 PUBLIC_WITH_TESTS_ELSE_PRIVATE:
-  std::vector<shared_ptr<Data>> m_store;
+  std::deque<shared_ptr<Data>> m_store;
+  uint64_t m_firstStoredSegmentNo; ///< segment number of the front of m_store
+
+  // streaming mode
+  struct PendingInterest
+  {
+    Interest interest;
+    time::steady_clock::TimePoint expiry;
+  };
+  std::multimap<uint64_t, PendingInterest> m_pendingInterests;
 
 private:
   Name m_prefix;
@@ -92,6 +172,13 @@ private:
   time::milliseconds m_freshnessPeriod;
   size_t m_maxSegmentSize;
   bool m_isVerbose;
+  bool m_isStreamEnded;
+
+  // streaming mode
+  size_t m_streamWindow;
+  unique_ptr<boost::asio::posix::stream_descriptor> m_input;
+  std::vector<uint8_t> m_buffer;
+  util::Sha256 m_digest;
 };
 
 } // namespace chunks